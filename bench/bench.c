@@ -0,0 +1,73 @@
+#include "faux/faux.h"
+
+const unsigned char testc_version_major = 1;
+const unsigned char testc_version_minor = 0;
+
+const char *testc_bench[][2] = {
+
+	// list
+	{"bench_faux_list_add_1k", "Sorted insert and delete, 1k items"},
+	{"bench_faux_list_add_10k", "Sorted insert and delete, 10k items"},
+	{"bench_faux_list_add_100k", "Sorted insert and delete, 100k items"},
+	{"bench_faux_list_add_1m", "Sorted insert and delete, 1M items"},
+	{"bench_faux_list_kfind_1k", "Search by key, 1k items"},
+	{"bench_faux_list_kfind_10k", "Search by key, 10k items"},
+	{"bench_faux_list_kfind_100k", "Search by key, 100k items"},
+	{"bench_faux_list_kfind_1m", "Search by key, 1M items"},
+
+	// vec
+	{"bench_faux_vec_add_del_tail_1k", "Add and delete last item, 1k items"},
+	{"bench_faux_vec_add_del_head_1k", "Add and delete first item, 1k items"},
+	{"bench_faux_vec_add_del_head_100k", "Add and delete first item, 100k items"},
+
+	// buf
+	{"bench_faux_buf_write_read", "Write and read 1KB chunk"},
+	{"bench_faux_buf_ring_spsc", "SPSC ring write and read 64 bytes"},
+	{"bench_faux_buf_dwrite_dread", "Direct write and read 1KB by iovec"},
+	{"bench_faux_buf_dwrite_dread_easy", "Direct write and read 1KB by continuous blocks"},
+
+	// msg
+	{"bench_faux_msg_serialize_1x16", "Serialize 1 param x 16 bytes"},
+	{"bench_faux_msg_serialize_16x64", "Serialize 16 params x 64 bytes"},
+	{"bench_faux_msg_serialize_256x64", "Serialize 256 params x 64 bytes"},
+	{"bench_faux_msg_serialize_16x4k", "Serialize 16 params x 4KB"},
+	{"bench_faux_msg_deserialize_1x16", "Deserialize 1 param x 16 bytes"},
+	{"bench_faux_msg_deserialize_16x64", "Deserialize 16 params x 64 bytes"},
+	{"bench_faux_msg_deserialize_256x64", "Deserialize 256 params x 64 bytes"},
+	{"bench_faux_msg_deserialize_16x4k", "Deserialize 16 params x 4KB"},
+	{"bench_faux_msg_iov_1x16", "Build iovec 1 param x 16 bytes"},
+	{"bench_faux_msg_iov_16x64", "Build iovec 16 params x 64 bytes"},
+	{"bench_faux_msg_iov_256x64", "Build iovec 256 params x 64 bytes"},
+
+	// sched
+	{"bench_faux_sched_once_pop", "Schedule and pop event with 1000 pending"},
+	{"bench_faux_sched_once_pop_100k", "Schedule and pop event with 100k pending"},
+	{"bench_faux_sched_add_del_100k", "Schedule and delete event with 100k pending"},
+
+	// eloop
+	{"bench_faux_eloop_ring_16", "Pass token through 16 socketpairs"},
+	{"bench_faux_eloop_ring_1k", "Pass token through 1000 socketpairs"},
+
+	// ini
+	{"bench_faux_ini_parse_str", "Parse INI string of 10k lines"},
+	{"bench_faux_ini_parse_file", "Parse INI file of 10k lines"},
+
+	// str
+	{"bench_faux_str_casecmp", "Case-insensitive comparison of 64 bytes"},
+	{"bench_faux_str_casestr", "Case-insensitive search and comparison of 4KB"},
+	{"bench_faux_str_tolower", "Lower case copy of 1KB"},
+	{"bench_faux_str_dup", "Duplicate 32 bytes string"},
+	{"bench_faux_str_nextword", "Split command line to words"},
+	{"bench_faux_strbuf_append", "Build string of 16 pieces"},
+
+	// conv
+	{"bench_faux_conv_atoul", "Parse decimal number"},
+	{"bench_faux_conv_atoull_rnd", "Parse random numbers of different lengths"},
+	{"bench_strtoull_rnd", "Parse random numbers by strtoull() (baseline)"},
+	{"bench_faux_conv_atol_hex", "Parse negative hex number"},
+	{"bench_faux_conv_ultoa", "Format 64-bit number"},
+	{"bench_faux_conv_timespec", "Format timespec"},
+
+	// End of list
+	{NULL, NULL}
+	};
@@ -0,0 +1,36 @@
+/** @file bench.h
+ * @brief Common helpers for faux benchmarks.
+ */
+
+#ifndef _faux_bench_h
+#define _faux_bench_h
+
+#include <stdint.h>
+
+#include "faux/faux.h"
+#include "faux/testc_helpers.h"
+
+// Fixed seed makes workloads the same from run to run
+#define BENCH_SEED 0x2545f491
+
+/** @brief Pseudo random generator (xorshift32)
+ *
+ * The generator is deterministic and cheap so it doesn't distort the
+ * measurement.
+ *
+ * @param [in,out] state Generator state. Must be non-zero.
+ * @return Pseudo random number.
+ */
+static inline uint32_t bench_rnd(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x;
+}
+
+#endif				/* _faux_bench_h */
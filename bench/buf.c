@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "faux/faux.h"
+#include "faux/buf.h"
+#include "bench/bench.h"
+
+
+int bench_faux_buf_write_read(faux_testc_bench_t *bench)
+{
+	faux_buf_t *buf = NULL;
+	char data[1024] = {};
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, sizeof(data));
+	buf = faux_buf_new(4096);
+	if (!buf)
+		return -1;
+	for (i = 0; i < bench->iters; i++) {
+		if (faux_buf_write(buf, data, sizeof(data)) != sizeof(data))
+			break;
+		if (faux_buf_read(buf, data, sizeof(data)) != sizeof(data))
+			break;
+	}
+	faux_buf_free(buf);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_buf_ring_spsc(faux_testc_bench_t *bench)
+{
+	faux_buf_t *buf = NULL;
+	char data[64] = {};
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, sizeof(data));
+	buf = faux_buf_new_concurrent(65536, FAUX_BUF_SPSC);
+	if (!buf)
+		return -1;
+	for (i = 0; i < bench->iters; i++) {
+		if (faux_buf_write(buf, data, sizeof(data)) != sizeof(data))
+			break;
+		if (faux_buf_read(buf, data, sizeof(data)) != sizeof(data))
+			break;
+	}
+	faux_buf_free(buf);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+/** @brief Copies data to or from iovec array
+ */
+static void bench_buf_iov_copy(struct iovec *iov, size_t iov_num,
+	char *data, bool_t to_iov)
+{
+	size_t i = 0;
+
+	for (i = 0; i < iov_num; i++) {
+		if (to_iov)
+			memcpy(iov[i].iov_base, data, iov[i].iov_len);
+		else
+			memcpy(data, iov[i].iov_base, iov[i].iov_len);
+		data += iov[i].iov_len;
+	}
+}
+
+
+int bench_faux_buf_dwrite_dread(faux_testc_bench_t *bench)
+{
+	faux_buf_t *buf = NULL;
+	char data[1024] = {};
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, sizeof(data));
+	buf = faux_buf_new(4096);
+	if (!buf)
+		return -1;
+	for (i = 0; i < bench->iters; i++) {
+		struct iovec *iov = NULL;
+		size_t iov_num = 0;
+		if (faux_buf_dwrite_lock(buf, sizeof(data), &iov, &iov_num) !=
+			sizeof(data))
+			break;
+		bench_buf_iov_copy(iov, iov_num, data, BOOL_TRUE);
+		if (faux_buf_dwrite_unlock(buf, sizeof(data), iov) !=
+			sizeof(data))
+			break;
+		if (faux_buf_dread_lock(buf, sizeof(data), &iov, &iov_num) !=
+			sizeof(data))
+			break;
+		bench_buf_iov_copy(iov, iov_num, data, BOOL_FALSE);
+		if (faux_buf_dread_unlock(buf, sizeof(data), iov) !=
+			sizeof(data))
+			break;
+	}
+	faux_buf_free(buf);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_buf_dwrite_dread_easy(faux_testc_bench_t *bench)
+{
+	faux_buf_t *buf = NULL;
+	char data[1024] = {};
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, sizeof(data));
+	buf = faux_buf_new(4096);
+	if (!buf)
+		return -1;
+	for (i = 0; i < bench->iters; i++) {
+		void *ptr = NULL;
+		ssize_t len = 0;
+		size_t done = 0;
+		// The easy lock gives continuous space up to chunk end so
+		// data can be splitted
+		while (done < sizeof(data)) {
+			len = faux_buf_dwrite_lock_easy(buf, &ptr);
+			if (len <= 0)
+				break;
+			if ((size_t)len > sizeof(data) - done)
+				len = sizeof(data) - done;
+			memcpy(ptr, data + done, len);
+			faux_buf_dwrite_unlock_easy(buf, len);
+			done += len;
+		}
+		while (done > 0) {
+			len = faux_buf_dread_lock_easy(buf, &ptr);
+			if (len <= 0)
+				break;
+			memcpy(data, ptr, len);
+			faux_buf_dread_unlock_easy(buf, len);
+			done -= len;
+		}
+		if (done != 0)
+			break;
+	}
+	faux_buf_free(buf);
+
+	return (i == bench->iters) ? 0 : -1;
+}
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "faux/faux.h"
+#include "faux/eloop.h"
+#include "bench/bench.h"
+
+// Token ring through socketpairs
+typedef struct {
+	int *next_fd; // Write end of next pair indexed by read fd
+	uint64_t hops;
+	uint64_t iters;
+	bool_t error;
+} bench_ring_t;
+
+
+/** @brief Passes token to the next socketpair
+ */
+static bool_t bench_eloop_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	bench_ring_t *ring = (bench_ring_t *)user_data;
+	char token = 0;
+
+	if (read(info->fd, &token, 1) != 1) {
+		ring->error = BOOL_TRUE;
+		return BOOL_FALSE;
+	}
+	ring->hops++;
+	if (ring->hops >= ring->iters)
+		return BOOL_FALSE;
+	if (write(ring->next_fd[info->fd], &token, 1) != 1) {
+		ring->error = BOOL_TRUE;
+		return BOOL_FALSE;
+	}
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Passes single token through the ring of "num" socketpairs
+ *
+ * All socketpairs are registered within event loop. So the single ready
+ * descriptor must be found among many idle ones on each iteration.
+ */
+static int bench_eloop_ring(faux_testc_bench_t *bench, unsigned int num)
+{
+	faux_eloop_t *eloop = NULL;
+	bench_ring_t ring = {};
+	int (*pairs)[2] = NULL;
+	struct rlimit rl = {};
+	unsigned int created = 0;
+	unsigned int i = 0;
+	int max_fd = 0;
+	char token = 't';
+	int retval = -1;
+
+	faux_testc_bench_stop(bench);
+	if (0 == bench->iters)
+		return 0;
+
+	// Two descriptors per pair
+	if ((getrlimit(RLIMIT_NOFILE, &rl) == 0) &&
+		(rl.rlim_cur < rl.rlim_max) && (rl.rlim_cur < 2 * num + 64)) {
+		rl.rlim_cur = rl.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &rl);
+	}
+
+	pairs = faux_zmalloc(num * sizeof(*pairs));
+	if (!pairs)
+		return -1;
+	for (created = 0; created < num; created++) {
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, pairs[created]) < 0) {
+			fprintf(stderr, "Can't create socketpair: %s\n",
+				strerror(errno));
+			goto err;
+		}
+		if (pairs[created][0] > max_fd)
+			max_fd = pairs[created][0];
+	}
+
+	// Read end of pair i passes token to write end of pair i + 1
+	ring.next_fd = faux_zmalloc((max_fd + 1) * sizeof(*ring.next_fd));
+	if (!ring.next_fd)
+		goto err;
+	for (i = 0; i < num; i++)
+		ring.next_fd[pairs[i][0]] = pairs[(i + 1) % num][1];
+	ring.iters = bench->iters;
+
+	eloop = faux_eloop_new(NULL);
+	if (!eloop)
+		goto err;
+	for (i = 0; i < num; i++) {
+		if (!faux_eloop_add_fd(eloop, pairs[i][0], POLLIN,
+			bench_eloop_cb, &ring))
+			goto err;
+	}
+
+	faux_testc_bench_start(bench);
+	if (write(pairs[0][1], &token, 1) != 1)
+		goto err;
+	faux_eloop_loop(eloop);
+	faux_testc_bench_stop(bench);
+
+	if (!ring.error && (ring.hops == bench->iters))
+		retval = 0;
+err:
+	faux_testc_bench_stop(bench);
+	faux_eloop_free(eloop);
+	faux_free(ring.next_fd);
+	for (i = 0; i < created; i++) {
+		close(pairs[i][0]);
+		close(pairs[i][1]);
+	}
+	faux_free(pairs);
+
+	return retval;
+}
+
+
+int bench_faux_eloop_ring_16(faux_testc_bench_t *bench)
+{
+	return bench_eloop_ring(bench, 16);
+}
+
+
+int bench_faux_eloop_ring_1k(faux_testc_bench_t *bench)
+{
+	return bench_eloop_ring(bench, 1000);
+}
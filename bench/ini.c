@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "faux/faux.h"
+#include "faux/str.h"
+#include "faux/ini.h"
+#include "faux/testc_helpers.h"
+#include "bench/bench.h"
+
+#define BENCH_INI_LINES 10000
+
+
+/** @brief Generates INI text with "lines" entries
+ *
+ * There are plain, quoted and commented lines.
+ */
+static char *bench_ini_gen(unsigned int lines)
+{
+	faux_strbuf_t *sb = NULL;
+	unsigned int i = 0;
+
+	sb = faux_strbuf_new(lines * 48);
+	if (!sb)
+		return NULL;
+	for (i = 0; i < lines; i++) {
+		char line[128];
+		switch (i % 4) {
+		case 0:
+			snprintf(line, sizeof(line), "# Comment %u\n", i);
+			break;
+		case 1:
+			snprintf(line, sizeof(line),
+				"section%u.key%u=value%u\n", i % 16, i, i);
+			break;
+		case 2:
+			snprintf(line, sizeof(line),
+				"  key%u = \"quoted value %u\"  \n", i, i);
+			break;
+		default:
+			snprintf(line, sizeof(line),
+				"key%u=\"escaped \\\"value\\\" %u\"\n", i, i);
+			break;
+		}
+		faux_strbuf_append(sb, line);
+	}
+
+	return faux_strbuf_detach(sb);
+}
+
+
+int bench_faux_ini_parse_str(faux_testc_bench_t *bench)
+{
+	char *text = NULL;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	text = bench_ini_gen(BENCH_INI_LINES);
+	if (!text)
+		return -1;
+	faux_testc_bench_set_bytes(bench, strlen(text));
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		faux_ini_t *ini = faux_ini_new();
+		bool_t r = faux_ini_parse_str(ini, text);
+		faux_ini_free(ini);
+		if (!r)
+			break;
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_str_free(text);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_ini_parse_file(faux_testc_bench_t *bench)
+{
+	const char *basedir = getenv(FAUX_TESTC_TMPDIR_ENV);
+	char *fn = NULL;
+	char *text = NULL;
+	uint64_t i = 0;
+	int retval = -1;
+
+	faux_testc_bench_stop(bench);
+	text = bench_ini_gen(BENCH_INI_LINES);
+	if (!text)
+		return -1;
+	fn = faux_str_sprintf("%s/bench.ini", basedir ? basedir : "/tmp");
+	if (faux_testc_file_deploy_str(fn, text) < 0)
+		goto err;
+	faux_testc_bench_set_bytes(bench, strlen(text));
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		faux_ini_t *ini = faux_ini_new();
+		bool_t r = faux_ini_parse_file(ini, fn);
+		faux_ini_free(ini);
+		if (!r)
+			break;
+	}
+
+	faux_testc_bench_stop(bench);
+	if (i == bench->iters)
+		retval = 0;
+err:
+	unlink(fn);
+	faux_str_free(fn);
+	faux_str_free(text);
+
+	return retval;
+}
@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "faux/faux.h"
+#include "faux/list.h"
+#include "bench/bench.h"
+
+
+static int bench_list_cmp(const void *new_item, const void *list_item)
+{
+	uint32_t f = *(const uint32_t *)new_item;
+	uint32_t s = *(const uint32_t *)list_item;
+
+	return (f > s) - (f < s);
+}
+
+
+/** @brief Creates sorted list of "num" even keys
+ *
+ * Keys are added in ascending order so filling is linear.
+ */
+static faux_list_t *bench_list_fill(uint32_t *keys, size_t num)
+{
+	faux_list_t *list = NULL;
+	size_t i = 0;
+
+	list = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_NONUNIQUE,
+		bench_list_cmp, bench_list_cmp, NULL);
+	if (!list)
+		return NULL;
+	for (i = 0; i < num; i++) {
+		keys[i] = 2 * i;
+		if (!faux_list_add(list, &keys[i])) {
+			faux_list_free(list);
+			return NULL;
+		}
+	}
+
+	return list;
+}
+
+
+/** @brief Inserts odd key into random position and removes it
+ */
+static int bench_list_add(faux_testc_bench_t *bench, size_t num)
+{
+	faux_list_t *list = NULL;
+	uint32_t *keys = NULL;
+	uint32_t rnd = BENCH_SEED;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	keys = faux_zmalloc(num * sizeof(*keys));
+	if (!keys)
+		return -1;
+	list = bench_list_fill(keys, num);
+	if (!list) {
+		faux_free(keys);
+		return -1;
+	}
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		uint32_t key = 2 * (bench_rnd(&rnd) % num) + 1;
+		faux_list_node_t *node = faux_list_add(list, &key);
+		if (!node)
+			break;
+		faux_list_del(list, node);
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_list_free(list);
+	faux_free(keys);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+/** @brief Searches for random existing key
+ */
+static int bench_list_kfind(faux_testc_bench_t *bench, size_t num)
+{
+	faux_list_t *list = NULL;
+	uint32_t *keys = NULL;
+	uint32_t rnd = BENCH_SEED;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	keys = faux_zmalloc(num * sizeof(*keys));
+	if (!keys)
+		return -1;
+	list = bench_list_fill(keys, num);
+	if (!list) {
+		faux_free(keys);
+		return -1;
+	}
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		uint32_t key = 2 * (bench_rnd(&rnd) % num);
+		if (!faux_list_kfind(list, &key))
+			break;
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_list_free(list);
+	faux_free(keys);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_list_add_1k(faux_testc_bench_t *bench)
+{
+	return bench_list_add(bench, 1000);
+}
+
+
+int bench_faux_list_add_10k(faux_testc_bench_t *bench)
+{
+	return bench_list_add(bench, 10000);
+}
+
+
+int bench_faux_list_add_100k(faux_testc_bench_t *bench)
+{
+	return bench_list_add(bench, 100000);
+}
+
+
+int bench_faux_list_add_1m(faux_testc_bench_t *bench)
+{
+	return bench_list_add(bench, 1000000);
+}
+
+
+int bench_faux_list_kfind_1k(faux_testc_bench_t *bench)
+{
+	return bench_list_kfind(bench, 1000);
+}
+
+
+int bench_faux_list_kfind_10k(faux_testc_bench_t *bench)
+{
+	return bench_list_kfind(bench, 10000);
+}
+
+
+int bench_faux_list_kfind_100k(faux_testc_bench_t *bench)
+{
+	return bench_list_kfind(bench, 100000);
+}
+
+
+int bench_faux_list_kfind_1m(faux_testc_bench_t *bench)
+{
+	return bench_list_kfind(bench, 1000000);
+}
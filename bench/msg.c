@@ -0,0 +1,163 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "faux/faux.h"
+#include "faux/msg.h"
+#include "bench/bench.h"
+
+#define BENCH_MSG_MAGIC 0xdeadbeaf
+#define BENCH_MSG_MAJOR 1
+#define BENCH_MSG_MINOR 0
+
+typedef enum {
+	BENCH_MSG_SERIALIZE,
+	BENCH_MSG_DESERIALIZE,
+	BENCH_MSG_IOV
+} bench_msg_op_e;
+
+
+/** @brief Creates message with "param_num" parameters "param_len" bytes each
+ */
+static faux_msg_t *bench_msg_new(unsigned int param_num, size_t param_len)
+{
+	faux_msg_t *msg = NULL;
+	char *data = NULL;
+	unsigned int i = 0;
+
+	msg = faux_msg_new(BENCH_MSG_MAGIC, BENCH_MSG_MAJOR, BENCH_MSG_MINOR);
+	if (!msg)
+		return NULL;
+	faux_msg_set_cmd(msg, 1);
+	data = faux_malloc(param_len);
+	if (!data) {
+		faux_msg_free(msg);
+		return NULL;
+	}
+	memset(data, 'x', param_len);
+	for (i = 0; i < param_num; i++) {
+		if (faux_msg_add_param(msg, i, data, param_len) < 0) {
+			faux_free(data);
+			faux_msg_free(msg);
+			return NULL;
+		}
+	}
+	faux_free(data);
+
+	return msg;
+}
+
+
+static int bench_msg(faux_testc_bench_t *bench, bench_msg_op_e op,
+	unsigned int param_num, size_t param_len)
+{
+	faux_msg_t *msg = NULL;
+	char *raw = NULL;
+	size_t raw_len = 0;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	msg = bench_msg_new(param_num, param_len);
+	if (!msg)
+		return -1;
+	if (!faux_msg_serialize(msg, &raw, &raw_len)) {
+		faux_msg_free(msg);
+		return -1;
+	}
+	faux_testc_bench_set_bytes(bench, raw_len);
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		if (BENCH_MSG_SERIALIZE == op) {
+			char *buf = NULL;
+			size_t len = 0;
+			if (!faux_msg_serialize(msg, &buf, &len))
+				break;
+			faux_free(buf);
+		} else if (BENCH_MSG_DESERIALIZE == op) {
+			faux_msg_t *new_msg = faux_msg_deserialize(raw, raw_len);
+			if (!new_msg)
+				break;
+			faux_msg_free(new_msg);
+		} else {
+			struct iovec *iov = NULL;
+			size_t iov_num = 0;
+			if (!faux_msg_iov(msg, &iov, &iov_num))
+				break;
+			faux_free(iov);
+		}
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_free(raw);
+	faux_msg_free(msg);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_msg_serialize_1x16(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_SERIALIZE, 1, 16);
+}
+
+
+int bench_faux_msg_serialize_16x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_SERIALIZE, 16, 64);
+}
+
+
+int bench_faux_msg_serialize_256x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_SERIALIZE, 256, 64);
+}
+
+
+int bench_faux_msg_serialize_16x4k(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_SERIALIZE, 16, 4096);
+}
+
+
+int bench_faux_msg_deserialize_1x16(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_DESERIALIZE, 1, 16);
+}
+
+
+int bench_faux_msg_deserialize_16x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_DESERIALIZE, 16, 64);
+}
+
+
+int bench_faux_msg_deserialize_256x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_DESERIALIZE, 256, 64);
+}
+
+
+int bench_faux_msg_deserialize_16x4k(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_DESERIALIZE, 16, 4096);
+}
+
+
+int bench_faux_msg_iov_1x16(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_IOV, 1, 16);
+}
+
+
+int bench_faux_msg_iov_16x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_IOV, 16, 64);
+}
+
+
+int bench_faux_msg_iov_256x64(faux_testc_bench_t *bench)
+{
+	return bench_msg(bench, BENCH_MSG_IOV, 256, 64);
+}
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "faux/faux.h"
+#include "faux/time.h"
+#include "faux/sched.h"
+#include "bench/bench.h"
+
+
+/** @brief Creates scheduler with "num" pending events
+ *
+ * The events are far in the future so they never expire while benchmark
+ * is running.
+ */
+static faux_sched_t *bench_sched_fill(size_t num, const struct timespec *now)
+{
+	faux_sched_t *sched = NULL;
+	size_t i = 0;
+
+	sched = faux_sched_new();
+	if (!sched)
+		return NULL;
+	for (i = 0; i < num; i++) {
+		struct timespec t = { now->tv_sec + 3600 + i, 0 };
+		if (!faux_sched_once(sched, &t, i, NULL)) {
+			faux_sched_free(sched);
+			return NULL;
+		}
+	}
+
+	return sched;
+}
+
+
+/** @brief Schedules expired event and pops it
+ */
+static int bench_sched_once_pop(faux_testc_bench_t *bench, size_t num)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec now = {};
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	faux_timespec_now(&now);
+	sched = bench_sched_fill(num, &now);
+	if (!sched)
+		return -1;
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		faux_ev_t *ev = NULL;
+		faux_sched_once(sched, FAUX_SCHED_NOW, 0, NULL);
+		ev = faux_sched_pop(sched);
+		if (!ev)
+			break;
+		faux_ev_free(ev);
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_sched_free(sched);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+/** @brief Schedules event to random time and deletes it
+ */
+static int bench_sched_add_del(faux_testc_bench_t *bench, size_t num)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec now = {};
+	uint32_t rnd = BENCH_SEED;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	faux_timespec_now(&now);
+	sched = bench_sched_fill(num, &now);
+	if (!sched)
+		return -1;
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		struct timespec t = { now.tv_sec + 3600 +
+			bench_rnd(&rnd) % num, 500000000 };
+		faux_ev_t *ev = faux_sched_once(sched, &t, 0, NULL);
+		if (!ev)
+			break;
+		if (faux_sched_del(sched, ev) != 1)
+			break;
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_sched_free(sched);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_sched_once_pop(faux_testc_bench_t *bench)
+{
+	return bench_sched_once_pop(bench, 1000);
+}
+
+
+int bench_faux_sched_once_pop_100k(faux_testc_bench_t *bench)
+{
+	return bench_sched_once_pop(bench, 100000);
+}
+
+
+int bench_faux_sched_add_del_100k(faux_testc_bench_t *bench)
+{
+	return bench_sched_add_del(bench, 100000);
+}
@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "faux/faux.h"
+#include "faux/ctype.h"
+#include "faux/str.h"
+#include "faux/conv.h"
+#include "bench/bench.h"
+
+#define BENCH_STR_LINE \
+	"show interface \"GigabitEthernet 0/1\" detail | include 'rate' | count"
+
+
+/** @brief Fills string of "len" bytes by mixed case letters
+ */
+static void bench_str_fill(char *str, size_t len)
+{
+	size_t i = 0;
+
+	for (i = 0; i < len; i++)
+		str[i] = ((i & 1) ? 'A' : 'a') + (i % 26);
+	str[len] = '\0';
+}
+
+
+int bench_faux_str_casecmp(faux_testc_bench_t *bench)
+{
+	char str1[65];
+	char str2[65];
+	uint64_t i = 0;
+
+	bench_str_fill(str1, sizeof(str1) - 1);
+	// Same strings with different case
+	for (i = 0; i < sizeof(str2); i++)
+		str2[i] = faux_ctype_toupper(str1[i]);
+	faux_testc_bench_set_bytes(bench, sizeof(str1) - 1);
+	for (i = 0; i < bench->iters; i++) {
+		if (faux_str_casecmp(str1, str2) != 0)
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_str_casestr(faux_testc_bench_t *bench)
+{
+	char haystack[4097];
+	char copy[4097];
+	const char *needle = "NEEDLE_in_HayStack";
+	uint64_t i = 0;
+
+	bench_str_fill(haystack, sizeof(haystack) - 1);
+	memcpy(haystack + sizeof(haystack) - 100, "needle_IN_haystack", 18);
+	// Copy differs at the end so the whole string is compared
+	memcpy(copy, haystack, sizeof(copy));
+	copy[sizeof(copy) - 2] = '!';
+	faux_testc_bench_set_bytes(bench, 2 * (sizeof(haystack) - 1));
+	for (i = 0; i < bench->iters; i++) {
+		if (!faux_str_casestr(haystack, needle))
+			break;
+		if (faux_str_casecmpn(haystack, copy, sizeof(copy)) == 0)
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_str_tolower(faux_testc_bench_t *bench)
+{
+	char str[1025];
+	uint64_t i = 0;
+
+	bench_str_fill(str, sizeof(str) - 1);
+	faux_testc_bench_set_bytes(bench, sizeof(str) - 1);
+	for (i = 0; i < bench->iters; i++) {
+		char *lower = faux_str_tolower(str);
+		if (!lower)
+			break;
+		faux_str_free(lower);
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_str_dup(faux_testc_bench_t *bench)
+{
+	const char *str = "The string of thirty two bytes!";
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, strlen(str));
+	for (i = 0; i < bench->iters; i++) {
+		char *dup = faux_str_dup(str);
+		if (!dup)
+			break;
+		faux_str_free(dup);
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_str_nextword(faux_testc_bench_t *bench)
+{
+	const char *line = BENCH_STR_LINE;
+	char buf[sizeof(BENCH_STR_LINE)];
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, strlen(line));
+	for (i = 0; i < bench->iters; i++) {
+		const char *saveptr = line;
+		unsigned int words = 0;
+		while (faux_str_nextword_buf(saveptr, &saveptr, "'", NULL,
+			buf) >= 0)
+			words++;
+		if (words != 9)
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_strbuf_append(faux_testc_bench_t *bench)
+{
+	faux_strbuf_t *sb = NULL;
+	const char *piece = "sixteen  bytes, ";
+	uint64_t i = 0;
+
+	faux_testc_bench_set_bytes(bench, 16 * strlen(piece));
+	sb = faux_strbuf_new(0);
+	if (!sb)
+		return -1;
+	for (i = 0; i < bench->iters; i++) {
+		unsigned int j = 0;
+		faux_strbuf_reset(sb);
+		for (j = 0; j < 16; j++)
+			faux_strbuf_append(sb, piece);
+		if (faux_strbuf_len(sb) != 16 * strlen(piece))
+			break;
+	}
+	faux_strbuf_free(sb);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_conv_atoul(faux_testc_bench_t *bench)
+{
+	const char *str = "1234567890";
+	uint64_t i = 0;
+
+	for (i = 0; i < bench->iters; i++) {
+		unsigned long int val = 0;
+		if (!faux_conv_atoul(str, &val, 10) || (val != 1234567890UL))
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+/** @brief Fills arrays by random numbers of different lengths
+ */
+static void bench_conv_rnd_fill(char strs[256][24],
+	unsigned long long int vals[256])
+{
+	uint32_t rnd = BENCH_SEED;
+	unsigned int i = 0;
+
+	for (i = 0; i < 256; i++) {
+		vals[i] = ((unsigned long long int)bench_rnd(&rnd) << 32) |
+			bench_rnd(&rnd);
+		vals[i] >>= bench_rnd(&rnd) % 64;
+		snprintf(strs[i], sizeof(strs[i]), "%llu", vals[i]);
+	}
+}
+
+
+int bench_faux_conv_atoull_rnd(faux_testc_bench_t *bench)
+{
+	char strs[256][24];
+	unsigned long long int vals[256];
+	uint64_t i = 0;
+
+	bench_conv_rnd_fill(strs, vals);
+	for (i = 0; i < bench->iters; i++) {
+		unsigned long long int val = 0;
+		if (!faux_conv_atoull(strs[i & 255], &val, 10) ||
+			(val != vals[i & 255]))
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+// Baseline for bench_faux_conv_atoull_rnd
+int bench_strtoull_rnd(faux_testc_bench_t *bench)
+{
+	char strs[256][24];
+	unsigned long long int vals[256];
+	uint64_t i = 0;
+
+	bench_conv_rnd_fill(strs, vals);
+	for (i = 0; i < bench->iters; i++) {
+		char *endptr = NULL;
+		unsigned long long int val = strtoull(strs[i & 255], &endptr, 10);
+		if ((*endptr != '\0') || (val != vals[i & 255]))
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_conv_atol_hex(faux_testc_bench_t *bench)
+{
+	const char *str = "-0x7fffabcd";
+	uint64_t i = 0;
+
+	for (i = 0; i < bench->iters; i++) {
+		long int val = 0;
+		if (!faux_conv_atol(str, &val, 0) || (val != -0x7fffabcdL))
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_conv_ultoa(faux_testc_bench_t *bench)
+{
+	char buf[FAUX_CONV_ULTOA_MAX];
+	uint32_t rnd = BENCH_SEED;
+	uint64_t i = 0;
+
+	for (i = 0; i < bench->iters; i++) {
+		unsigned long long int val = ((unsigned long long int)
+			bench_rnd(&rnd) << 32) | bench_rnd(&rnd);
+		if (faux_conv_ultoa(val, buf, sizeof(buf)) == 0)
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_conv_timespec(faux_testc_bench_t *bench)
+{
+	char buf[FAUX_CONV_TIMESPEC_MAX];
+	struct timespec ts = { 1700000000, 123456789 };
+	uint64_t i = 0;
+
+	for (i = 0; i < bench->iters; i++) {
+		ts.tv_nsec = (ts.tv_nsec + 1) % 1000000000;
+		if (faux_conv_timespec(&ts, buf, sizeof(buf)) == 0)
+			break;
+	}
+
+	return (i == bench->iters) ? 0 : -1;
+}
@@ -0,0 +1,65 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "faux/faux.h"
+#include "faux/vec.h"
+#include "bench/bench.h"
+
+
+/** @brief Adds item to vector of "num" items and removes item by index
+ *
+ * Removing the first item moves the whole vector. Removing the last one
+ * doesn't.
+ */
+static int bench_vec_add_del(faux_testc_bench_t *bench, size_t num,
+	bool_t head)
+{
+	faux_vec_t *vec = NULL;
+	uint64_t i = 0;
+
+	faux_testc_bench_stop(bench);
+	vec = faux_vec_new(sizeof(uint32_t), NULL);
+	if (!vec)
+		return -1;
+	for (i = 0; i < num; i++) {
+		uint32_t *item = faux_vec_add(vec);
+		if (!item) {
+			faux_vec_free(vec);
+			return -1;
+		}
+		*item = i;
+	}
+	faux_testc_bench_start(bench);
+
+	for (i = 0; i < bench->iters; i++) {
+		uint32_t *item = faux_vec_add(vec);
+		if (!item)
+			break;
+		*item = i;
+		if (faux_vec_del(vec, head ? 0 : num) < 0)
+			break;
+	}
+
+	faux_testc_bench_stop(bench);
+	faux_vec_free(vec);
+
+	return (i == bench->iters) ? 0 : -1;
+}
+
+
+int bench_faux_vec_add_del_tail_1k(faux_testc_bench_t *bench)
+{
+	return bench_vec_add_del(bench, 1000, BOOL_FALSE);
+}
+
+
+int bench_faux_vec_add_del_head_1k(faux_testc_bench_t *bench)
+{
+	return bench_vec_add_del(bench, 1000, BOOL_TRUE);
+}
+
+
+int bench_faux_vec_add_del_head_100k(faux_testc_bench_t *bench)
+{
+	return bench_vec_add_del(bench, 100000, BOOL_TRUE);
+}
@@ -14,6 +14,7 @@ typedef faux_list_node_t faux_argv_node_t;
 C_DECL_BEGIN
 
 faux_argv_t *faux_argv_new(void);
+faux_argv_t *faux_argv_new_arena(void);
 faux_argv_t *faux_argv_dup(const faux_argv_t *origin);
 void faux_argv_free(faux_argv_t *fargv);
 void faux_argv_set_quotes(faux_argv_t *fargv, const char *quotes);
@@ -27,6 +28,7 @@ const char *faux_argv_current(faux_argv_node_t *iter);
 const char *faux_argv_index(const faux_argv_t *fargv, size_t index);
 
 ssize_t faux_argv_parse(faux_argv_t *fargv, const char *str);
+ssize_t faux_argv_reparse(faux_argv_t *fargv, const char *str);
 bool_t faux_argv_add(faux_argv_t *fargv, const char *arg);
 bool_t faux_argv_del(faux_argv_t *fargv, faux_argv_node_t *node);
 
@@ -35,6 +35,45 @@ faux_argv_t *faux_argv_new(void)
 		NULL, NULL, (void (*)(void *))faux_str_free);
 	fargv->quotes = NULL;
 	fargv->continuable = BOOL_FALSE;
+	fargv->arena_mode = BOOL_FALSE;
+	fargv->list_valid = BOOL_TRUE;
+	fargv->arena = NULL;
+	fargv->arena_len = 0;
+	fargv->arena_size = 0;
+	fargv->words = NULL;
+	fargv->src_ends = NULL;
+	fargv->words_num = 0;
+	fargv->words_size = 0;
+	fargv->line = NULL;
+	fargv->line_size = 0;
+
+	return fargv;
+}
+
+
+/** @brief Allocates new argv object in arena mode.
+ *
+ * All words of arena argv object live in single buffer. The offsets of
+ * words are stored in array. So parsing costs constant number of
+ * allocations and faux_argv_index() is O(1). The arena argv object can be
+ * incrementally reparsed by faux_argv_reparse(). The iterators are
+ * supported too but list of pointers to words is built on demand.
+ *
+ * @return Allocated and initialized argument list or NULL on error.
+ */
+faux_argv_t *faux_argv_new_arena(void)
+{
+	faux_argv_t *fargv = NULL;
+
+	fargv = faux_argv_new();
+	if (!fargv)
+		return NULL;
+
+	// The list contains pointers to arena so it doesn't free data
+	faux_list_free(fargv->list);
+	fargv->list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, NULL);
+	fargv->arena_mode = BOOL_TRUE;
 
 	return fargv;
 }
@@ -48,7 +87,6 @@ faux_argv_t *faux_argv_new(void)
 faux_argv_t *faux_argv_dup(const faux_argv_t *origin)
 {
 	faux_argv_t *fargv = NULL;
-	faux_list_t *list = NULL;
 	faux_argv_node_t *iter = NULL;
 	const char *arg = NULL;
 
@@ -56,20 +94,22 @@ faux_argv_t *faux_argv_dup(const faux_argv_t *origin)
 	if (!origin)
 		return NULL;
 
-	fargv = faux_argv_new();
+	if (origin->arena_mode)
+		fargv = faux_argv_new_arena();
+	else
+		fargv = faux_argv_new();
 	assert(fargv);
 	if (!fargv)
 		return NULL;
 
-	// Copy all fields but list must be recreated
-	list = fargv->list;
-	*fargv = *origin;
-	fargv->list = list;
+	// Copy fields
+	faux_argv_set_quotes(fargv, origin->quotes);
 
 	// Copy list
 	iter = faux_argv_iter(origin);
 	while ((arg = faux_argv_each(&iter)))
 		faux_argv_add(fargv, arg);
+	fargv->continuable = origin->continuable;
 
 	return fargv;
 }
@@ -86,10 +126,173 @@ void faux_argv_free(faux_argv_t *fargv)
 
 	faux_list_free(fargv->list);
 	faux_str_free(fargv->quotes);
+	faux_free(fargv->arena);
+	faux_free(fargv->words);
+	faux_free(fargv->src_ends);
+	faux_free(fargv->line);
 	faux_free(fargv);
 }
 
 
+/** @brief Reserves space within arena.
+ *
+ * Static function.
+ *
+ * @param [in] fargv Allocated argv object.
+ * @param [in] add_len Number of bytes to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_argv_arena_reserve(faux_argv_t *fargv, size_t add_len)
+{
+	size_t need = fargv->arena_len + add_len;
+	size_t new_size = 0;
+	char *new_arena = NULL;
+
+	if (need <= fargv->arena_size)
+		return BOOL_TRUE;
+
+	new_size = fargv->arena_size ? fargv->arena_size : 64;
+	while (new_size < need)
+		new_size *= 2;
+	new_arena = faux_realloc(fargv->arena, new_size);
+	if (!new_arena)
+		return BOOL_FALSE;
+	fargv->arena = new_arena;
+	fargv->arena_size = new_size;
+	// Pointers to words are changed
+	fargv->list_valid = BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Reserves entry within array of words.
+ *
+ * Static function.
+ *
+ * @param [in] fargv Allocated argv object.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_argv_words_reserve(faux_argv_t *fargv)
+{
+	size_t new_size = 0;
+	size_t *new_words = NULL;
+	size_t *new_src_ends = NULL;
+
+	if (fargv->words_num < fargv->words_size)
+		return BOOL_TRUE;
+
+	new_size = fargv->words_size ? (fargv->words_size * 2) : 16;
+	new_words = faux_realloc(fargv->words, new_size * sizeof(*new_words));
+	if (!new_words)
+		return BOOL_FALSE;
+	fargv->words = new_words;
+	new_src_ends = faux_realloc(fargv->src_ends,
+		new_size * sizeof(*new_src_ends));
+	if (!new_src_ends)
+		return BOOL_FALSE;
+	fargv->src_ends = new_src_ends;
+	fargv->words_size = new_size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Stores copy of parsed line for incremental reparsing.
+ *
+ * Static function.
+ *
+ * @param [in] fargv Allocated argv object.
+ * @param [in] str Parsed line. NULL - line is untracked.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_argv_track_line(faux_argv_t *fargv, const char *str)
+{
+	size_t len = 0;
+
+	if (!str) {
+		faux_free(fargv->line);
+		fargv->line = NULL;
+		fargv->line_size = 0;
+		return BOOL_TRUE;
+	}
+
+	len = strlen(str) + 1;
+	if (len > fargv->line_size) {
+		char *new_line = faux_realloc(fargv->line, len);
+		if (!new_line) {
+			faux_argv_track_line(fargv, NULL);
+			return BOOL_FALSE;
+		}
+		fargv->line = new_line;
+		fargv->line_size = len;
+	}
+	memcpy(fargv->line, str, len);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Builds list of pointers to arena words.
+ *
+ * Static function. The list is used by iterators only.
+ *
+ * @param [in] fargv Allocated argv object.
+ */
+static void faux_argv_sync_list(faux_argv_t *fargv)
+{
+	size_t i = 0;
+
+	if (!fargv->arena_mode || fargv->list_valid)
+		return;
+
+	faux_list_del_all(fargv->list);
+	for (i = 0; i < fargv->words_num; i++)
+		faux_list_add(fargv->list, fargv->arena + fargv->words[i]);
+	fargv->list_valid = BOOL_TRUE;
+}
+
+
+/** @brief Parses the rest of line to arena.
+ *
+ * Static function. The words are appended to arena.
+ *
+ * @param [in] fargv Allocated argv object in arena mode.
+ * @param [in] line Whole line.
+ * @param [in] pos Position within line to parse from.
+ * @return Number of words or < 0 on error.
+ */
+static ssize_t faux_argv_arena_parse(faux_argv_t *fargv, const char *line,
+	size_t pos)
+{
+	const char *saveptr = line + pos;
+	bool_t closed_quotes = BOOL_FALSE;
+	ssize_t len = 0;
+
+	fargv->list_valid = BOOL_FALSE;
+	// Words with separators are never longer than the source text.
+	// Additional byte for '\0' written when no word is found.
+	if (!faux_argv_arena_reserve(fargv, strlen(saveptr) + 2))
+		return -1;
+
+	while ((len = faux_str_nextword_buf(saveptr, &saveptr, fargv->quotes,
+		&closed_quotes, fargv->arena + fargv->arena_len)) >= 0) {
+		if (!faux_argv_words_reserve(fargv))
+			return -1;
+		fargv->words[fargv->words_num] = fargv->arena_len;
+		fargv->src_ends[fargv->words_num] = saveptr - line;
+		fargv->words_num++;
+		fargv->arena_len += len + 1;
+	}
+
+	// See faux_argv_parse()
+	fargv->continuable = !closed_quotes ||
+		((saveptr != line) && (!isspace(*(saveptr - 1))));
+
+	return fargv->words_num;
+}
+
+
 /** @brief Initializes iterator to iterate through the entire argv object.
  *
  * Before iterating with the faux_argv_each() function the iterator must be
@@ -105,6 +308,9 @@ faux_argv_node_t *faux_argv_iter(const faux_argv_t *fargv)
 	if (!fargv)
 		return NULL;
 
+	// Lazy build of list doesn't change argv content
+	faux_argv_sync_list((faux_argv_t *)fargv);
+
 	return (faux_argv_node_t *)faux_list_head(fargv->list);
 }
 
@@ -124,6 +330,9 @@ faux_argv_node_t *faux_argv_iterr(const faux_argv_t *fargv)
 	if (!fargv)
 		return NULL;
 
+	// Lazy build of list doesn't change argv content
+	faux_argv_sync_list((faux_argv_t *)fargv);
+
 	return (faux_argv_node_t *)faux_list_tail(fargv->list);
 }
 
@@ -225,6 +434,12 @@ ssize_t faux_argv_parse(faux_argv_t *fargv, const char *str)
 	if (!str)
 		return -1;
 
+	if (fargv->arena_mode) {
+		// Only the whole content can be reparsed incrementally
+		faux_argv_track_line(fargv, (0 == fargv->words_num) ? str : NULL);
+		return faux_argv_arena_parse(fargv, str, 0);
+	}
+
 	while ((word = faux_str_nextword(saveptr, &saveptr, fargv->quotes, &closed_quotes)))
 		faux_list_add(fargv->list, word);
 
@@ -237,6 +452,65 @@ ssize_t faux_argv_parse(faux_argv_t *fargv, const char *str)
 }
 
 
+/** @brief Replaces content of argv object by words of the line.
+ *
+ * The result is the same as parsing of line by faux_argv_parse() to the
+ * empty argv object. The argv object in arena mode remembers previously
+ * parsed line. The words located before the first changed character are
+ * not tokenized again. So reparsing of edited line (on auto-completion for
+ * example) costs tokenizing of changed tail only.
+ *
+ * @param [in] fargv Allocated fargv object.
+ * @param [in] str String to parse.
+ * @return Number of resulting words and substrings or < 0 on error.
+ */
+ssize_t faux_argv_reparse(faux_argv_t *fargv, const char *str)
+{
+	size_t diff = 0;
+	size_t kept = 0;
+	size_t pos = 0;
+
+	assert(fargv);
+	if (!fargv)
+		return -1;
+	if (!str)
+		return -1;
+
+	if (!fargv->arena_mode) {
+		faux_list_del_all(fargv->list);
+		return faux_argv_parse(fargv, str);
+	}
+
+	// Untracked content. Parse the whole line
+	if (!fargv->line) {
+		fargv->words_num = 0;
+		fargv->arena_len = 0;
+		return faux_argv_parse(fargv, str);
+	}
+
+	// Find first changed character
+	while ((fargv->line[diff] != '\0') && (fargv->line[diff] == str[diff]))
+		diff++;
+	if (fargv->line[diff] == str[diff]) // Line is not changed
+		return fargv->words_num;
+
+	// Keep words that were finished (with terminating symbol) before the
+	// changed character. The tokenizer has no state between words.
+	kept = fargv->words_num;
+	while ((kept > 0) && (fargv->src_ends[kept - 1] >= diff))
+		kept--;
+	if (kept < fargv->words_num)
+		fargv->arena_len = fargv->words[kept];
+	fargv->words_num = kept;
+	pos = kept ? fargv->src_ends[kept - 1] : 0;
+
+	if (!faux_argv_track_line(fargv, str))
+		return -1;
+
+	return faux_argv_arena_parse(fargv, str, pos);
+}
+
+
 /** @brief Get number of arguments.
  *
  * @param [in] fargv Allocated fargv object.
@@ -248,6 +522,9 @@ ssize_t faux_argv_len(faux_argv_t *fargv)
 	if (!fargv)
 		return -1;
 
+	if (fargv->arena_mode)
+		return fargv->words_num;
+
 	return faux_list_len(fargv->list);
 }
 
@@ -301,6 +578,18 @@ void faux_argv_del_continuable(faux_argv_t *fargv)
 
 	if (!fargv->continuable)
 		return;
+
+	if (fargv->arena_mode) {
+		if (0 == fargv->words_num)
+			return;
+		fargv->words_num--;
+		fargv->arena_len = fargv->words[fargv->words_num];
+		if (fargv->list_valid)
+			faux_list_del(fargv->list, faux_list_tail(fargv->list));
+		faux_argv_track_line(fargv, NULL);
+		return;
+	}
+
 	tail = faux_list_tail(fargv->list);
 	if (!tail)
 		return;
@@ -341,6 +630,22 @@ bool_t faux_argv_add(faux_argv_t *fargv, const char *arg)
 	if (!arg)
 		return BOOL_FALSE;
 
+	if (fargv->arena_mode) {
+		size_t len = strlen(arg);
+		if (!faux_argv_arena_reserve(fargv, len + 1))
+			return BOOL_FALSE;
+		if (!faux_argv_words_reserve(fargv))
+			return BOOL_FALSE;
+		memcpy(fargv->arena + fargv->arena_len, arg, len + 1);
+		fargv->words[fargv->words_num] = fargv->arena_len;
+		fargv->src_ends[fargv->words_num] = 0;
+		fargv->words_num++;
+		fargv->arena_len += len + 1;
+		fargv->list_valid = BOOL_FALSE;
+		faux_argv_track_line(fargv, NULL);
+		return BOOL_TRUE;
+	}
+
 	faux_list_add(fargv->list, faux_str_dup(arg));
 
 	return BOOL_TRUE;
@@ -362,6 +667,24 @@ bool_t faux_argv_del(faux_argv_t *fargv, faux_argv_node_t *node)
 	if (!node)
 		return BOOL_FALSE;
 
+	if (fargv->arena_mode) {
+		faux_list_node_t *iter = faux_list_head(fargv->list);
+		size_t i = 0;
+		// The node was got from iterator so list is actual
+		while (iter && (iter != (faux_list_node_t *)node)) {
+			iter = faux_list_next_node(iter);
+			i++;
+		}
+		if (!iter || (i >= fargv->words_num))
+			return BOOL_FALSE;
+		memmove(fargv->words + i, fargv->words + i + 1,
+			(fargv->words_num - i - 1) * sizeof(*fargv->words));
+		memmove(fargv->src_ends + i, fargv->src_ends + i + 1,
+			(fargv->words_num - i - 1) * sizeof(*fargv->src_ends));
+		fargv->words_num--;
+		faux_argv_track_line(fargv, NULL);
+	}
+
 	faux_list_del(fargv->list, (faux_list_node_t *)node);
 
 	return BOOL_TRUE;
@@ -381,6 +704,12 @@ const char *faux_argv_index(const faux_argv_t *fargv, size_t index)
 	if (!fargv)
 		return NULL;
 
+	if (fargv->arena_mode) {
+		if (index >= fargv->words_num)
+			return NULL;
+		return fargv->arena + fargv->words[index];
+	}
+
 	res = (const char *)faux_list_index(fargv->list, index);
 
 	return res;
@@ -398,23 +727,36 @@ const char *faux_argv_index(const faux_argv_t *fargv, size_t index)
 char *faux_argv_line(const faux_argv_t *fargv)
 {
 	bool_t is_first_arg = BOOL_TRUE;
-	char *line = NULL;
+	faux_strbuf_t *sb = NULL;
 	faux_argv_node_t *iter = NULL;
 	const char *arg = NULL;
 
+	if (!fargv)
+		return NULL;
+	// Lazy build of list doesn't change argv content
+	faux_argv_sync_list((faux_argv_t *)fargv);
+	if (faux_list_is_empty(fargv->list))
+		return NULL;
+
+	sb = faux_strbuf_new(0);
+	if (!sb)
+		return NULL;
 	iter = faux_argv_iter(fargv);
 	while ((arg = faux_argv_each(&iter))) {
-		bool_t space_found = BOOL_FALSE;
-		char *str = NULL;
+		bool_t quote = BOOL_FALSE;
 
 		if (is_first_arg)
 			is_first_arg = BOOL_FALSE;
 		else
-			faux_str_cat(&line, " ");
-		str = faux_str_c_esc_quote(arg);
-		faux_str_cat(&line, str);
-		faux_str_free(str);
+			faux_strbuf_appendc(sb, ' ');
+		// String with space must have quotes
+		quote = strchr(arg, ' ') ? BOOL_TRUE : BOOL_FALSE;
+		if (quote)
+			faux_strbuf_appendc(sb, '"');
+		faux_strbuf_append_escaped(sb, arg, BOOL_FALSE);
+		if (quote)
+			faux_strbuf_appendc(sb, '"');
 	}
 
-	return line;
+	return faux_strbuf_detach(sb);
 }
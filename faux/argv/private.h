@@ -6,4 +6,16 @@ struct faux_argv_s {
 	faux_list_t *list;
 	char *quotes; // List of possible quotes chars
 	bool_t continuable; // Is last argument continuable
+	// Arena mode. The words are stored within single buffer
+	bool_t arena_mode;
+	bool_t list_valid; // The list of pointers to arena words is actual
+	char *arena; // Words separated by '\0'
+	size_t arena_len; // Used space
+	size_t arena_size; // Allocated space
+	size_t *words; // Offsets of words within arena
+	size_t *src_ends; // Offsets of source text end for each word
+	size_t words_num;
+	size_t words_size; // Number of allocated entries
+	char *line; // Parsed line for incremental reparsing. NULL - untracked
+	size_t line_size; // Allocated space for line copy
 };
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "faux/str.h"
 #include "faux/argv.h"
 
 
@@ -151,3 +152,125 @@ int testc_faux_argv_index(void)
 
 	return retval;
 }
+
+
+// Compares arena argv with list argv
+static int argv_compare(faux_argv_t *arena, faux_argv_t *list, const char *line)
+{
+	faux_argv_node_t *iter = NULL;
+	const char *arg = NULL;
+	ssize_t index = 0;
+
+	if (faux_argv_len(arena) != faux_argv_len(list)) {
+		printf("Line [%s]: length %ld != %ld\n", line,
+			faux_argv_len(arena), faux_argv_len(list));
+		return -1;
+	}
+	if (faux_argv_is_continuable(arena) != faux_argv_is_continuable(list)) {
+		printf("Line [%s]: continuable flag differs\n", line);
+		return -1;
+	}
+	iter = faux_argv_iter(list);
+	while ((arg = faux_argv_each(&iter))) {
+		const char *res = faux_argv_index(arena, index);
+		if (!res || (strcmp(res, arg) != 0)) {
+			printf("Line [%s]: word %ld [%s] != [%s]\n", line,
+				index, res ? res : "(null)", arg);
+			return -1;
+		}
+		index++;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_argv_arena(void)
+{
+	const char* line = "asd\"\\\"\"mmm \"``\" `ll\"l\\p\\\\m```j`j`` ```kk``pp``` ll\\ l jj\\\"kk ll\\\\nn  \"aaa\"bbb`ccc```ddd``eee ``lk\\\" ";
+	const char* edits[] = {"show interfaces ge-0/0/1 detail",
+		"show interfaces ge-0/0/12 detail", "show int", "",
+		"show \"quoted word\" tail", "show \"quoted word tail",
+		"show interfaces", NULL};
+	faux_argv_t *arena = NULL;
+	faux_argv_t *dup = NULL;
+	faux_argv_node_t *iter = NULL;
+	char *prefix = NULL;
+	char *str = NULL;
+	size_t len = strlen(line);
+	size_t i = 0;
+	int retval = -1;
+
+	arena = faux_argv_new_arena();
+	faux_argv_set_quotes(arena, "`");
+
+	// Typing line char by char
+	prefix = faux_zmalloc(len + 1);
+	for (i = 0; i <= len; i++) {
+		faux_argv_t *list = faux_argv_new();
+		faux_argv_set_quotes(list, "`");
+		memcpy(prefix, line, i);
+		prefix[i] = '\0';
+		faux_argv_parse(list, prefix);
+		faux_argv_reparse(arena, prefix);
+		if (argv_compare(arena, list, prefix) < 0)
+			goto err;
+		faux_argv_free(list);
+	}
+
+	// Editing of line
+	for (i = 0; edits[i]; i++) {
+		faux_argv_t *list = faux_argv_new();
+		faux_argv_set_quotes(list, "`");
+		faux_argv_parse(list, edits[i]);
+		faux_argv_reparse(arena, edits[i]);
+		if (argv_compare(arena, list, edits[i]) < 0)
+			goto err;
+		faux_argv_free(list);
+	}
+
+	// Modification and duplication
+	faux_argv_add(arena, "added");
+	iter = faux_argv_iter(arena);
+	faux_argv_each(&iter);
+	faux_argv_del(arena, faux_argv_iter(arena));
+	str = faux_argv_line(arena);
+	if (faux_str_cmp(str, "interfaces added") != 0) {
+		printf("Wrong line after modification [%s]\n", str);
+		goto err;
+	}
+	dup = faux_argv_dup(arena);
+	if ((faux_argv_len(dup) != 2) ||
+		(faux_str_cmp(faux_argv_index(dup, 1), "added") != 0)) {
+		printf("Wrong duplicate\n");
+		goto err;
+	}
+
+	// Untracked content is reparsed completely
+	faux_argv_reparse(arena, "show");
+	if ((faux_argv_len(arena) != 1) ||
+		(faux_str_cmp(faux_argv_index(arena, 0), "show") != 0)) {
+		printf("Wrong reparse of modified argv\n");
+		goto err;
+	}
+
+	// Line of freshly parsed arena argv
+	faux_argv_free(arena);
+	arena = faux_argv_new_arena();
+	faux_argv_reparse(arena, "show interface ge-0/0/1");
+	faux_str_free(str);
+	str = faux_argv_line(arena);
+	if (faux_str_cmp(str, "show interface ge-0/0/1") != 0) {
+		printf("Wrong line of arena argv [%s]\n", str);
+		goto err;
+	}
+	retval = 0;
+
+err:
+	faux_str_free(str);
+	faux_free(prefix);
+	faux_argv_free(dup);
+	faux_argv_free(arena);
+
+	return retval;
+}
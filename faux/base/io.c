@@ -11,6 +11,7 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <poll.h>
 
@@ -104,6 +105,78 @@ ssize_t faux_write_block(int fd, const void *buf, size_t n)
 }
 
 
+/** @brief Writes vector of data blocks to file.
+ *
+ * The system writev() can be interrupted by signal or can write less bytes
+ * than specified. This function will continue to write data until all data
+ * will be written or error occured. Function supports non-blocking file
+ * descriptors. It uses poll() for such fd. The iov array is modified while
+ * writing.
+ *
+ * @param [in] fd File descriptor.
+ * @param [in,out] iov Array of data blocks.
+ * @param [in] iovcnt Number of blocks.
+ * @return Number of bytes written.
+ * < sum of blocks then error (but some data was already written).
+ * < 0 - error.
+ */
+ssize_t faux_writev_block(int fd, struct iovec *iov, int iovcnt)
+{
+	size_t total_written = 0;
+
+	assert(iov || (0 == iovcnt));
+	if (!iov && (iovcnt != 0))
+		return -1;
+
+	while (iovcnt > 0) {
+		ssize_t bytes_written = 0;
+
+		// Skip empty blocks
+		if (0 == iov->iov_len) {
+			iov++;
+			iovcnt--;
+			continue;
+		}
+
+		bytes_written = writev(fd, iov, iovcnt);
+		if (bytes_written < 0) {
+			struct pollfd fds = {};
+			if (EINTR == errno)
+				continue;
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+				break;
+			// Non-blocking fd. Wait for free space
+			fds.fd = fd;
+			fds.events = POLLOUT;
+			if ((poll(&fds, 1, -1) < 0) && (errno != EINTR))
+				break;
+			if (fds.revents & (POLLHUP | POLLERR | POLLNVAL))
+				break;
+			continue;
+		}
+		if (0 == bytes_written) // Insufficient space
+			break;
+		total_written += bytes_written;
+
+		// Skip written data
+		while ((iovcnt > 0) && ((size_t)bytes_written >= iov->iov_len)) {
+			bytes_written -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + bytes_written;
+			iov->iov_len -= bytes_written;
+		}
+	}
+
+	if ((iovcnt > 0) && (0 == total_written))
+		return -1;
+
+	return total_written;
+}
+
+
 /** @brief Reads data from file.
  *
  * The system read() can be interrupted by signal. This function will retry to
@@ -195,7 +268,9 @@ size_t faux_read_block(int fd, void *buf, size_t n)
 
 /** @brief Reads whole file to buffer.
  *
- * Allocates buffer and read whole file to it.
+ * Allocates buffer and read whole file to it. Big files are better to be
+ * read by faux_read_whole_file_mapped() or mapped by faux_file_map(). They
+ * don't copy file content to the heap.
  *
  * @param [in] path File name.
  * @param [out] buf Output buffer with file content.
@@ -254,9 +329,9 @@ ssize_t faux_read_whole_file(const char *path, void **data)
 		if (total_readed == buf_full_size) {
 			char *p = NULL;
 			buf_full_size = buf_full_size * 2;
-			p = realloc(buf, buf_full_size);
+			p = faux_realloc(buf, buf_full_size);
 			if (!p) {
-				free(buf);
+				faux_free(buf);
 				close(fd);
 				return -1;
 			}
@@ -267,13 +342,13 @@ ssize_t faux_read_whole_file(const char *path, void **data)
 
 	// Something went wrong
 	if (bytes_readed < 0) {
-		free(buf);
+		faux_free(buf);
 		return -1;
 	}
 
 	// Empty file
 	if (0 == total_readed) {
-		free(buf);
+		faux_free(buf);
 		*data = NULL;
 		return 0;
 	}
@@ -281,9 +356,9 @@ ssize_t faux_read_whole_file(const char *path, void **data)
 	// Shrink buffer to actual data size
 	if (total_readed < buf_full_size) {
 		char *p = NULL;
-		p = realloc(buf, total_readed);
+		p = faux_realloc(buf, total_readed);
 		if (!p) {
-			free(buf);
+			faux_free(buf);
 			return -1;
 		}
 		buf = p;
@@ -292,3 +367,137 @@ ssize_t faux_read_whole_file(const char *path, void **data)
 
 	return total_readed;
 }
+
+
+/** @brief Service static function to read all data from fd.
+ *
+ * It's a fallback for files that can't be mapped.
+ *
+ * @param [in] fd File descriptor.
+ * @param [out] data Allocated buffer with file content. NULL for empty file.
+ * @return Number of bytes readed or < 0 on error.
+ */
+static ssize_t faux_read_whole_fd(int fd, void **data)
+{
+	char *buf = NULL;
+	size_t buf_size = 1024;
+	size_t total_readed = 0;
+	ssize_t bytes_readed = 0;
+
+	buf = faux_malloc(buf_size);
+	assert(buf);
+	if (!buf)
+		return -1;
+
+	while ((bytes_readed = faux_read(fd, buf + total_readed,
+		buf_size - total_readed)) > 0) {
+		total_readed += bytes_readed;
+		// Enlarge buffer if needed
+		if (total_readed == buf_size) {
+			char *p = NULL;
+			buf_size = buf_size * 2;
+			p = faux_realloc(buf, buf_size);
+			if (!p) {
+				faux_free(buf);
+				return -1;
+			}
+			buf = p;
+		}
+	}
+	if (bytes_readed < 0) {
+		faux_free(buf);
+		return -1;
+	}
+
+	// Empty file
+	if (0 == total_readed) {
+		faux_free(buf);
+		buf = NULL;
+	}
+	*data = buf;
+
+	return total_readed;
+}
+
+
+/** @brief Reads whole file using memory mapping if possible.
+ *
+ * It's an opt-in alternative for faux_read_whole_file(). The regular file
+ * is mapped read-only so content is not copied to the heap. Kernel is
+ * advised that mapping will be accessed sequentially and will be needed
+ * soon, so read-ahead is aggressive. The pipes, character devices and
+ * special files with zero size (like /proc files) can't be mapped. Such
+ * files are read to allocated buffer. The "mapped" flag tells caller how
+ * data was got. The data must be released by faux_free_whole_file() with
+ * the same length and flag. Note the mapped file must not be truncated
+ * while data is used.
+ *
+ * @param [in] path File name.
+ * @param [out] data Pointer to file content.
+ * @param [out] mapped BOOL_TRUE if content is mapped, BOOL_FALSE if it was
+ * read to allocated buffer.
+ * @return Number of bytes readed.
+ * = 0 Empty file. The data param will be set to NULL.
+ * < 0 Error.
+ */
+ssize_t faux_read_whole_file_mapped(const char *path, void **data,
+	bool_t *mapped)
+{
+	struct stat statbuf = {};
+	ssize_t len = 0;
+	int fd = -1;
+
+	assert(path);
+	assert(data);
+	assert(mapped);
+	if (!path || !data || !mapped)
+		return -1;
+	*mapped = BOOL_FALSE;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+	if (fstat(fd, &statbuf) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	// Only regular file with known size can be mapped
+	if (S_ISREG(statbuf.st_mode) && (statbuf.st_size > 0)) {
+		void *map = mmap(NULL, statbuf.st_size, PROT_READ,
+			MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			close(fd); // Mapping stays valid after close()
+			madvise(map, statbuf.st_size, MADV_SEQUENTIAL);
+			madvise(map, statbuf.st_size, MADV_WILLNEED);
+			*data = map;
+			*mapped = BOOL_TRUE;
+			return statbuf.st_size;
+		}
+	}
+
+	// Fallback. Read the whole file
+	len = faux_read_whole_fd(fd, data);
+	close(fd);
+
+	return len;
+}
+
+
+/** @brief Releases data got by faux_read_whole_file_mapped().
+ *
+ * @param [in] data Pointer to file content. Can be NULL.
+ * @param [in] len Length of content returned by
+ * faux_read_whole_file_mapped().
+ * @param [in] mapped Flag returned by faux_read_whole_file_mapped().
+ */
+void faux_free_whole_file(void *data, size_t len, bool_t mapped)
+{
+	if (!data)
+		return;
+
+	if (mapped)
+		munmap(data, len);
+	else
+		faux_free(data);
+}
@@ -8,6 +8,11 @@
 
 #include "faux/faux.h"
 
+// Allocation statistics. It's gathered only when enabled by
+// faux_mem_stat_enable() so the disabled accounting costs single relaxed load.
+static bool_t mem_stat_enabled = BOOL_FALSE;
+static faux_mem_stat_t mem_stat = {};
+
 
 /** Portable implementation of free() function.
  *
@@ -24,6 +29,8 @@
  */
 void faux_free(void *ptr)
 {
+	if (ptr && __atomic_load_n(&mem_stat_enabled, __ATOMIC_RELAXED))
+		__atomic_add_fetch(&mem_stat.free_num, 1, __ATOMIC_RELAXED);
 #if 0
 	if (ptr)
 #endif
@@ -48,9 +55,46 @@ void *faux_malloc(size_t size)
 	if (0 == size)
 		return NULL;
 
+	if (__atomic_load_n(&mem_stat_enabled, __ATOMIC_RELAXED)) {
+		__atomic_add_fetch(&mem_stat.malloc_num, 1, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&mem_stat.malloc_bytes, size,
+			__ATOMIC_RELAXED);
+	}
+
 	return malloc(size);
 }
 
+
+/** Portable implementation of realloc() function.
+ *
+ * It's complementary to faux_malloc() and faux_free(). The memory must be
+ * freed by faux_free(). The realloc() of NULL pointer is a new allocation so
+ * it's counted by allocation statistics as faux_malloc(). The reallocation of
+ * existent memory is counted separately. The behaviour when size is 0 is the
+ * same as for faux_malloc(): function will assert() and return NULL.
+ *
+ * @param [in] ptr Memory pointer to reallocate. Can be NULL.
+ * @param [in] size New memory size.
+ * @return Reallocated memory or NULL on error. The original memory is
+ * untouched on error.
+ * @sa realloc()
+ */
+void *faux_realloc(void *ptr, size_t size)
+{
+	assert(size != 0);
+	if (0 == size)
+		return NULL;
+
+	if (!ptr)
+		return faux_malloc(size);
+
+	if (__atomic_load_n(&mem_stat_enabled, __ATOMIC_RELAXED))
+		__atomic_add_fetch(&mem_stat.realloc_num, 1, __ATOMIC_RELAXED);
+
+	return realloc(ptr, size);
+}
+
+
 /** Portable implementation of bzero().
  *
  * The POSIX standard says the bzero() is legacy now. It recommends to use
@@ -119,3 +163,52 @@ void faux_cleanse(void *ptr, size_t size)
 		ctr += 63 + (size_t)p;
 	cleanse_ctr = (unsigned char)ctr;
 }
+
+
+/** @brief Enables or disables allocation statistics.
+ *
+ * When enabled the faux_malloc(), faux_zmalloc(), faux_realloc() and
+ * faux_free() count calls and allocated bytes. The faux_realloc() of NULL
+ * pointer is counted as allocation. The reallocation of existent memory is
+ * counted separately and its size is not added to allocated bytes. The memory
+ * allocated by standard functions directly is not counted. The statistics is
+ * disabled by default. It's intended for tests and benchmarks to verify that
+ * code doesn't allocate memory on hot path.
+ *
+ * @param [in] enable BOOL_TRUE to enable, BOOL_FALSE to disable.
+ */
+void faux_mem_stat_enable(bool_t enable)
+{
+	__atomic_store_n(&mem_stat_enabled, enable, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Resets allocation statistics counters.
+ */
+void faux_mem_stat_reset(void)
+{
+	__atomic_store_n(&mem_stat.malloc_num, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&mem_stat.malloc_bytes, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&mem_stat.realloc_num, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&mem_stat.free_num, 0, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets allocation statistics.
+ *
+ * @param [out] stat Statistics counters.
+ */
+void faux_mem_stat(faux_mem_stat_t *stat)
+{
+	assert(stat);
+	if (!stat)
+		return;
+
+	stat->malloc_num = __atomic_load_n(&mem_stat.malloc_num,
+		__ATOMIC_RELAXED);
+	stat->malloc_bytes = __atomic_load_n(&mem_stat.malloc_bytes,
+		__ATOMIC_RELAXED);
+	stat->realloc_num = __atomic_load_n(&mem_stat.realloc_num,
+		__ATOMIC_RELAXED);
+	stat->free_num = __atomic_load_n(&mem_stat.free_num, __ATOMIC_RELAXED);
+}
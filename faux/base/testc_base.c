@@ -6,6 +6,8 @@
 
 #include "faux/faux.h"
 #include "faux/str.h"
+#include "faux/conv.h"
+#include "faux/argv.h"
 #include "faux/testc_helpers.h"
 
 
@@ -67,3 +69,166 @@ err:
 
 	return ret;
 }
+
+
+int testc_faux_mem_stat(void)
+{
+	faux_mem_stat_t stat = {};
+	char *str = NULL;
+	void *ptr = NULL;
+	char buf[FAUX_CONV_ULTOA_MAX];
+	int ret = -1; // Pessimistic
+
+	// Statistics is not gathered while disabled
+	faux_mem_stat_enable(BOOL_FALSE);
+	faux_mem_stat_reset();
+	ptr = faux_malloc(16);
+	faux_free(ptr);
+	faux_mem_stat(&stat);
+	if (stat.malloc_num || stat.malloc_bytes || stat.free_num) {
+		printf("Statistics is gathered while disabled\n");
+		goto err;
+	}
+
+	faux_mem_stat_enable(BOOL_TRUE);
+	ptr = faux_zmalloc(100);
+	str = faux_str_dup("abc");
+	faux_free(ptr);
+	faux_free(NULL); // Not counted
+	faux_str_free(str);
+	faux_mem_stat(&stat);
+	if ((stat.malloc_num != 2) || (stat.malloc_bytes != 104) ||
+		(stat.free_num != 2)) {
+		printf("Wrong statistics: %llu allocs (%llu B), %llu frees\n",
+			stat.malloc_num, stat.malloc_bytes, stat.free_num);
+		goto err;
+	}
+
+	// Conversion to string must not allocate memory
+	faux_mem_stat_reset();
+	if (faux_conv_ultoa(1234567890ULL, buf, sizeof(buf)) != 10) {
+		printf("Can't convert number\n");
+		goto err;
+	}
+	faux_mem_stat(&stat);
+	if (stat.malloc_num != 0) {
+		printf("Conversion allocates memory\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_mem_stat_enable(BOOL_FALSE);
+
+	return ret;
+}
+
+
+int testc_faux_mem_stat_balance(void)
+{
+	faux_mem_stat_t stat = {};
+	faux_strbuf_t *sb = NULL;
+	faux_argv_t *argv = NULL;
+	char *str = NULL;
+	unsigned int i = 0;
+	int ret = -1; // Pessimistic
+
+	faux_mem_stat_enable(BOOL_TRUE);
+	faux_mem_stat_reset();
+
+	// String buffer grows by faux_realloc()
+	sb = faux_strbuf_new(0);
+	for (i = 0; i < 100; i++)
+		faux_strbuf_printf(sb, "word%u \"quoted %u\" ", i, i);
+	str = faux_strbuf_detach(sb);
+	faux_str_cat(&str, "tail");
+
+	// Arena and words arrays of argv grow by faux_realloc()
+	argv = faux_argv_new_arena();
+	if (faux_argv_parse(argv, str) != 201) {
+		printf("Wrong number of words\n");
+		goto err;
+	}
+	faux_argv_free(argv);
+	argv = NULL;
+	faux_str_free(str);
+	str = NULL;
+
+	faux_mem_stat(&stat);
+	if (stat.malloc_num != stat.free_num) {
+		printf("Unbalanced: %llu allocs, %llu reallocs, %llu frees\n",
+			stat.malloc_num, stat.realloc_num, stat.free_num);
+		goto err;
+	}
+	if (0 == stat.realloc_num) {
+		printf("Reallocations are not counted\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_argv_free(argv);
+	faux_str_free(str);
+	faux_mem_stat_enable(BOOL_FALSE);
+
+	return ret;
+}
+
+
+int testc_faux_read_whole_file_mapped(void)
+{
+	const char *content = "The content of file\nSecond line\n";
+	char *fn = NULL;
+	char *empty_fn = NULL;
+	void *data = NULL;
+	void *etalon = NULL;
+	ssize_t len = 0;
+	bool_t mapped = BOOL_FALSE;
+	int ret = -1; // Pessimistic
+
+	fn = faux_testc_tmpfile_deploy_str(content);
+	empty_fn = faux_testc_tmpfile_deploy_str("");
+	if (!fn || !empty_fn)
+		goto err;
+
+	// Regular file is mapped
+	len = faux_read_whole_file_mapped(fn, &data, &mapped);
+	if ((len != (ssize_t)strlen(content)) || !mapped) {
+		printf("Can't map file: len=%zd mapped=%d\n", len, mapped);
+		goto err;
+	}
+	if (faux_read_whole_file(fn, &etalon) != len) {
+		printf("Can't read file\n");
+		goto err;
+	}
+	if (memcmp(data, etalon, len) != 0) {
+		printf("Mapped data differs from readed one\n");
+		goto err;
+	}
+	faux_free_whole_file(data, len, mapped);
+	data = NULL;
+
+	// Empty file
+	len = faux_read_whole_file_mapped(empty_fn, &data, &mapped);
+	if ((len != 0) || data) {
+		printf("Wrong result for empty file: len=%zd\n", len);
+		goto err;
+	}
+
+	// Special file with zero size is read to the heap
+	len = faux_read_whole_file_mapped("/proc/self/stat", &data, &mapped);
+	if ((len <= 0) || mapped) {
+		printf("Wrong result for special file: len=%zd mapped=%d\n",
+			len, mapped);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_free_whole_file(data, len, mapped);
+	faux_free(etalon);
+	faux_str_free(fn);
+	faux_str_free(empty_fn);
+
+	return ret;
+}
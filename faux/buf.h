@@ -12,10 +12,18 @@
 
 typedef struct faux_buf_s faux_buf_t;
 
+typedef enum {
+	FAUX_BUF_PLAIN = 0, // Single thread buffer (list of chunks)
+	FAUX_BUF_SPSC = 1, // Single producer, single consumer ring
+	FAUX_BUF_MPSC = 2 // Multiple producers, single consumer ring
+} faux_buf_mode_e;
+
 
 C_DECL_BEGIN
 
 faux_buf_t *faux_buf_new(size_t chunk_size);
+faux_buf_t *faux_buf_new_concurrent(size_t size, faux_buf_mode_e mode);
+faux_buf_mode_e faux_buf_mode(const faux_buf_t *buf);
 void faux_buf_free(faux_buf_t *buf);
 ssize_t faux_buf_len(const faux_buf_t *buf);
 ssize_t faux_buf_limit(const faux_buf_t *buf);
@@ -10,6 +10,12 @@
  * "struct iovec" array to write to. After that we unlock buffer. So we don't
  * need additional temporary buffer beetween file's read() and dynamic buffer.
  * Dynamic buffer has the same functionality for reading from it.
+ *
+ * The concurrent flavour of buffer (see faux_buf_new_concurrent()) is a
+ * fixed size ring. It can be written by one thread and readed by another
+ * one. All the functions are the same for both flavours. The functions
+ * just pass control to ring implementation (see ring.c) for concurrent
+ * buffer.
  */
 
 #include <stdlib.h>
@@ -23,21 +29,11 @@
 #include "faux/str.h"
 #include "faux/buf.h"
 
+#include "private.h"
+
 // Default chunk size
 #define DATA_CHUNK 4096
 
-struct faux_buf_s {
-	faux_list_t *list; // List of chunks
-	faux_list_node_t *wchunk; // Chunk to write to. NULL if list is empty
-	size_t rpos; // Read position within first chunk
-	size_t wpos; // Write position within wchunk (can be non-last chunk)
-	size_t chunk_size; // Size of chunk
-	size_t len; // Whole data length
-	size_t limit; // Overflow limit
-	size_t rlocked; // How much space is locked for reading
-	size_t wlocked; // How much space is locked for writing
-};
-
 
 /** @brief Create new dynamic buffer object.
  *
@@ -54,6 +50,7 @@ faux_buf_t *faux_buf_new(size_t chunk_size)
 		return NULL;
 
 	// Init
+	buf->mode = FAUX_BUF_PLAIN;
 	buf->chunk_size = (chunk_size != 0) ? chunk_size : DATA_CHUNK;
 	buf->limit = FAUX_BUF_UNLIMITED;
 	buf->list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
@@ -69,6 +66,21 @@ faux_buf_t *faux_buf_new(size_t chunk_size)
 }
 
 
+/** @brief Returns mode of dynamic buffer.
+ *
+ * @param [in] buf Allocated and initialized buffer object.
+ * @return Buffer mode. See faux_buf_mode_e.
+ */
+faux_buf_mode_e faux_buf_mode(const faux_buf_t *buf)
+{
+	assert(buf);
+	if (!buf)
+		return FAUX_BUF_PLAIN;
+
+	return buf->mode;
+}
+
+
 /** @brief Free dynamic buffer object.
  *
  * @param [in] buf Buffer object.
@@ -78,6 +90,11 @@ void faux_buf_free(faux_buf_t *buf)
 	if (!buf)
 		return;
 
+	if (buf->mode != FAUX_BUF_PLAIN) {
+		faux_buf_ring_free(buf);
+		return;
+	}
+
 	faux_list_free(buf->list);
 
 	faux_free(buf);
@@ -94,6 +111,13 @@ bool_t faux_buf_empty(faux_buf_t *buf)
 		return BOOL_FALSE;
 
 	// Don't empty locked buffer
+	// The ring is emptied by consumer. Don't touch producer's state
+	if (buf->mode != FAUX_BUF_PLAIN) {
+		if (faux_buf_is_rlocked(buf))
+			return BOOL_FALSE;
+		return faux_buf_ring_empty(buf);
+	}
+
 	if (faux_buf_is_rlocked(buf) ||
 		faux_buf_is_wlocked(buf))
 		return BOOL_FALSE;
@@ -119,6 +143,9 @@ ssize_t faux_buf_len(const faux_buf_t *buf)
 	if (!buf)
 		return -1;
 
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_len(buf);
+
 	return buf->len;
 }
 
@@ -135,6 +162,8 @@ FAUX_HIDDEN ssize_t faux_buf_chunk_num(const faux_buf_t *buf)
 	assert(buf);
 	if (!buf)
 		return -1;
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return 1; // The ring is a single chunk
 	assert(buf->list);
 	if (!buf->list)
 		return -1;
@@ -175,6 +204,12 @@ bool_t faux_buf_set_limit(faux_buf_t *buf, size_t limit)
 	if (!buf)
 		return BOOL_FALSE;
 
+	// The ring can't be larger than its storage
+	if (buf->mode != FAUX_BUF_PLAIN) {
+		if ((FAUX_BUF_UNLIMITED == limit) || (limit > buf->chunk_size))
+			limit = buf->chunk_size;
+	}
+
 	buf->limit = limit;
 
 	return BOOL_TRUE;
@@ -304,7 +339,7 @@ bool_t faux_buf_will_be_overflow(const faux_buf_t *buf, size_t add_len)
 	if (FAUX_BUF_UNLIMITED == buf->limit)
 		return BOOL_FALSE;
 
-	if ((buf->len + add_len) > buf->limit)
+	if (((size_t)faux_buf_len(buf) + add_len) > buf->limit)
 		return BOOL_TRUE;
 
 	return BOOL_FALSE;
@@ -382,6 +417,9 @@ ssize_t faux_buf_dread_lock(faux_buf_t *buf, size_t len,
 	if (!iov_num_out)
 		return -1;
 
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dread_lock(buf, len, iov_out, iov_num_out);
+
 	// Don't use already locked buffer
 	if (faux_buf_is_rlocked(buf))
 		return -1;
@@ -471,6 +509,9 @@ ssize_t faux_buf_dread_lock_easy(faux_buf_t *buf, void **data)
 	if (!data)
 		return -1;
 
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dread_lock_easy(buf, data);
+
 	// Don't use already locked buffer
 	if (faux_buf_is_rlocked(buf))
 		return -1;
@@ -528,6 +569,10 @@ ssize_t faux_buf_dread_unlock(faux_buf_t *buf, size_t really_readed,
 	assert(buf);
 	if (!buf)
 		return -1;
+
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dread_unlock(buf, really_readed, iov);
+
 	// Can't unlock non-locked buffer
 	if (!faux_buf_is_rlocked(buf))
 		return -1;
@@ -663,6 +708,9 @@ ssize_t faux_buf_dwrite_lock(faux_buf_t *buf, size_t len,
 	if (!iov_num_out)
 		return -1;
 
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dwrite_lock(buf, len, iov_out, iov_num_out);
+
 	// Don't use already locked buffer
 	if (faux_buf_is_wlocked(buf))
 		return -1;
@@ -764,6 +812,9 @@ ssize_t faux_buf_dwrite_lock_easy(faux_buf_t *buf, void **data)
 	if (!data)
 		return -1;
 
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dwrite_lock_easy(buf, data);
+
 	// Don't use already locked buffer
 	if (faux_buf_is_wlocked(buf))
 		return -1;
@@ -813,6 +864,10 @@ ssize_t faux_buf_dwrite_unlock(faux_buf_t *buf, size_t really_written,
 	assert(buf);
 	if (!buf)
 		return -1;
+
+	if (buf->mode != FAUX_BUF_PLAIN)
+		return faux_buf_ring_dwrite_unlock(buf, really_written, iov);
+
 	// Can't unlock non-locked buffer
 	if (!faux_buf_is_wlocked(buf))
 		return -1;
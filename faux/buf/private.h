@@ -1,4 +1,57 @@
+#include <pthread.h>
+#include <sys/uio.h>
+
 #include "faux/faux.h"
+#include "faux/list.h"
 #include "faux/buf.h"
 
+// Cache line size to separate consumer's and producer's data of ring
+#define FAUX_BUF_CACHE_LINE 64
+
+struct faux_buf_s {
+	faux_buf_mode_e mode; // Plain or concurrent (ring) buffer
+	faux_list_t *list; // List of chunks
+	faux_list_node_t *wchunk; // Chunk to write to. NULL if list is empty
+	size_t rpos; // Read position within first chunk
+	size_t wpos; // Write position within wchunk (can be non-last chunk)
+	size_t chunk_size; // Size of chunk. Size of storage for ring
+	size_t len; // Whole data length
+	size_t limit; // Overflow limit
+	// Concurrent (ring) buffer only
+	char *ring; // Ring storage. The size is power of two
+	// The paddings keep consumer's and producer's sides on different cache
+	// lines. The struct is allocated by faux_zmalloc() so alignment
+	// attributes can't be used.
+	char pad_head[FAUX_BUF_CACHE_LINE];
+	// Consumer's side
+	size_t rlocked; // How much space is locked for reading
+	size_t head; // Read position
+	struct iovec riov[2]; // Locked data for reading
+	char pad_tail[FAUX_BUF_CACHE_LINE];
+	// Producer's side
+	size_t wlocked; // How much space is locked for writing
+	size_t tail; // Write position
+	struct iovec wiov[2]; // Locked space for writing
+	pthread_mutex_t wmutex; // Serializes producers in MPSC mode
+};
+
+C_DECL_BEGIN
+
 ssize_t faux_buf_chunk_num(const faux_buf_t *buf);
+
+// Concurrent (ring) buffer
+FAUX_HIDDEN void faux_buf_ring_free(faux_buf_t *buf);
+FAUX_HIDDEN bool_t faux_buf_ring_empty(faux_buf_t *buf);
+FAUX_HIDDEN ssize_t faux_buf_ring_len(const faux_buf_t *buf);
+FAUX_HIDDEN ssize_t faux_buf_ring_dread_lock(faux_buf_t *buf, size_t len,
+	struct iovec **iov_out, size_t *iov_num_out);
+FAUX_HIDDEN ssize_t faux_buf_ring_dread_lock_easy(faux_buf_t *buf, void **data);
+FAUX_HIDDEN ssize_t faux_buf_ring_dread_unlock(faux_buf_t *buf,
+	size_t really_readed, struct iovec *iov);
+FAUX_HIDDEN ssize_t faux_buf_ring_dwrite_lock(faux_buf_t *buf, size_t len,
+	struct iovec **iov_out, size_t *iov_num_out);
+FAUX_HIDDEN ssize_t faux_buf_ring_dwrite_lock_easy(faux_buf_t *buf, void **data);
+FAUX_HIDDEN ssize_t faux_buf_ring_dwrite_unlock(faux_buf_t *buf,
+	size_t really_written, struct iovec *iov);
+
+C_DECL_END
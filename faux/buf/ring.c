@@ -0,0 +1,381 @@
+/** @file ring.c
+ * @brief Concurrent flavour of dynamic buffer.
+ *
+ * It's a fixed size ring buffer. The size is a power of two. The head
+ * (read position) and tail (write position) are counters that are never
+ * wrapped. The offset within storage is a counter masked by (size - 1).
+ * The consumer changes head only and the producer changes tail only. So
+ * the single producer and single consumer (FAUX_BUF_SPSC) need no locks.
+ * The positions are published by atomic operations with release semantics
+ * after data is copied. In FAUX_BUF_MPSC mode the producers are serialized
+ * by mutex from dwrite_lock to dwrite_unlock. The consumer never waits for
+ * producers in both modes.
+ *
+ * The direct access functions (dread/dwrite locks) return up to two
+ * "struct iovec" entries because locked space can be wrapped around the
+ * end of storage. The "easy" functions return continuous space before the
+ * end of storage.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "faux/faux.h"
+#include "faux/buf.h"
+
+#include "private.h"
+
+// Default ring size
+#define RING_SIZE 65536
+
+#define LOAD_POS(pos) __atomic_load_n(&(pos), __ATOMIC_ACQUIRE)
+#define STORE_POS(pos, val) __atomic_store_n(&(pos), (val), __ATOMIC_RELEASE)
+
+
+/** @brief Create new concurrent dynamic buffer object.
+ *
+ * The concurrent buffer has fixed size storage. The size will be rounded up
+ * to the power of two. The buffer limit is equal to storage size.
+ *
+ * @param [in] size Size of storage. If "0" then default size will be used.
+ * @param [in] mode FAUX_BUF_SPSC or FAUX_BUF_MPSC. The FAUX_BUF_PLAIN
+ * creates regular buffer with "size" chunks.
+ * @return Allocated object or NULL on error.
+ */
+faux_buf_t *faux_buf_new_concurrent(size_t size, faux_buf_mode_e mode)
+{
+	faux_buf_t *buf = NULL;
+	size_t ring_size = 1;
+
+	if (FAUX_BUF_PLAIN == mode)
+		return faux_buf_new(size);
+	if ((mode != FAUX_BUF_SPSC) && (mode != FAUX_BUF_MPSC))
+		return NULL;
+
+	if (0 == size)
+		size = RING_SIZE;
+	while (ring_size < size)
+		ring_size <<= 1;
+
+	buf = faux_zmalloc(sizeof(*buf));
+	assert(buf);
+	if (!buf)
+		return NULL;
+
+	// Init
+	buf->mode = mode;
+	buf->chunk_size = ring_size;
+	buf->limit = ring_size;
+	buf->list = NULL;
+	buf->wchunk = NULL;
+	buf->rlocked = 0; // Unlocked
+	buf->wlocked = 0; // Unlocked
+	buf->head = 0;
+	buf->tail = 0;
+	buf->ring = faux_malloc(ring_size);
+	assert(buf->ring);
+	if (!buf->ring) {
+		faux_free(buf);
+		return NULL;
+	}
+	if (FAUX_BUF_MPSC == mode)
+		pthread_mutex_init(&buf->wmutex, NULL);
+
+	return buf;
+}
+
+
+/** @brief Free concurrent dynamic buffer object.
+ *
+ * @param [in] buf Buffer object.
+ */
+void faux_buf_ring_free(faux_buf_t *buf)
+{
+	if (FAUX_BUF_MPSC == buf->mode)
+		pthread_mutex_destroy(&buf->wmutex);
+	faux_free(buf->ring);
+	faux_free(buf);
+}
+
+
+/** @brief Empty concurrent dynamic buffer object.
+ *
+ * It's a consumer's operation. All the published data will be dropped.
+ * Only head and tail positions are used. The producer's state (locked space)
+ * is not examined because it's changed by another thread.
+ *
+ * @param [in] buf Buffer object.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_buf_ring_empty(faux_buf_t *buf)
+{
+	STORE_POS(buf->head, LOAD_POS(buf->tail));
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Returns length of published data.
+ *
+ * @param [in] buf Allocated and initialized buffer object.
+ * @return Length of buffer.
+ */
+ssize_t faux_buf_ring_len(const faux_buf_t *buf)
+{
+	size_t head = LOAD_POS(buf->head);
+	size_t tail = LOAD_POS(buf->tail);
+
+	return (tail - head);
+}
+
+
+/** @brief Fills "struct iovec" array for space within ring.
+ *
+ * Static function.
+ *
+ * @param [in] buf Allocated and initialized buffer object.
+ * @param [in] pos Position (head or tail counter) of space.
+ * @param [in] len Length of space.
+ * @param [out] iov Array of two "struct iovec" entries.
+ * @return Number of filled entries.
+ */
+static size_t faux_buf_ring_fill_iov(const faux_buf_t *buf, size_t pos,
+	size_t len, struct iovec *iov)
+{
+	size_t offset = pos & (buf->chunk_size - 1);
+	size_t till_end = buf->chunk_size - offset;
+
+	iov[0].iov_base = buf->ring + offset;
+	if (len <= till_end) {
+		iov[0].iov_len = len;
+		return 1;
+	}
+	// Wrapped space
+	iov[0].iov_len = till_end;
+	iov[1].iov_base = buf->ring;
+	iov[1].iov_len = len - till_end;
+
+	return 2;
+}
+
+
+/** @brief Gets "struct iovec" array for direct reading and locks data.
+ *
+ * See faux_buf_dread_lock(). It's a consumer's operation.
+ */
+ssize_t faux_buf_ring_dread_lock(faux_buf_t *buf, size_t len,
+	struct iovec **iov_out, size_t *iov_num_out)
+{
+	size_t avail = 0;
+	size_t len_to_lock = 0;
+
+	// Don't use already locked buffer
+	if (faux_buf_is_rlocked(buf))
+		return -1;
+
+	avail = faux_buf_ring_len(buf);
+	len_to_lock = (len < avail) ? len : avail;
+	// Nothing to lock
+	if (0 == len_to_lock) {
+		*iov_out = NULL;
+		*iov_num_out = 0;
+		return 0;
+	}
+
+	*iov_num_out = faux_buf_ring_fill_iov(buf, buf->head, len_to_lock,
+		buf->riov);
+	*iov_out = buf->riov;
+	buf->rlocked = len_to_lock;
+
+	return len_to_lock;
+}
+
+
+/** @brief Locks continuous data for reading.
+ *
+ * See faux_buf_dread_lock_easy(). It's a consumer's operation.
+ */
+ssize_t faux_buf_ring_dread_lock_easy(faux_buf_t *buf, void **data)
+{
+	size_t avail = 0;
+	size_t offset = 0;
+	size_t len_to_lock = 0;
+
+	// Don't use already locked buffer
+	if (faux_buf_is_rlocked(buf))
+		return -1;
+
+	avail = faux_buf_ring_len(buf);
+	offset = buf->head & (buf->chunk_size - 1);
+	len_to_lock = buf->chunk_size - offset; // Continuous space
+	if (avail < len_to_lock)
+		len_to_lock = avail;
+	// Nothing to lock
+	if (0 == len_to_lock) {
+		*data = NULL;
+		return 0;
+	}
+
+	*data = buf->ring + offset;
+	buf->rlocked = len_to_lock;
+
+	return len_to_lock;
+}
+
+
+/** @brief Unlocks read data.
+ *
+ * See faux_buf_dread_unlock(). It's a consumer's operation. The space is
+ * returned to producer. The "struct iovec" array is a part of buffer object
+ * so it's not freed.
+ */
+ssize_t faux_buf_ring_dread_unlock(faux_buf_t *buf,
+	size_t really_readed, struct iovec *iov)
+{
+	iov = iov; // Happy compiler
+
+	// Can't unlock non-locked buffer
+	if (!faux_buf_is_rlocked(buf))
+		return -1;
+	if (buf->rlocked < really_readed)
+		return -1; // Something went wrong
+
+	STORE_POS(buf->head, buf->head + really_readed);
+
+	// Unlock whole buffer. Not 'really readed' bytes only
+	buf->rlocked = 0;
+
+	return really_readed;
+}
+
+
+/** @brief Acquires producer's side of buffer.
+ *
+ * Static function. The lock is held until data is unlocked.
+ *
+ * @param [in] buf Allocated and initialized buffer object.
+ */
+static void faux_buf_ring_wacquire(faux_buf_t *buf)
+{
+	if (FAUX_BUF_MPSC == buf->mode)
+		pthread_mutex_lock(&buf->wmutex);
+}
+
+
+/** @brief Releases producer's side of buffer.
+ *
+ * Static function.
+ *
+ * @param [in] buf Allocated and initialized buffer object.
+ */
+static void faux_buf_ring_wrelease(faux_buf_t *buf)
+{
+	if (FAUX_BUF_MPSC == buf->mode)
+		pthread_mutex_unlock(&buf->wmutex);
+}
+
+
+/** @brief Gets "struct iovec" array for direct writing and locks space.
+ *
+ * See faux_buf_dwrite_lock(). It's a producer's operation. The space is
+ * not visible for consumer until it's unlocked.
+ */
+ssize_t faux_buf_ring_dwrite_lock(faux_buf_t *buf, size_t len,
+	struct iovec **iov_out, size_t *iov_num_out)
+{
+	faux_buf_ring_wacquire(buf);
+
+	// Don't use already locked buffer
+	if (faux_buf_is_wlocked(buf))
+		goto error;
+	// It will be overflow after writing
+	if (faux_buf_will_be_overflow(buf, len))
+		goto error;
+	// Nothing to lock
+	if (0 == len) {
+		*iov_out = NULL;
+		*iov_num_out = 0;
+		faux_buf_ring_wrelease(buf);
+		return 0;
+	}
+
+	*iov_num_out = faux_buf_ring_fill_iov(buf, buf->tail, len, buf->wiov);
+	*iov_out = buf->wiov;
+	buf->wlocked = len;
+
+	return len;
+
+error:
+	faux_buf_ring_wrelease(buf);
+	return -1;
+}
+
+
+/** @brief Locks continuous space for writing.
+ *
+ * See faux_buf_dwrite_lock_easy(). It's a producer's operation.
+ */
+ssize_t faux_buf_ring_dwrite_lock_easy(faux_buf_t *buf, void **data)
+{
+	size_t space = 0;
+	size_t offset = 0;
+	size_t len_to_lock = 0;
+
+	faux_buf_ring_wacquire(buf);
+
+	// Don't use already locked buffer
+	if (faux_buf_is_wlocked(buf))
+		goto error;
+
+	space = buf->limit - faux_buf_ring_len(buf);
+	offset = buf->tail & (buf->chunk_size - 1);
+	len_to_lock = buf->chunk_size - offset; // Continuous space
+	if (space < len_to_lock)
+		len_to_lock = space;
+	// Buffer is full
+	if (0 == len_to_lock)
+		goto error;
+
+	*data = buf->ring + offset;
+	buf->wlocked = len_to_lock;
+
+	return len_to_lock;
+
+error:
+	faux_buf_ring_wrelease(buf);
+	return -1;
+}
+
+
+/** @brief Unlocks written data.
+ *
+ * See faux_buf_dwrite_unlock(). It's a producer's operation. The written
+ * data becomes visible for consumer. The "struct iovec" array is a part of
+ * buffer object so it's not freed. The producer's side is released on any
+ * path after successful lock. On error nothing is published.
+ */
+ssize_t faux_buf_ring_dwrite_unlock(faux_buf_t *buf,
+	size_t really_written, struct iovec *iov)
+{
+	ssize_t retval = really_written;
+
+	iov = iov; // Happy compiler
+
+	// Can't unlock non-locked buffer. The mutex is not held here
+	if (!faux_buf_is_wlocked(buf))
+		return -1;
+
+	if (buf->wlocked < really_written)
+		retval = -1; // Something went wrong
+	else
+		STORE_POS(buf->tail, buf->tail + really_written);
+
+	// Unlock whole buffer. Not 'really written' bytes only
+	buf->wlocked = 0;
+	faux_buf_ring_wrelease(buf);
+
+	return retval;
+}
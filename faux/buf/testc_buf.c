@@ -4,6 +4,10 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
 
 #include "faux/str.h"
 #include "faux/buf.h"
@@ -611,3 +615,168 @@ int testc_faux_buf_mass(void)
 
 	return 0;
 }
+
+
+#define RING_TOTAL (1024 * 1024)
+#define RING_PRODUCERS 4
+#define RING_RECORDS 20000
+
+typedef struct {
+	faux_buf_t *buf;
+	uint32_t id;
+} ring_producer_t;
+
+
+static void *ring_spsc_producer(void *arg)
+{
+	faux_buf_t *buf = (faux_buf_t *)arg;
+	size_t written = 0;
+	unsigned char chunk[333] = {};
+
+	while (written < RING_TOTAL) {
+		size_t len = (written % sizeof(chunk)) + 1;
+		size_t i = 0;
+		if (len > (RING_TOTAL - written))
+			len = RING_TOTAL - written;
+		for (i = 0; i < len; i++)
+			chunk[i] = (unsigned char)(written + i);
+		if (faux_buf_write(buf, chunk, len) < 0) {
+			sched_yield(); // Buffer is full
+			continue;
+		}
+		written += len;
+	}
+
+	return NULL;
+}
+
+
+static void *ring_mpsc_producer(void *arg)
+{
+	ring_producer_t *p = (ring_producer_t *)arg;
+	uint32_t rec[2] = {};
+
+	rec[0] = p->id;
+	while (rec[1] < RING_RECORDS) {
+		if (faux_buf_write(p->buf, rec, sizeof(rec)) < 0) {
+			sched_yield(); // Buffer is full
+			continue;
+		}
+		rec[1]++;
+	}
+
+	return NULL;
+}
+
+
+int testc_faux_buf_concurrent(void)
+{
+	faux_buf_t *buf = NULL;
+	pthread_t thread;
+	pthread_t threads[RING_PRODUCERS];
+	ring_producer_t producers[RING_PRODUCERS];
+	uint32_t expected[RING_PRODUCERS] = {};
+	struct iovec *iov = NULL;
+	size_t iov_num = 0;
+	size_t readed = 0;
+	size_t total = 0;
+	unsigned int i = 0;
+
+	// Size is rounded up to power of two
+	buf = faux_buf_new_concurrent(1000, FAUX_BUF_SPSC);
+	if (!buf) {
+		fprintf(stderr, "Can't create SPSC buffer\n");
+		return -1;
+	}
+	if (faux_buf_mode(buf) != FAUX_BUF_SPSC) {
+		fprintf(stderr, "Wrong buffer mode\n");
+		return -1;
+	}
+	if (faux_buf_limit(buf) != 1024) {
+		fprintf(stderr, "Wrong ring size %ld\n", faux_buf_limit(buf));
+		return -1;
+	}
+
+	// SPSC. Consumer uses direct access
+	pthread_create(&thread, NULL, ring_spsc_producer, buf);
+	while (readed < RING_TOTAL) {
+		unsigned char *data = NULL;
+		ssize_t len = faux_buf_dread_lock_easy(buf, (void **)&data);
+		ssize_t n = 0;
+		if (len < 0) {
+			fprintf(stderr, "faux_buf_dread_lock_easy() error\n");
+			return -1;
+		}
+		if (0 == len) {
+			sched_yield(); // Buffer is empty
+			continue;
+		}
+		for (n = 0; n < len; n++) {
+			if (data[n] != (unsigned char)(readed + n)) {
+				fprintf(stderr, "Wrong byte at %lu\n", readed + n);
+				return -1;
+			}
+		}
+		faux_buf_dread_unlock_easy(buf, len);
+		readed += len;
+	}
+	pthread_join(thread, NULL);
+	if (faux_buf_len(buf) != 0) {
+		fprintf(stderr, "SPSC buffer is not empty\n");
+		return -1;
+	}
+	faux_buf_free(buf);
+
+	// MPSC. Records from each producer must be ordered and unbroken
+	buf = faux_buf_new_concurrent(4096, FAUX_BUF_MPSC);
+	if (!buf) {
+		fprintf(stderr, "Can't create MPSC buffer\n");
+		return -1;
+	}
+	// Wrong unlock must release producer's side
+	if (faux_buf_dwrite_lock(buf, 16, &iov, &iov_num) != 16) {
+		fprintf(stderr, "faux_buf_dwrite_lock() error\n");
+		return -1;
+	}
+	if (faux_buf_dwrite_unlock(buf, 17, iov) >= 0) {
+		fprintf(stderr, "Wrong faux_buf_dwrite_unlock() success\n");
+		return -1;
+	}
+	if (faux_buf_dwrite_lock(buf, 16, &iov, &iov_num) != 16) {
+		fprintf(stderr, "Can't lock after wrong unlock\n");
+		return -1;
+	}
+	faux_buf_dwrite_unlock(buf, 0, iov);
+	if (faux_buf_len(buf) != 0) {
+		fprintf(stderr, "MPSC buffer is not empty\n");
+		return -1;
+	}
+	for (i = 0; i < RING_PRODUCERS; i++) {
+		producers[i].buf = buf;
+		producers[i].id = i;
+		pthread_create(&threads[i], NULL, ring_mpsc_producer,
+			&producers[i]);
+	}
+	while (total < (RING_PRODUCERS * RING_RECORDS)) {
+		uint32_t rec[2] = {};
+		if (faux_buf_len(buf) < (ssize_t)sizeof(rec)) {
+			sched_yield(); // No whole record
+			continue;
+		}
+		if (faux_buf_read(buf, rec, sizeof(rec)) != sizeof(rec)) {
+			fprintf(stderr, "faux_buf_read() error\n");
+			return -1;
+		}
+		if ((rec[0] >= RING_PRODUCERS) || (rec[1] != expected[rec[0]])) {
+			fprintf(stderr, "Wrong record %u:%u\n", rec[0], rec[1]);
+			return -1;
+		}
+		expected[rec[0]]++;
+		total++;
+	}
+	for (i = 0; i < RING_PRODUCERS; i++)
+		pthread_join(threads[i], NULL);
+	faux_buf_free(buf);
+
+	return 0;
+}
@@ -5,24 +5,54 @@
 #ifndef _faux_conv_h
 #define _faux_conv_h
 
+#include <time.h>
+
 #include <faux/faux.h>
 
+// Buffer sizes enough for any value including terminating '\0'
+#define FAUX_CONV_ULTOA_MAX 21 // 20 digits
+#define FAUX_CONV_LTOA_MAX 21 // Sign and 19 digits
+#define FAUX_CONV_HEX_MAX 17 // 16 digits without padding
+#define FAUX_CONV_TIMESPEC_MAX 32 // Seconds, dot and 9 digits
+
 C_DECL_BEGIN
 
 bool_t faux_conv_atol(const char *str, long int *val, int base);
+bool_t faux_conv_atol_n(const char *str, size_t len, long int *val, int base);
 bool_t faux_conv_atoul(const char *str, unsigned long int *val, int base);
+bool_t faux_conv_atoul_n(const char *str, size_t len, unsigned long int *val,
+	int base);
 
 bool_t faux_conv_atoll(const char *str, long long int *val, int base);
+bool_t faux_conv_atoll_n(const char *str, size_t len, long long int *val,
+	int base);
 bool_t faux_conv_atoull(const char *str, unsigned long long int *val, int base);
+bool_t faux_conv_atoull_n(const char *str, size_t len,
+	unsigned long long int *val, int base);
 
 bool_t faux_conv_atoi(const char *str, int *val, int base);
+bool_t faux_conv_atoi_n(const char *str, size_t len, int *val, int base);
 bool_t faux_conv_atoui(const char *str, unsigned int *val, int base);
+bool_t faux_conv_atoui_n(const char *str, size_t len, unsigned int *val,
+	int base);
 
 bool_t faux_conv_atos(const char *str, short *val, int base);
+bool_t faux_conv_atos_n(const char *str, size_t len, short *val, int base);
 bool_t faux_conv_atous(const char *str, unsigned short *val, int base);
+bool_t faux_conv_atous_n(const char *str, size_t len, unsigned short *val,
+	int base);
 
 bool_t faux_conv_atoc(const char *str, char *val, int base);
+bool_t faux_conv_atoc_n(const char *str, size_t len, char *val, int base);
 bool_t faux_conv_atouc(const char *str, unsigned char *val, int base);
+bool_t faux_conv_atouc_n(const char *str, size_t len, unsigned char *val,
+	int base);
+
+size_t faux_conv_ultoa(unsigned long long int val, char *buf, size_t size);
+size_t faux_conv_ltoa(long long int val, char *buf, size_t size);
+size_t faux_conv_hex(unsigned long long int val, unsigned int width,
+	char *buf, size_t size);
+size_t faux_conv_timespec(const struct timespec *ts, char *buf, size_t size);
 
 bool_t faux_conv_str2bool(const char *str, bool_t *val);
 const char *faux_conv_bool2str(bool_t val);
@@ -1,14 +1,255 @@
 /** @file conv.c
  * @brief Functions to convert from string to integer.
+ *
+ * The conversion functions have the same acceptance rules as strtol() family
+ * (leading spaces, optional sign, optional "0x" prefix for base 16 and 0,
+ * trailing garbage is ignored) but they don't use strtol() itself. The
+ * hand-written parser doesn't touch errno and converts eight decimal digits
+ * at once (SWAR) for long inputs. The "_n" variants don't need '\0'-terminated
+ * input.
  */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <limits.h>
 
 #include "faux/conv.h"
 #include "faux/str.h"
 
+// Parsing status
+typedef enum {
+	FAUX_CONV_FAIL, // No digits or illegal base
+	FAUX_CONV_OK,
+	FAUX_CONV_OVERFLOW // Value doesn't fit into 64 bits
+} faux_conv_status_e;
+
+// Digit values plus one for bases up to 36. 0 - not a digit
+static const unsigned char faux_conv_digit[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6,
+	['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15,
+	['f'] = 16, ['g'] = 17, ['h'] = 18, ['i'] = 19, ['j'] = 20,
+	['k'] = 21, ['l'] = 22, ['m'] = 23,
+	['n'] = 24, ['o'] = 25, ['p'] = 26, ['q'] = 27, ['r'] = 28,
+	['s'] = 29, ['t'] = 30, ['u'] = 31, ['v'] = 32, ['w'] = 33,
+	['x'] = 34, ['y'] = 35, ['z'] = 36,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15,
+	['F'] = 16, ['G'] = 17, ['H'] = 18, ['I'] = 19, ['J'] = 20,
+	['K'] = 21, ['L'] = 22, ['M'] = 23,
+	['N'] = 24, ['O'] = 25, ['P'] = 26, ['Q'] = 27, ['R'] = 28,
+	['S'] = 29, ['T'] = 30, ['U'] = 31, ['V'] = 32, ['W'] = 33,
+	['X'] = 34, ['Y'] = 35, ['Z'] = 36,
+	};
+
+// Digit value. Not a digit gives UINT_MAX
+#define DIGIT(c) ((unsigned int)faux_conv_digit[(unsigned char)(c)] - 1)
+
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define FAUX_CONV_SWAR 1
+
+/** @brief Checks if eight bytes are all decimal digits (SWAR).
+ *
+ * @param [in] v Eight bytes (little-endian load).
+ * @return BOOL_TRUE if all bytes are '0'...'9'.
+ */
+static inline bool_t faux_conv_is_8digits(uint64_t v)
+{
+	return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+		(((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+		0x3333333333333333ULL) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Converts eight decimal digits to integer (SWAR).
+ *
+ * @param [in] v Eight digits (little-endian load). The first digit is
+ * the most significant one.
+ * @return Integer value.
+ */
+static inline uint32_t faux_conv_parse_8digits(uint64_t v)
+{
+	const uint64_t mask = 0x000000FF000000FFULL;
+	const uint64_t mul1 = 100 + (1000000ULL << 32);
+	const uint64_t mul2 = 1 + (10000ULL << 32);
+
+	v -= 0x3030303030303030ULL;
+	v = (v * 10) + (v >> 8); // Pairs of digits
+	v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+
+	return (uint32_t)v;
+}
+#endif
+
+
+/** @brief Service static function to parse unsigned magnitude.
+ *
+ * Works like strtoull() but returns magnitude and sign separately and
+ * doesn't use errno. Input is limited by len and by '\0'.
+ *
+ * @param [in] str Input string.
+ * @param [in] len Max length of input.
+ * @param [in] base Base (0 or 2...36).
+ * @param [out] mag Magnitude.
+ * @param [out] neg Negative sign flag.
+ * @return Status of parsing.
+ */
+static faux_conv_status_e faux_conv_parse(const char *str, size_t len,
+	int base, uint64_t *mag, bool_t *neg)
+{
+	const char *p = str;
+	const char *end = NULL;
+	uint64_t res = 0;
+	bool_t overflow = BOOL_FALSE;
+	const char *digits = NULL;
+
+	if (!str)
+		return FAUX_CONV_FAIL;
+	if ((base != 0) && ((base < 2) || (base > 36)))
+		return FAUX_CONV_FAIL;
+	end = str + len;
+
+	// Spaces and sign
+	while ((p < end) && ((' ' == *p) || ((*p >= '\t') && (*p <= '\r'))))
+		p++;
+	*neg = BOOL_FALSE;
+	if ((p < end) && (('-' == *p) || ('+' == *p))) {
+		*neg = ('-' == *p) ? BOOL_TRUE : BOOL_FALSE;
+		p++;
+	}
+
+	// Prefix
+	if (((0 == base) || (16 == base)) && ((end - p) > 2) && ('0' == p[0]) &&
+		(('x' == p[1]) || ('X' == p[1])) && (DIGIT(p[2]) < 16)) {
+		p += 2;
+		base = 16;
+	} else if (0 == base) {
+		base = ((p < end) && ('0' == *p)) ? 8 : 10;
+	}
+
+	digits = p;
+#ifdef FAUX_CONV_SWAR
+	// Eight decimal digits at once
+	if (10 == base) {
+		while ((end - p) >= 8) {
+			uint64_t v = 0;
+			uint64_t tmp = 0;
+			memcpy(&v, p, sizeof(v));
+			if (!faux_conv_is_8digits(v))
+				break;
+			if (!overflow &&
+				(__builtin_mul_overflow(res, 100000000ULL, &tmp) ||
+				__builtin_add_overflow(tmp,
+				faux_conv_parse_8digits(v), &res)))
+				overflow = BOOL_TRUE;
+			p += 8;
+		}
+	}
+#endif
+	while (p < end) {
+		unsigned int d = DIGIT(*p);
+		uint64_t tmp = 0;
+		if (d >= (unsigned int)base) // Not digit or '\0'
+			break;
+		if (!overflow &&
+			(__builtin_mul_overflow(res, (uint64_t)base, &tmp) ||
+			__builtin_add_overflow(tmp, (uint64_t)d, &res)))
+			overflow = BOOL_TRUE;
+		p++;
+	}
+	if (p == digits) // No valid digits at all
+		return FAUX_CONV_FAIL;
+	if (overflow)
+		return FAUX_CONV_OVERFLOW;
+	*mag = res;
+
+	return FAUX_CONV_OK;
+}
+
+
+/** @brief Service static function to parse signed value.
+ *
+ * @param [in] str Input string.
+ * @param [in] len Max length of input.
+ * @param [in] base Base.
+ * @param [in] min Min value of type.
+ * @param [in] max Max value of type.
+ * @param [out] val Result.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_conv_parse_signed(const char *str, size_t len, int base,
+	long long int min, long long int max, long long int *val)
+{
+	uint64_t mag = 0;
+	bool_t neg = BOOL_FALSE;
+
+	if (faux_conv_parse(str, len, base, &mag, &neg) != FAUX_CONV_OK)
+		return BOOL_FALSE;
+	if (neg) {
+		if (mag > (uint64_t)(-(min + 1)) + 1)
+			return BOOL_FALSE;
+		*val = (0 == mag) ? 0 : (-(long long int)(mag - 1) - 1);
+	} else {
+		if (mag > (uint64_t)max)
+			return BOOL_FALSE;
+		*val = mag;
+	}
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Service static function to parse unsigned value.
+ *
+ * Like strtoul() negative value is negated in unsigned type.
+ *
+ * @param [in] str Input string.
+ * @param [in] len Max length of input.
+ * @param [in] base Base.
+ * @param [in] max Max value of type.
+ * @param [out] val Result.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_conv_parse_unsigned(const char *str, size_t len, int base,
+	unsigned long long int max, unsigned long long int *val)
+{
+	uint64_t mag = 0;
+	bool_t neg = BOOL_FALSE;
+
+	if (faux_conv_parse(str, len, base, &mag, &neg) != FAUX_CONV_OK)
+		return BOOL_FALSE;
+	if (mag > max)
+		return BOOL_FALSE;
+	*val = neg ? ((max - mag + 1) & max) : mag;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Converts length-bounded string to long int
+ *
+ * Works like faux_conv_atol() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atol_n(const char *str, size_t len, long int *val, int base)
+{
+	long long int tmp = 0;
+
+	if (!faux_conv_parse_signed(str, len, base, LONG_MIN, LONG_MAX, &tmp))
+		return BOOL_FALSE;
+	*val = tmp;
+
+	return BOOL_TRUE;
+}
+
 
 /** @brief Converts string to long int
  *
@@ -23,18 +264,29 @@
  */
 bool_t faux_conv_atol(const char *str, long int *val, int base)
 {
-	char *endptr = NULL;
-	long int res = 0;
+	return faux_conv_atol_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	errno = 0; // man recommends to do so
-	res = strtol(str, &endptr, base);
-	// Check for overflow
-	if (((LONG_MIN == res) || (LONG_MAX == res)) && (ERANGE == errno))
-		return BOOL_FALSE;
-	// No valid digits at all
-	if ((0 == res) && ((endptr == str) || (errno != 0)))
+
+/** @brief Converts length-bounded string to unsigned long int
+ *
+ * Works like faux_conv_atoul() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoul_n(const char *str, size_t len, unsigned long int *val,
+	int base)
+{
+	unsigned long long int tmp = 0;
+
+	if (!faux_conv_parse_unsigned(str, len, base, ULONG_MAX, &tmp))
 		return BOOL_FALSE;
-	*val = res;
+	*val = tmp;
 
 	return BOOL_TRUE;
 }
@@ -53,18 +305,29 @@ bool_t faux_conv_atol(const char *str, long int *val, int base)
  */
 bool_t faux_conv_atoul(const char *str, unsigned long int *val, int base)
 {
-	char *endptr = NULL;
-	unsigned long int res = 0;
+	return faux_conv_atoul_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	errno = 0; // man recommends to do so
-	res = strtoul(str, &endptr, base);
-	// Check for overflow
-	if ((ULONG_MAX == res) && (ERANGE == errno))
-		return BOOL_FALSE;
-	// No valid digits at all
-	if ((0 == res) && ((endptr == str) || (errno != 0)))
+
+/** @brief Converts length-bounded string to long long int
+ *
+ * Works like faux_conv_atoll() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoll_n(const char *str, size_t len, long long int *val,
+	int base)
+{
+	long long int tmp = 0;
+
+	if (!faux_conv_parse_signed(str, len, base, LLONG_MIN, LLONG_MAX, &tmp))
 		return BOOL_FALSE;
-	*val = res;
+	*val = tmp;
 
 	return BOOL_TRUE;
 }
@@ -83,18 +346,29 @@ bool_t faux_conv_atoul(const char *str, unsigned long int *val, int base)
  */
 bool_t faux_conv_atoll(const char *str, long long int *val, int base)
 {
-	char *endptr = NULL;
-	long long int res = 0;
+	return faux_conv_atoll_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	errno = 0; // man recommends to do so
-	res = strtoll(str, &endptr, base);
-	// Check for overflow
-	if (((LLONG_MIN == res) || (LLONG_MAX == res)) && (ERANGE == errno))
-		return BOOL_FALSE;
-	// No valid digits at all
-	if ((0 == res) && ((endptr == str) || (errno != 0)))
+
+/** @brief Converts length-bounded string to unsigned long long int
+ *
+ * Works like faux_conv_atoull() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoull_n(const char *str, size_t len,
+	unsigned long long int *val, int base)
+{
+	unsigned long long int tmp = 0;
+
+	if (!faux_conv_parse_unsigned(str, len, base, ULLONG_MAX, &tmp))
 		return BOOL_FALSE;
-	*val = res;
+	*val = tmp;
 
 	return BOOL_TRUE;
 }
@@ -113,18 +387,28 @@ bool_t faux_conv_atoll(const char *str, long long int *val, int base)
  */
 bool_t faux_conv_atoull(const char *str, unsigned long long int *val, int base)
 {
-	char *endptr = NULL;
-	unsigned long long int res = 0;
+	return faux_conv_atoull_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	errno = 0; // man recommends to do so
-	res = strtoull(str, &endptr, base);
-	// Check for overflow
-	if ((ULLONG_MAX == res) && (ERANGE == errno))
-		return BOOL_FALSE;
-	// No valid digits at all
-	if ((0 == res) && ((endptr == str) || (errno != 0)))
+
+/** @brief Converts length-bounded string to int
+ *
+ * Works like faux_conv_atoi() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoi_n(const char *str, size_t len, int *val, int base)
+{
+	long long int tmp = 0;
+
+	if (!faux_conv_parse_signed(str, len, base, INT_MIN, INT_MAX, &tmp))
 		return BOOL_FALSE;
-	*val = res;
+	*val = tmp;
 
 	return BOOL_TRUE;
 }
@@ -143,12 +427,30 @@ bool_t faux_conv_atoull(const char *str, unsigned long long int *val, int base)
  */
 bool_t faux_conv_atoi(const char *str, int *val, int base)
 {
-	long int tmp = 0;
+	return faux_conv_atoi_n(str, str ? strlen(str) : 0, val, base);
+}
+
+
+/** @brief Converts length-bounded string to unsigned int
+ *
+ * Works like faux_conv_atoui() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoui_n(const char *str, size_t len, unsigned int *val,
+	int base)
+{
+	unsigned long long int tmp = 0;
 
-	// Use existent func. The long int is longer or equal to int.
-	if (!faux_conv_atol(str, &tmp, base))
+	// Negative value is negated as unsigned long like strtoul() does
+	if (!faux_conv_parse_unsigned(str, len, base, ULONG_MAX, &tmp))
 		return BOOL_FALSE;
-	if ((tmp < INT_MIN) || (tmp > INT_MAX)) // Overflow
+	if (tmp > UINT_MAX) // Overflow
 		return BOOL_FALSE;
 	*val = tmp;
 
@@ -169,12 +471,26 @@ bool_t faux_conv_atoi(const char *str, int *val, int base)
  */
 bool_t faux_conv_atoui(const char *str, unsigned int *val, int base)
 {
-	unsigned long int tmp = 0;
+	return faux_conv_atoui_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	// Use existent func. The long int is longer or equal to int.
-	if (!faux_conv_atoul(str, &tmp, base))
-		return BOOL_FALSE;
-	if (tmp > UINT_MAX) // Overflow
+
+/** @brief Converts length-bounded string to short
+ *
+ * Works like faux_conv_atos() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atos_n(const char *str, size_t len, short *val, int base)
+{
+	long long int tmp = 0;
+
+	if (!faux_conv_parse_signed(str, len, base, SHRT_MIN, SHRT_MAX, &tmp))
 		return BOOL_FALSE;
 	*val = tmp;
 
@@ -195,11 +511,30 @@ bool_t faux_conv_atoui(const char *str, unsigned int *val, int base)
  */
 bool_t faux_conv_atos(const char *str, short *val, int base)
 {
-	long int tmp = 0;
+	return faux_conv_atos_n(str, str ? strlen(str) : 0, val, base);
+}
+
+
+/** @brief Converts length-bounded string to unsigned short
+ *
+ * Works like faux_conv_atous() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atous_n(const char *str, size_t len, unsigned short *val,
+	int base)
+{
+	unsigned long long int tmp = 0;
 
-	if (!faux_conv_atol(str, &tmp, base))
+	// Negative value is negated as unsigned long like strtoul() does
+	if (!faux_conv_parse_unsigned(str, len, base, ULONG_MAX, &tmp))
 		return BOOL_FALSE;
-	if ((tmp < SHRT_MIN) || (tmp > SHRT_MAX)) // Overflow
+	if (tmp > USHRT_MAX) // Overflow
 		return BOOL_FALSE;
 	*val = tmp;
 
@@ -220,11 +555,26 @@ bool_t faux_conv_atos(const char *str, short *val, int base)
  */
 bool_t faux_conv_atous(const char *str, unsigned short *val, int base)
 {
-	unsigned long int tmp = 0;
+	return faux_conv_atous_n(str, str ? strlen(str) : 0, val, base);
+}
 
-	if (!faux_conv_atoul(str, &tmp, base))
-		return BOOL_FALSE;
-	if (tmp > USHRT_MAX) // Overflow
+
+/** @brief Converts length-bounded string to char
+ *
+ * Works like faux_conv_atoc() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atoc_n(const char *str, size_t len, char *val, int base)
+{
+	long long int tmp = 0;
+
+	if (!faux_conv_parse_signed(str, len, base, CHAR_MIN, CHAR_MAX, &tmp))
 		return BOOL_FALSE;
 	*val = tmp;
 
@@ -245,11 +595,30 @@ bool_t faux_conv_atous(const char *str, unsigned short *val, int base)
  */
 bool_t faux_conv_atoc(const char *str, char *val, int base)
 {
-	long int tmp = 0;
+	return faux_conv_atoc_n(str, str ? strlen(str) : 0, val, base);
+}
+
 
-	if (!faux_conv_atol(str, &tmp, base))
+/** @brief Converts length-bounded string to unsigned char
+ *
+ * Works like faux_conv_atouc() but input string is not needed to be
+ * '\0'-terminated. No more than len bytes are analyzed.
+ *
+ * @param [in] str Input string to convert.
+ * @param [in] len Max length of input string.
+ * @param [out] val Pointer to result value.
+ * @param [in] base Base to convert.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error
+ */
+bool_t faux_conv_atouc_n(const char *str, size_t len, unsigned char *val,
+	int base)
+{
+	unsigned long long int tmp = 0;
+
+	// Negative value is negated as unsigned long like strtoul() does
+	if (!faux_conv_parse_unsigned(str, len, base, ULONG_MAX, &tmp))
 		return BOOL_FALSE;
-	if ((tmp < CHAR_MIN) || (tmp > CHAR_MAX)) // Overflow
+	if (tmp > UCHAR_MAX) // Overflow
 		return BOOL_FALSE;
 	*val = tmp;
 
@@ -270,15 +639,7 @@ bool_t faux_conv_atoc(const char *str, char *val, int base)
  */
 bool_t faux_conv_atouc(const char *str, unsigned char *val, int base)
 {
-	unsigned long int tmp = 0;
-
-	if (!faux_conv_atoul(str, &tmp, base))
-		return BOOL_FALSE;
-	if (tmp > UCHAR_MAX) // Overflow
-		return BOOL_FALSE;
-	*val = tmp;
-
-	return BOOL_TRUE;
+	return faux_conv_atouc_n(str, str ? strlen(str) : 0, val, base);
 }
 
 
@@ -0,0 +1,213 @@
+/** @file format.c
+ * @brief Functions to convert from integer to string.
+ *
+ * The formatting functions write the result to the caller's buffer and never
+ * allocate memory. They don't parse format string like sprintf() does.
+ * Decimal digits are produced two at a time using the table of digit pairs.
+ * All functions return the length of the resulting string (without the
+ * terminating '\0') or 0 if buffer is too small. The result is always
+ * '\0'-terminated on success.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+#include "faux/conv.h"
+
+static const char faux_conv_pairs[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char faux_conv_hexdigits[16] = "0123456789abcdef";
+
+
+/** @brief Gets number of decimal digits within value.
+ *
+ * @param [in] val Value.
+ * @return Number of digits.
+ */
+static unsigned int faux_conv_dec_len(unsigned long long int val)
+{
+	unsigned int len = 1;
+
+	for (;;) {
+		if (val < 10)
+			return len;
+		if (val < 100)
+			return len + 1;
+		if (val < 1000)
+			return len + 2;
+		if (val < 10000)
+			return len + 3;
+		val /= 10000;
+		len += 4;
+	}
+}
+
+
+/** @brief Writes exactly len decimal digits of value to the end of buffer.
+ *
+ * @param [in] val Value. Must fit into len digits.
+ * @param [in] end Pointer to the byte after the last digit.
+ * @param [in] len Number of digits to write. Leading zeros are added.
+ */
+static void faux_conv_dec_write(unsigned long long int val,
+	char *end, unsigned int len)
+{
+	char *p = end;
+
+	while (val >= 100) {
+		unsigned int i = (val % 100) * 2;
+		val /= 100;
+		*--p = faux_conv_pairs[i + 1];
+		*--p = faux_conv_pairs[i];
+	}
+	if (val >= 10) {
+		unsigned int i = val * 2;
+		*--p = faux_conv_pairs[i + 1];
+		*--p = faux_conv_pairs[i];
+	} else {
+		*--p = '0' + val;
+	}
+	while (p > end - len)
+		*--p = '0';
+}
+
+
+/** @brief Converts unsigned integer to decimal string.
+ *
+ * @param [in] val Value to convert.
+ * @param [out] buf Buffer for result. FAUX_CONV_ULTOA_MAX bytes is enough.
+ * @param [in] size Size of buffer.
+ * @return Length of string or 0 on error.
+ */
+size_t faux_conv_ultoa(unsigned long long int val, char *buf, size_t size)
+{
+	unsigned int len = 0;
+
+	assert(buf);
+	if (!buf)
+		return 0;
+
+	len = faux_conv_dec_len(val);
+	if (size < len + 1)
+		return 0;
+	faux_conv_dec_write(val, buf + len, len);
+	buf[len] = '\0';
+
+	return len;
+}
+
+
+/** @brief Converts signed integer to decimal string.
+ *
+ * @param [in] val Value to convert.
+ * @param [out] buf Buffer for result. FAUX_CONV_LTOA_MAX bytes is enough.
+ * @param [in] size Size of buffer.
+ * @return Length of string or 0 on error.
+ */
+size_t faux_conv_ltoa(long long int val, char *buf, size_t size)
+{
+	unsigned long long int mag = val;
+	size_t len = 0;
+
+	assert(buf);
+	if (!buf)
+		return 0;
+	if (val >= 0)
+		return faux_conv_ultoa(mag, buf, size);
+
+	if (size < 2)
+		return 0;
+	// Negation in unsigned type is safe for LLONG_MIN
+	len = faux_conv_ultoa(-mag, buf + 1, size - 1);
+	if (0 == len)
+		return 0;
+	buf[0] = '-';
+
+	return len + 1;
+}
+
+
+/** @brief Converts unsigned integer to lowercase hex string.
+ *
+ * No "0x" prefix is added. The result is padded by leading zeros to
+ * the specified width like printf("%0*llx") does.
+ *
+ * @param [in] val Value to convert.
+ * @param [in] width Minimal number of digits.
+ * @param [out] buf Buffer for result.
+ * @param [in] size Size of buffer.
+ * @return Length of string or 0 on error.
+ */
+size_t faux_conv_hex(unsigned long long int val, unsigned int width,
+	char *buf, size_t size)
+{
+	unsigned int len = 1;
+	char *p = NULL;
+
+	assert(buf);
+	if (!buf)
+		return 0;
+
+	while ((len < 16) && (val >> (len * 4)))
+		len++;
+	if (len < width)
+		len = width;
+	if (size < (size_t)len + 1)
+		return 0;
+	p = buf + len;
+	*p = '\0';
+	while (p > buf) {
+		*--p = faux_conv_hexdigits[val & 0xf];
+		val >>= 4;
+	}
+
+	return len;
+}
+
+
+/** @brief Converts timespec to string "sec.nsec".
+ *
+ * The nanoseconds part always has nine digits. Negative seconds are
+ * supported.
+ *
+ * @param [in] ts Timespec to convert.
+ * @param [out] buf Buffer for result. FAUX_CONV_TIMESPEC_MAX bytes is enough.
+ * @param [in] size Size of buffer.
+ * @return Length of string or 0 on error.
+ */
+size_t faux_conv_timespec(const struct timespec *ts, char *buf, size_t size)
+{
+	size_t len = 0;
+
+	assert(ts);
+	assert(buf);
+	if (!ts || !buf)
+		return 0;
+	if ((ts->tv_nsec < 0) || (ts->tv_nsec >= 1000000000l))
+		return 0;
+
+	len = faux_conv_ltoa(ts->tv_sec, buf, size);
+	if (0 == len)
+		return 0;
+	if (size < len + 1 + 9 + 1)
+		return 0;
+	buf[len] = '.';
+	faux_conv_dec_write(ts->tv_nsec, buf + len + 1 + 9, 9);
+	len += 1 + 9;
+	buf[len] = '\0';
+
+	return len;
+}
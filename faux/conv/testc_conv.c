@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+#include "faux/conv.h"
+
+
+// Reference implementation of faux_conv_atol() based on strtol()
+static bool_t ref_atol(const char *str, long int *val, int base)
+{
+	char *endptr = NULL;
+	long int res = 0;
+
+	errno = 0;
+	res = strtol(str, &endptr, base);
+	if (((LONG_MIN == res) || (LONG_MAX == res)) && (ERANGE == errno))
+		return BOOL_FALSE;
+	if ((0 == res) && ((endptr == str) || (errno != 0)))
+		return BOOL_FALSE;
+	*val = res;
+
+	return BOOL_TRUE;
+}
+
+
+// Reference implementation of faux_conv_atoull() based on strtoull()
+static bool_t ref_atoull(const char *str, unsigned long long int *val, int base)
+{
+	char *endptr = NULL;
+	unsigned long long int res = 0;
+
+	errno = 0;
+	res = strtoull(str, &endptr, base);
+	if ((ULLONG_MAX == res) && (ERANGE == errno))
+		return BOOL_FALSE;
+	if ((0 == res) && ((endptr == str) || (errno != 0)))
+		return BOOL_FALSE;
+	*val = res;
+
+	return BOOL_TRUE;
+}
+
+
+// Reference implementation of faux_conv_atoui() based on strtoul()
+static bool_t ref_atoui(const char *str, unsigned int *val, int base)
+{
+	char *endptr = NULL;
+	unsigned long int res = 0;
+
+	errno = 0;
+	res = strtoul(str, &endptr, base);
+	if ((ULONG_MAX == res) && (ERANGE == errno))
+		return BOOL_FALSE;
+	if ((0 == res) && ((endptr == str) || (errno != 0)))
+		return BOOL_FALSE;
+	if (res > UINT_MAX)
+		return BOOL_FALSE;
+	*val = res;
+
+	return BOOL_TRUE;
+}
+
+
+static int check_str(const char *str, int base)
+{
+	long int l1 = 0, l2 = 0;
+	unsigned long long int u1 = 0, u2 = 0;
+	unsigned int i1 = 0, i2 = 0;
+	bool_t r1 = BOOL_FALSE;
+	bool_t r2 = BOOL_FALSE;
+
+	r1 = faux_conv_atol(str, &l1, base);
+	r2 = ref_atol(str, &l2, base);
+	if ((r1 != r2) || (r1 && (l1 != l2))) {
+		printf("atol(\"%s\", %d): %d %ld, etalon %d %ld\n",
+			str, base, r1, l1, r2, l2);
+		return -1;
+	}
+	r1 = faux_conv_atoull(str, &u1, base);
+	r2 = ref_atoull(str, &u2, base);
+	if ((r1 != r2) || (r1 && (u1 != u2))) {
+		printf("atoull(\"%s\", %d): %d %llu, etalon %d %llu\n",
+			str, base, r1, u1, r2, u2);
+		return -1;
+	}
+	r1 = faux_conv_atoui(str, &i1, base);
+	r2 = ref_atoui(str, &i2, base);
+	if ((r1 != r2) || (r1 && (i1 != i2))) {
+		printf("atoui(\"%s\", %d): %d %u, etalon %d %u\n",
+			str, base, r1, i1, r2, i2);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_conv_ato(void)
+{
+	const char *strs[] = {
+		"0", "1", "-1", "+1", "  42", "\t\n-17", "12abc", "abc", "", " ",
+		"-", "+", "- 1", "0x", "0x1f", "0X1F", "-0x10", "0xg", "0x 1",
+		"010", "08", "0b101", "z", "Zz",
+		"9223372036854775807", "9223372036854775808",
+		"-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616",
+		"-18446744073709551615", "-18446744073709551616",
+		"4294967295", "4294967296", "-4294967295",
+		"0xffffffffffffffff", "0x10000000000000000",
+		"000000000000000000000000000000000000001",
+		"12345678", "123456789012345678", "1234567890123456789012",
+		"1234567a901234567890", "99999999999999999999999999999",
+		NULL
+		};
+	const int bases[] = {0, 2, 8, 10, 16, 36, 1, 37, -1};
+	unsigned int seed = 1;
+	unsigned int i = 0;
+	unsigned int b = 0;
+	long int l = 0;
+
+	for (i = 0; strs[i]; i++) {
+		for (b = 0; b < sizeof(bases) / sizeof(bases[0]); b++) {
+			if (check_str(strs[i], bases[b]) < 0)
+				return -1;
+		}
+	}
+
+	// Random strings of digits, signs and garbage
+	for (i = 0; i < 100000; i++) {
+		const char abc[] = "0123456789abcdefxX +-";
+		char str[32] = {};
+		unsigned int len = rand_r(&seed) % (sizeof(str) - 1);
+		unsigned int j = 0;
+		for (j = 0; j < len; j++) {
+			// Mostly decimal digits
+			if (rand_r(&seed) % 4)
+				str[j] = '0' + rand_r(&seed) % 10;
+			else
+				str[j] = abc[rand_r(&seed) % (sizeof(abc) - 1)];
+		}
+		if (check_str(str, (i % 2) ? 10 : 16) < 0)
+			return -1;
+		if (check_str(str, 0) < 0)
+			return -1;
+	}
+
+	// Length-bounded input
+	if (!faux_conv_atol_n("12345", 3, &l, 10) || (l != 123)) {
+		printf("Wrong length-bounded conversion\n");
+		return -1;
+	}
+	if (faux_conv_atol_n("12345", 0, &l, 10)) {
+		printf("Empty length-bounded input is converted\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_conv_atoull_rnd(void)
+{
+	char strs[1000][24] = {};
+	unsigned long long int sum1 = 0;
+	unsigned long long int sum2 = 0;
+	unsigned int seed = 1;
+	unsigned int i = 0;
+
+	for (i = 0; i < sizeof(strs) / sizeof(strs[0]); i++) {
+		unsigned long long int v = ((unsigned long long int)
+			rand_r(&seed) << 32) | rand_r(&seed);
+		v >>= rand_r(&seed) % 64; // Different lengths
+		snprintf(strs[i], sizeof(strs[i]), "%llu", v);
+	}
+
+	for (i = 0; i < sizeof(strs) / sizeof(strs[0]); i++) {
+		unsigned long long int v1 = 0;
+		unsigned long long int v2 = 0;
+		ref_atoull(strs[i], &v1, 10);
+		faux_conv_atoull(strs[i], &v2, 10);
+		sum1 += v1;
+		sum2 += v2;
+	}
+	if (sum1 != sum2) {
+		printf("Wrong result of conversion\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_conv_format(void)
+{
+	const long long int vals[] = {
+		0, 1, 9, 10, 99, 100, 999, 1000, 9999, 10000, 12345678,
+		4294967295LL, 4294967296LL, -1, -10, -99, -100,
+		LLONG_MAX, LLONG_MIN, LLONG_MIN + 1
+		};
+	char buf[FAUX_CONV_TIMESPEC_MAX] = {};
+	char etalon[FAUX_CONV_TIMESPEC_MAX] = {};
+	struct timespec ts = {};
+	unsigned int seed = 1;
+	unsigned int i = 0;
+	size_t len = 0;
+
+	for (i = 0; i < sizeof(vals) / sizeof(vals[0]) + 100000; i++) {
+		long long int v = 0;
+		unsigned int width = i % 17;
+		if (i < sizeof(vals) / sizeof(vals[0]))
+			v = vals[i];
+		else
+			v = (long long int)(((unsigned long long int)
+				rand_r(&seed) << 33) ^ ((unsigned long long int)
+				rand_r(&seed) << 2) ^ rand_r(&seed)) >>
+				(rand_r(&seed) % 64);
+
+		len = faux_conv_ltoa(v, buf, sizeof(buf));
+		snprintf(etalon, sizeof(etalon), "%lld", v);
+		if ((len != strlen(etalon)) || strcmp(buf, etalon)) {
+			printf("ltoa: %s, etalon %s\n", buf, etalon);
+			return -1;
+		}
+		len = faux_conv_ultoa(v, buf, sizeof(buf));
+		snprintf(etalon, sizeof(etalon), "%llu", (unsigned long long)v);
+		if ((len != strlen(etalon)) || strcmp(buf, etalon)) {
+			printf("ultoa: %s, etalon %s\n", buf, etalon);
+			return -1;
+		}
+		len = faux_conv_hex(v, width, buf, sizeof(buf));
+		snprintf(etalon, sizeof(etalon), "%0*llx", width,
+			(unsigned long long)v);
+		if ((len != strlen(etalon)) || strcmp(buf, etalon)) {
+			printf("hex: %s, etalon %s\n", buf, etalon);
+			return -1;
+		}
+		ts.tv_sec = v >> 2;
+		ts.tv_nsec = (unsigned long long)v % 1000000000ULL;
+		len = faux_conv_timespec(&ts, buf, sizeof(buf));
+		snprintf(etalon, sizeof(etalon), "%lld.%09ld",
+			(long long)ts.tv_sec, ts.tv_nsec);
+		if ((len != strlen(etalon)) || strcmp(buf, etalon)) {
+			printf("timespec: %s, etalon %s\n", buf, etalon);
+			return -1;
+		}
+	}
+
+	// Too short buffer
+	if (faux_conv_ultoa(12345, buf, 5) != 0) {
+		printf("Short buffer is not detected\n");
+		return -1;
+	}
+	if (faux_conv_ultoa(12345, buf, 6) != 5) {
+		printf("Exact buffer is not enough\n");
+		return -1;
+	}
+	if (faux_conv_ltoa(-1, buf, 2) != 0) {
+		printf("Short buffer for sign is not detected\n");
+		return -1;
+	}
+
+	return 0;
+}
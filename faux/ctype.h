@@ -1,5 +1,10 @@
 /** @file ctype.h
  * @brief Public interface for faux ctype functions.
+ *
+ * The functions are locale-free. They use ASCII semantics and give the same
+ * results as standard functions for the "C" locale. The functions are static
+ * inline and use constant table of character classes. The library contains
+ * external definitions of them too.
  */
 
 #ifndef _faux_ctype_h
@@ -9,15 +14,148 @@
 
 #include <faux/faux.h>
 
+// Character classes within faux_ctype_table[]
+#define FAUX_CTYPE_DIGIT 0x01
+#define FAUX_CTYPE_SPACE 0x02
+#define FAUX_CTYPE_XDIGIT 0x04
+#define FAUX_CTYPE_UPPER 0x20 // Equal to case bit of ASCII letter
+#define FAUX_CTYPE_LOWER 0x40 // Case bit shifted left by one
+
+// The functions are "static inline" so they don't depend on C99 or GNU
+// inline semantics. The ctype.c defines FAUX_CTYPE_EXTERN to get external
+// definitions of the same functions for the library.
+#ifdef FAUX_CTYPE_EXTERN
+#define FAUX_CTYPE_INLINE
+#else
+#define FAUX_CTYPE_INLINE static inline
+#endif
+
 C_DECL_BEGIN
 
+extern const unsigned char faux_ctype_table[256];
+
 // Classify functions
-bool_t faux_ctype_isdigit(char c);
-bool_t faux_ctype_isspace(char c);
+
+/** @brief Checks for a digit
+ *
+ * The function is same as standard isdigit() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is digit and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_isdigit(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_DIGIT) ?
+		BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Checks for a white space
+ *
+ * The function is same as standard isspace() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is space and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_isspace(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_SPACE) ?
+		BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Checks for a hexadecimal digit
+ *
+ * The function is same as standard isxdigit() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is hexadecimal digit and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_isxdigit(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_XDIGIT) ?
+		BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Checks for an uppercase letter
+ *
+ * The function is same as standard isupper() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is uppercase letter and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_isupper(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_UPPER) ?
+		BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Checks for a lowercase letter
+ *
+ * The function is same as standard islower() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is lowercase letter and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_islower(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_LOWER) ?
+		BOOL_TRUE : BOOL_FALSE;
+}
+
+
+/** @brief Checks for an alphabetic character
+ *
+ * The function is same as standard isalpha() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to classify.
+ * @return BOOL_TRUE if char is letter and BOOL_FALSE else.
+ */
+FAUX_CTYPE_INLINE bool_t faux_ctype_isalpha(char c)
+{
+	return (faux_ctype_table[(unsigned char)c] &
+		(FAUX_CTYPE_UPPER | FAUX_CTYPE_LOWER)) ? BOOL_TRUE : BOOL_FALSE;
+}
+
 
 // Convert functions
-char faux_ctype_tolower(char c);
-char faux_ctype_toupper(char c);
+
+/** @brief Converts uppercase characters to lowercase
+ *
+ * The function is same as standard tolower() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to convert.
+ * @return Converted character.
+ */
+FAUX_CTYPE_INLINE char faux_ctype_tolower(char c)
+{
+	// Set case bit for uppercase letters only
+	return c | (faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_UPPER);
+}
+
+
+/** @brief Converts lowercase characters to uppercase
+ *
+ * The function is same as standard toupper() for "C" locale but gets char
+ * type as an argument.
+ *
+ * @param [in] c Character to convert.
+ * @return Converted character.
+ */
+FAUX_CTYPE_INLINE char faux_ctype_toupper(char c)
+{
+	// Clear case bit for lowercase letters only
+	return c ^ ((faux_ctype_table[(unsigned char)c] & FAUX_CTYPE_LOWER) >> 1);
+}
 
 C_DECL_END
 
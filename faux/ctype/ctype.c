@@ -1,71 +1,37 @@
 /** @file ctype.c
  * @brief The ctype functions
  *
- * Some ctype functions are not compatible among different OSes.
- * So faux library functions use their own versions of some
- * ctype functions to unify the behaviour. Really for now all
- * faux ctype functions are only a wrappers for standard functions.
- * But it can be changed in future for portability purposes.
+ * Some ctype functions are not compatible among different OSes and depend
+ * on current locale. So faux library functions use their own versions of
+ * some ctype functions to unify the behaviour. The functions use ASCII
+ * semantics only (the same as "C" locale). The functions are defined
+ * static inline in header. This file contains the table of character classes
+ * and external definitions of the same functions.
  */
 
-#include <ctype.h>
-
+// Get external definitions of functions instead of static inline ones
+#define FAUX_CTYPE_EXTERN
 #include "faux/ctype.h"
 
-/** @brief Checks for a digit
- *
- * The function is same as standard isdigit() but gets char type
- * as an argument.
- *
- * @param [in] c Character to classify.
- * @return BOOL_TRUE if char is digit and BOOL_FALSE else.
- */
-bool_t faux_ctype_isdigit(char c)
-{
-	// isdigit() man says that argument must be unsigned char
-	return isdigit((unsigned char)c) ? BOOL_TRUE : BOOL_FALSE;
-}
-
-
-/** @brief Checks for a white space
- *
- * The function is same as standard isspace() but gets char type
- * as an argument.
- *
- * @param [in] c Character to classify.
- * @return BOOL_TRUE if char is space and BOOL_FALSE else.
- */
-bool_t faux_ctype_isspace(char c)
-{
-	// isspace() man says that argument must be unsigned char
-	return isspace((unsigned char)c) ? BOOL_TRUE : BOOL_FALSE;
-}
-
-
-/** @brief Converts uppercase characters to lowercase
- *
- * The function is same as standard tolower() but gets char type
- * as an argument.
- *
- * @param [in] c Character to convert.
- * @return Converted character.
- */
-char faux_ctype_tolower(char c)
-{
-	// tolower() man says that argument must be unsigned char
-	return tolower((unsigned char)c);
-}
-
-/** @brief Converts lowercase characters to uppercase
- *
- * The function is same as standard toupper() but gets char type
- * as an argument.
+/** @brief Character classes.
  *
- * @param [in] c Character to convert.
- * @return Converted character.
+ * Bytes 0x80-0xff don't belong to any class.
  */
-char faux_ctype_toupper(char c)
-{
-	// toupper() man says that argument must be unsigned char
-	return toupper((unsigned char)c);
-}
+const unsigned char faux_ctype_table[256] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x00
+	0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0x00, // 0x08
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x10
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x18
+	0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x20
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x28
+	0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, // 0x30
+	0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x38
+	0x00, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x20, // 0x40
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, // 0x48
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, // 0x50
+	0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x58
+	0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x40, // 0x60
+	0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, // 0x68
+	0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, // 0x70
+	0x40, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x78
+	};
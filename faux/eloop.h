@@ -5,6 +5,7 @@
 #ifndef _faux_eloop_h
 #define _faux_eloop_h
 
+#include <stdint.h>
 #include <poll.h>
 #include <signal.h>
 
@@ -20,6 +21,13 @@ typedef enum {
 	FAUX_ELOOP_FD = 3
 } faux_eloop_type_e;
 
+// Triggering mode of file descriptor registration. Modes can be combined.
+typedef enum {
+	FAUX_ELOOP_FD_LEVEL = 0x00, // Level-triggered (default)
+	FAUX_ELOOP_FD_EDGE = 0x01, // Edge-triggered
+	FAUX_ELOOP_FD_ONESHOT = 0x02 // Disarm after first event
+} faux_eloop_fd_mode_e;
+
 typedef struct {
 	int ev_id;
 	faux_ev_t *ev;
@@ -38,6 +46,33 @@ typedef struct {
 typedef bool_t (*faux_eloop_cb_fn)(faux_eloop_t *eloop, faux_eloop_type_e type,
 	void *associated_data, void *user_data);
 
+// Statistics for single registration (fd, signal or scheduled event ID)
+typedef struct {
+	faux_eloop_type_e type;
+	int id; // File descriptor, signal number or scheduled event ID
+	uint64_t dispatch_num; // Number of callback executions
+	uint64_t total_nsec; // Cumulative callback execution time
+	uint64_t max_nsec; // Maximal callback execution time
+} faux_eloop_cb_stat_t;
+
+// Snapshot of event loop statistics
+typedef struct {
+	uint64_t iteration_num; // Number of loop iterations
+	uint64_t timeout_num; // Number of wakeups by timeout
+	uint64_t lag_total_nsec; // Cumulative wakeup lag vs requested timeout
+	uint64_t lag_max_nsec; // Maximal wakeup lag
+	uint64_t ready_batch_num; // Number of wakeups by ready fds
+	uint64_t ready_fd_total; // Cumulative number of ready fds
+	unsigned int ready_fd_max; // Maximal number of ready fds at once
+	size_t cb_stat_num; // Number of items within cb_stat array
+	faux_eloop_cb_stat_t *cb_stat; // Per-registration statistics
+} faux_eloop_stat_t;
+
+// Slow callback hook prototype
+typedef void (*faux_eloop_slow_cb_fn)(faux_eloop_t *eloop,
+	faux_eloop_type_e type, int id, const struct timespec *duration,
+	void *user_data);
+
 
 C_DECL_BEGIN
 
@@ -47,6 +82,9 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop);
 
 bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 	faux_eloop_cb_fn event_cb, void *user_data);
+bool_t faux_eloop_add_fd_mode(faux_eloop_t *eloop, int fd, short events,
+	unsigned int mode, faux_eloop_cb_fn event_cb, void *user_data);
+bool_t faux_eloop_rearm_fd(faux_eloop_t *eloop, int fd, short events);
 bool_t faux_eloop_del_fd(faux_eloop_t *eloop, int fd);
 bool_t faux_eloop_del_fd_all(faux_eloop_t *eloop);
 
@@ -68,9 +106,19 @@ faux_ev_t *faux_eloop_add_sched_periodic_delayed(faux_eloop_t *eloop,
 ssize_t faux_eloop_del_sched(faux_eloop_t *eloop, faux_ev_t *ev);
 ssize_t faux_eloop_del_sched_by_id(faux_eloop_t *eloop, int ev_id);
 bool_t faux_eloop_del_sched_all(faux_eloop_t *eloop);
+bool_t faux_eloop_set_sched_slack(faux_eloop_t *eloop,
+	const struct timespec *slack);
 bool_t faux_eloop_include_fd_event(faux_eloop_t *eloop, int fd, short event);
 bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event);
 
+bool_t faux_eloop_set_stat(faux_eloop_t *eloop, bool_t enable);
+void faux_eloop_reset_stat(faux_eloop_t *eloop);
+faux_eloop_stat_t *faux_eloop_stat(const faux_eloop_t *eloop);
+void faux_eloop_stat_free(faux_eloop_stat_t *stat);
+bool_t faux_eloop_set_slow_cb(faux_eloop_t *eloop,
+	const struct timespec *threshold, faux_eloop_slow_cb_fn slow_cb,
+	void *user_data);
+
 C_DECL_END
 
 #endif
@@ -33,6 +33,7 @@
 
 #include "faux/faux.h"
 #include "faux/str.h"
+#include "faux/time.h"
 #include "faux/net.h"
 #include "faux/sched.h"
 #include "faux/eloop.h"
@@ -40,6 +41,7 @@
 #include "private.h"
 
 #define TIMESPEC_TO_MILISECONDS(t) ((t.tv_sec * 1000) + (t.tv_nsec / 1000000l))
+#define SCHED_BATCH_SIZE 64
 
 #ifdef HAVE_SIGNALFD
 #define SIGNALFD_FLAGS (SFD_NONBLOCK | SFD_CLOEXEC)
@@ -114,6 +116,237 @@ static int faux_eloop_signal_kcompare(const void *key, const void *list_item)
 }
 
 
+/** @brief Callback compare function for callback statistics list.
+ */
+static int faux_eloop_cb_stat_compare(const void *first, const void *second)
+{
+	const faux_eloop_cb_stat_t *f = (const faux_eloop_cb_stat_t *)first;
+	const faux_eloop_cb_stat_t *s = (const faux_eloop_cb_stat_t *)second;
+
+	// Don't subtract. Scheduled event ID can be any int so it can overflow
+	if (f->type != s->type)
+		return ((f->type < s->type) ? -1 : 1);
+
+	return ((f->id > s->id) - (f->id < s->id));
+}
+
+
+/** @brief Callback compare function for callback statistics list to search
+ * by key.
+ *
+ * The key is a faux_eloop_cb_stat_t structure with "type" and "id" fields
+ * filled.
+ */
+static int faux_eloop_cb_stat_kcompare(const void *key, const void *list_item)
+{
+	return faux_eloop_cb_stat_compare(key, list_item);
+}
+
+
+/** @brief Gets statistics record for registration.
+ *
+ * Static function. The record is found by type and ID or created. It's
+ * called on first dispatch while statistics is enabled. So registrations
+ * cost nothing when statistics is disabled. The registration stores the
+ * pointer to record so next dispatches update record without search.
+ * The record is referenced and must be released by
+ * faux_eloop_cb_rec_release().
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] type Type of event.
+ * @param [in] id File descriptor, signal number or scheduled event ID.
+ * @return Statistics record or NULL on error.
+ */
+static faux_eloop_cb_rec_t *faux_eloop_cb_rec_get(faux_eloop_t *eloop,
+	faux_eloop_type_e type, int id)
+{
+	faux_eloop_cb_stat_t key = {};
+	faux_eloop_cb_rec_t *cb_rec = NULL;
+
+	key.type = type;
+	key.id = id;
+	cb_rec = (faux_eloop_cb_rec_t *)faux_list_kfind(eloop->cb_stats, &key);
+	if (!cb_rec) {
+		cb_rec = faux_zmalloc(sizeof(*cb_rec));
+		if (!cb_rec)
+			return NULL;
+		cb_rec->stat.type = type;
+		cb_rec->stat.id = id;
+		cb_rec->eloop = eloop;
+		if (!faux_list_add(eloop->cb_stats, cb_rec)) {
+			faux_free(cb_rec);
+			return NULL;
+		}
+	}
+	cb_rec->ref_num++;
+
+	return cb_rec;
+}
+
+
+/** @brief Releases statistics record.
+ *
+ * Static function. The record is removed when the last registration that
+ * uses it is removed.
+ *
+ * @param [in] cb_rec Statistics record. Can be NULL.
+ */
+static void faux_eloop_cb_rec_release(faux_eloop_cb_rec_t *cb_rec)
+{
+	if (!cb_rec)
+		return;
+
+	cb_rec->ref_num--;
+	if (cb_rec->ref_num > 0)
+		return;
+	faux_list_kdel(cb_rec->eloop->cb_stats, &cb_rec->stat);
+}
+
+
+/** @brief Frees context of scheduled event.
+ *
+ * Static function. It's a callback to free event's data.
+ *
+ * @param [in] ptr Context.
+ */
+static void faux_eloop_context_free(void *ptr)
+{
+	faux_eloop_context_t *context = (faux_eloop_context_t *)ptr;
+
+	if (!context)
+		return;
+
+	faux_eloop_cb_rec_release(context->cb_rec);
+	faux_free(context);
+}
+
+
+/** @brief Frees registered fd entry.
+ *
+ * Static function. It's a callback to free list item.
+ *
+ * @param [in] ptr Registered fd entry.
+ */
+static void faux_eloop_fd_free(void *ptr)
+{
+	faux_eloop_fd_t *entry = (faux_eloop_fd_t *)ptr;
+
+	if (!entry)
+		return;
+
+	faux_eloop_cb_rec_release(entry->context.cb_rec);
+	faux_free(entry);
+}
+
+
+/** @brief Frees registered signal entry.
+ *
+ * Static function. It's a callback to free list item.
+ *
+ * @param [in] ptr Registered signal entry.
+ */
+static void faux_eloop_signal_free(void *ptr)
+{
+	faux_eloop_signal_t *entry = (faux_eloop_signal_t *)ptr;
+
+	if (!entry)
+		return;
+
+	faux_eloop_cb_rec_release(entry->context.cb_rec);
+	faux_free(entry);
+}
+
+
+/** @brief Returns armed events of registered fd.
+ *
+ * Static function.
+ *
+ * @param [in] entry Registered fd entry.
+ * @return Events mask to wait for.
+ */
+static short faux_eloop_fd_armed(const faux_eloop_fd_t *entry)
+{
+	return (entry->events & (~entry->disarmed));
+}
+
+
+/** @brief Checks if registered fd is temporarily removed from poll vector.
+ *
+ * Static function. The completely disarmed edge-triggered or one-shot fd
+ * can't stay within poll vector because poll() reports POLLHUP and POLLERR
+ * unconditionally. So such fd is parked until re-arm.
+ *
+ * @param [in] entry Registered fd entry.
+ * @return BOOL_TRUE - parked, BOOL_FALSE - within poll vector.
+ */
+static bool_t faux_eloop_fd_is_parked(const faux_eloop_fd_t *entry)
+{
+	if (FAUX_ELOOP_FD_LEVEL == entry->mode)
+		return BOOL_FALSE;
+	if (faux_eloop_fd_armed(entry) != 0)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Syncs poll vector item with registered fd state.
+ *
+ * Static function. Item is updated in place if possible.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] entry Registered fd entry.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_eloop_fd_sync(faux_eloop_t *eloop, faux_eloop_fd_t *entry)
+{
+	struct pollfd *pollfd = NULL;
+
+	pollfd = faux_pollfd_find(eloop->pollfds, entry->fd);
+
+	if (faux_eloop_fd_is_parked(entry)) {
+		if (pollfd)
+			faux_pollfd_del_by_fd(eloop->pollfds, entry->fd);
+		return BOOL_TRUE;
+	}
+
+	if (!pollfd) {
+		pollfd = faux_pollfd_add(eloop->pollfds, entry->fd,
+			faux_eloop_fd_armed(entry));
+		if (!pollfd)
+			return BOOL_FALSE;
+	}
+	pollfd->events = faux_eloop_fd_armed(entry);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Disarms fd events according to its triggering mode.
+ *
+ * Static function. It emulates epoll's EPOLLET and EPOLLONESHOT behaviour
+ * for poll(). The one-shot fd is disarmed completely. The edge-triggered
+ * fd disarms reported events only. The error conditions disarm all events
+ * of edge-triggered fd because poll() can't report them once.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] entry Registered fd entry.
+ * @param [in] revents Reported events.
+ */
+static void faux_eloop_fd_disarm(faux_eloop_t *eloop, faux_eloop_fd_t *entry,
+	short revents)
+{
+	if (entry->mode & FAUX_ELOOP_FD_ONESHOT)
+		entry->disarmed = entry->events;
+	else if (revents & (POLLERR | POLLHUP | POLLNVAL))
+		entry->disarmed = entry->events;
+	else
+		entry->disarmed |= (revents & entry->events);
+
+	faux_eloop_fd_sync(eloop, entry);
+}
+
+
 /** @brief Create new event loop object.
  *
  * Function gets default event callback as argument. It will be used for all
@@ -138,17 +371,20 @@ faux_eloop_t *faux_eloop_new(faux_eloop_cb_fn default_event_cb)
 	// Sched
 	eloop->sched = faux_sched_new();
 	assert(eloop->sched);
+	eloop->sched_batch = NULL;
+	eloop->sched_batch_len = 0;
 
 	// FD
 	eloop->fds = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
-		faux_eloop_fd_compare, faux_eloop_fd_kcompare, faux_free);
+		faux_eloop_fd_compare, faux_eloop_fd_kcompare, faux_eloop_fd_free);
 	assert(eloop->fds);
 	eloop->pollfds = faux_pollfd_new();
 	assert(eloop->pollfds);
 
 	// Signal
 	eloop->signals = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
-		faux_eloop_signal_compare, faux_eloop_signal_kcompare, faux_free);
+		faux_eloop_signal_compare, faux_eloop_signal_kcompare,
+		faux_eloop_signal_free);
 	assert(eloop->signals);
 	sigemptyset(&eloop->sig_set);
 	sigfillset(&eloop->sig_mask);
@@ -156,6 +392,17 @@ faux_eloop_t *faux_eloop_new(faux_eloop_cb_fn default_event_cb)
 	eloop->signal_fd = -1;
 #endif
 
+	// Instrumentation. Disabled by default
+	eloop->instrumented = BOOL_FALSE;
+	eloop->stat_enabled = BOOL_FALSE;
+	eloop->cb_stats = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_UNIQUE,
+		faux_eloop_cb_stat_compare, faux_eloop_cb_stat_kcompare,
+		faux_free);
+	assert(eloop->cb_stats);
+	eloop->slow_threshold = 0;
+	eloop->slow_cb = NULL;
+	eloop->slow_cb_data = NULL;
+
 	return eloop;
 }
 
@@ -173,11 +420,89 @@ void faux_eloop_free(faux_eloop_t *eloop)
 	faux_pollfd_free(eloop->pollfds);
 	faux_list_free(eloop->fds);
 	faux_sched_free(eloop->sched);
+	// Registrations release statistics records on freeing. So records
+	// list must be freed last.
+	faux_list_free(eloop->cb_stats);
 
 	faux_free(eloop);
 }
 
 
+/** @brief Accounts single callback execution within statistics.
+ *
+ * Static function.
+ *
+ * @param [in] cb_stat Statistics of registration. Can be NULL.
+ * @param [in] nsec Callback execution time in nanoseconds.
+ */
+static void faux_eloop_account_cb(faux_eloop_cb_stat_t *cb_stat, uint64_t nsec)
+{
+	if (!cb_stat)
+		return;
+
+	cb_stat->dispatch_num++;
+	cb_stat->total_nsec += nsec;
+	if (nsec > cb_stat->max_nsec)
+		cb_stat->max_nsec = nsec;
+}
+
+
+/** @brief Executes event callback.
+ *
+ * Static function. If instrumentation is enabled then function measures
+ * callback execution time, accounts it within statistics and calls slow
+ * callback hook if threshold is exceeded. Else it just calls callback.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] event_cb Callback to execute.
+ * @param [in] type Type of event.
+ * @param [in] id File descriptor, signal number or scheduled event ID.
+ * @param [in] info Associated data for callback.
+ * @param [in] user_data User data for callback.
+ * @param [in] context Context of registration.
+ * @return Callback's return value.
+ */
+static bool_t faux_eloop_exec_cb(faux_eloop_t *eloop, faux_eloop_cb_fn event_cb,
+	faux_eloop_type_e type, int id, void *info, void *user_data,
+	faux_eloop_context_t *context)
+{
+	struct timespec start = {};
+	struct timespec stop = {};
+	struct timespec duration = {};
+	uint64_t nsec = 0;
+	bool_t r = BOOL_TRUE;
+	faux_eloop_cb_rec_t *cb_rec = NULL;
+
+	if (!eloop->instrumented)
+		return event_cb(eloop, type, info, user_data);
+
+	// The callback can unregister itself and free context. So the record
+	// is referenced until callback execution is accounted.
+	if (eloop->stat_enabled) {
+		if (!context->cb_rec)
+			context->cb_rec = faux_eloop_cb_rec_get(eloop, type, id);
+		cb_rec = context->cb_rec;
+		if (cb_rec)
+			cb_rec->ref_num++;
+	}
+
+	faux_timespec_now_monotonic(&start);
+	r = event_cb(eloop, type, info, user_data);
+	faux_timespec_now_monotonic(&stop);
+	faux_timespec_diff(&duration, &stop, &start);
+	nsec = faux_timespec_to_nsec(&duration);
+
+	if (cb_rec) {
+		faux_eloop_account_cb(&cb_rec->stat, nsec);
+		faux_eloop_cb_rec_release(cb_rec);
+	}
+	if (eloop->slow_cb && (nsec >= eloop->slow_threshold))
+		eloop->slow_cb(eloop, type, id, &duration, eloop->slow_cb_data);
+
+	return r;
+}
+
+
 /** @brief Event loop function.
  *
  * Function blocks and waits for registered events. When event occurs the
@@ -258,6 +583,7 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 		int sn = 0;
 		struct timespec *timeout = NULL;
 		struct timespec next_interval = {};
+		struct timespec wait_start = {};
 		faux_pollfd_iterator_t pollfd_iter;
 		struct pollfd *pollfd = NULL;
 
@@ -267,6 +593,12 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 		else
 			timeout = &next_interval;
 
+		if (eloop->stat_enabled) {
+			eloop->stat.iteration_num++;
+			if (timeout)
+				faux_timespec_now_monotonic(&wait_start);
+		}
+
 		// Wait for events
 #ifdef HAVE_PPOLL
 		sn = ppoll(faux_pollfd_vector(eloop->pollfds),
@@ -288,39 +620,96 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 			break;
 		}
 
+		// Gather loop statistics
+		if (eloop->stat_enabled) {
+			if ((0 == sn) && timeout) {
+				struct timespec now = {};
+				struct timespec waited = {};
+				struct timespec lag = {};
+
+				eloop->stat.timeout_num++;
+				faux_timespec_now_monotonic(&now);
+				faux_timespec_diff(&waited, &now, &wait_start);
+				// Woken up later than requested
+				if (faux_timespec_diff(&lag, &waited, timeout)) {
+					uint64_t lag_nsec = faux_timespec_to_nsec(&lag);
+					eloop->stat.lag_total_nsec += lag_nsec;
+					if (lag_nsec > eloop->stat.lag_max_nsec)
+						eloop->stat.lag_max_nsec = lag_nsec;
+				}
+			} else if (sn > 0) {
+				eloop->stat.ready_batch_num++;
+				eloop->stat.ready_fd_total += sn;
+				if ((unsigned int)sn > eloop->stat.ready_fd_max)
+					eloop->stat.ready_fd_max = sn;
+			}
+		}
+
 		// Scheduled event
 		if (0 == sn) {
-			faux_ev_t *ev = NULL;
-
-			// Some scheduled events
-			while((ev = faux_sched_pop(eloop->sched))) {
-				faux_eloop_info_sched_t info = {};
-				bool_t r = BOOL_TRUE;
-				int ev_id = faux_ev_id(ev);
-				faux_eloop_context_t *context =
-					(faux_eloop_context_t *)faux_ev_data(ev);
-				faux_eloop_cb_fn event_cb = context->event_cb;
-				void *user_data = context->user_data;
-
-				if (!faux_ev_is_busy(ev)) {
-					faux_ev_free(ev);
-					ev = NULL;
+			faux_ev_t *batch[SCHED_BATCH_SIZE];
+			ssize_t batch_len = 0;
+
+			// Some scheduled events. Pop them by batches.
+			do {
+				ssize_t i = 0;
+
+				batch_len = faux_sched_pop_batch(eloop->sched,
+					batch, SCHED_BATCH_SIZE);
+				if (batch_len <= 0)
+					break;
+				// Callbacks can delete events of batch. See
+				// faux_eloop_forget_batch().
+				eloop->sched_batch = batch;
+				eloop->sched_batch_len = batch_len;
+				for (i = 0; i < batch_len; i++) {
+					faux_ev_t *ev = batch[i];
+					faux_ev_t *done = NULL; // Not rescheduled
+					faux_eloop_info_sched_t info = {};
+					bool_t r = BOOL_TRUE;
+					int ev_id = 0;
+					faux_eloop_context_t *context = NULL;
+					faux_eloop_cb_fn event_cb = NULL;
+					void *user_data = NULL;
+
+					if (!ev) // Deleted by previous callback
+						continue;
+					batch[i] = NULL;
+					ev_id = faux_ev_id(ev);
+					context = (faux_eloop_context_t *)faux_ev_data(ev);
+					event_cb = context->event_cb;
+					user_data = context->user_data;
+
+					// Not rescheduled event is owned by event
+					// loop. It's freed after callback execution
+					// because context is needed while execution.
+					if (!faux_ev_is_busy(ev)) {
+						done = ev;
+						ev = NULL;
+					}
+					if (!event_cb)
+						event_cb = eloop->default_event_cb;
+					if (!event_cb) { // Callback is not defined
+						faux_ev_free(done);
+						continue;
+					}
+					info.ev_id = ev_id;
+					// Callback will get only rescheduled event
+					// object. If event is not scheduled, callback
+					// will get NULL.
+					info.ev = ev;
+					// Execute callback
+					r = faux_eloop_exec_cb(eloop, event_cb,
+						FAUX_ELOOP_SCHED, ev_id, &info,
+						user_data, context);
+					faux_ev_free(done);
+					// BOOL_FALSE return value means "break the loop"
+					if (!r)
+						stop = BOOL_TRUE;
 				}
-				if (!event_cb)
-					event_cb = eloop->default_event_cb;
-				if (!event_cb) // Callback is not defined
-					continue;
-				info.ev_id = ev_id;
-				// Callback will get only rescheduled event object.
-				// If event is not scheduled, callback will get NULL.
-				info.ev = ev;
-				// Execute callback
-				r = event_cb(eloop, FAUX_ELOOP_SCHED, &info,
-					user_data);
-				// BOOL_FALSE return value means "break the loop"
-				if (!r)
-					stop = BOOL_TRUE;
-			}
+				eloop->sched_batch = NULL;
+				eloop->sched_batch_len = 0;
+			} while (SCHED_BATCH_SIZE == batch_len);
 			continue;
 		}
 
@@ -362,8 +751,10 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 					sinfo.signo = signo;
 
 					// Execute callback
-					r = event_cb(eloop, FAUX_ELOOP_SIGNAL, &sinfo,
-						sentry->context.user_data);
+					r = faux_eloop_exec_cb(eloop, event_cb,
+						FAUX_ELOOP_SIGNAL, signo, &sinfo,
+						sentry->context.user_data,
+						&sentry->context);
 					// BOOL_FALSE return value means "break the loop"
 					if (!r)
 						stop = BOOL_TRUE;
@@ -384,11 +775,24 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 			info.fd = fd;
 			info.revents = pollfd->revents;
 
+			// Disarm reported events before callback execution so
+			// callback can re-arm fd
+			if (entry->mode != FAUX_ELOOP_FD_LEVEL)
+				faux_eloop_fd_disarm(eloop, entry, info.revents);
+
 			// Execute callback
-			r = event_cb(eloop, FAUX_ELOOP_FD, &info, entry->context.user_data);
+			r = faux_eloop_exec_cb(eloop, event_cb, FAUX_ELOOP_FD, fd,
+				&info, entry->context.user_data,
+				&entry->context);
 			// BOOL_FALSE return value means "break the loop"
 			if (!r)
 				stop = BOOL_TRUE;
+
+			// Current item can be removed from poll vector by
+			// disarming or by callback. Don't skip next item.
+			pollfd = faux_pollfd_item(eloop->pollfds, pollfd_iter - 1);
+			if (!pollfd || (pollfd->fd != fd))
+				pollfd_iter--;
 		}
 
 	} // Loop end
@@ -429,6 +833,7 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
 /** @brief Registers file descriptor to wait for events.
  *
  * See poll() for explanation of possible file events ("events" argument).
+ * The fd is level-triggered. See faux_eloop_add_fd_mode().
  *
  * @param [in] eloop Allocated and initialized event loop object.
  * @param [in] fd File descriptor to wait on.
@@ -439,6 +844,35 @@ bool_t faux_eloop_loop(faux_eloop_t *eloop)
  */
 bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 	faux_eloop_cb_fn event_cb, void *user_data)
+{
+	return faux_eloop_add_fd_mode(eloop, fd, events, FAUX_ELOOP_FD_LEVEL,
+		event_cb, user_data);
+}
+
+
+/** @brief Registers file descriptor with specified triggering mode.
+ *
+ * The level-triggered fd (FAUX_ELOOP_FD_LEVEL) reports events while condition
+ * exists. The edge-triggered fd (FAUX_ELOOP_FD_EDGE) disarms reported events
+ * before callback execution. So callback will not be called again and again
+ * for the same condition. For example writer can keep POLLOUT registered
+ * and re-arm it by faux_eloop_rearm_fd() when write() returns EAGAIN. The
+ * one-shot fd (FAUX_ELOOP_FD_ONESHOT) disarms all events after first reported
+ * one. The faux_eloop_rearm_fd() re-arms events.
+ *
+ * The event loop uses poll() so edge-triggered and one-shot modes are
+ * emulated by interest mask updates within event loop itself.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to wait on.
+ * @param [in] events File events mask like POLLIN, POLLOUT.
+ * @param [in] mode Triggering mode. See faux_eloop_fd_mode_e.
+ * @param [in] event_cb Callback for event.
+ * @param [in] user_data User data to pass to callback.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_add_fd_mode(faux_eloop_t *eloop, int fd, short events,
+	unsigned int mode, faux_eloop_cb_fn event_cb, void *user_data)
 {
 	faux_eloop_fd_t *entry = NULL;
 	faux_list_node_t *new_node = NULL;
@@ -452,17 +886,19 @@ bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 		return BOOL_FALSE;
 	entry->fd = fd;
 	entry->events = events;
+	entry->disarmed = 0;
+	entry->mode = mode;
 	entry->context.event_cb = event_cb;
 	entry->context.user_data = user_data;
+	entry->context.cb_rec = NULL;
 
 	if (!(new_node = faux_list_add(eloop->fds, entry))) {
 		faux_free(entry);
 		return BOOL_FALSE;
 	}
 
-	if (!faux_pollfd_add(eloop->pollfds, entry->fd, entry->events)) {
+	if (!faux_eloop_fd_sync(eloop, entry)) {
 		faux_list_del(eloop->fds, new_node);
-		faux_free(entry);
 		return BOOL_FALSE;
 	}
 
@@ -470,6 +906,41 @@ bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
 }
 
 
+/** @brief Re-arms events of edge-triggered or one-shot fd.
+ *
+ * The events disarmed by edge-triggered or one-shot mode will be reported
+ * again. It's cheap operation so it can be called on every EAGAIN. The
+ * level-triggered fd has no disarmed events.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] fd File descriptor to re-arm.
+ * @param [in] events Events to re-arm. The 0 means all registered events.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_rearm_fd(faux_eloop_t *eloop, int fd, short events)
+{
+	faux_eloop_fd_t *entry = NULL;
+
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+	assert(fd >= 0);
+	if (fd < 0)
+		return BOOL_FALSE;
+
+	entry = (faux_eloop_fd_t *)faux_list_kfind(eloop->fds, &fd);
+	if (!entry)
+		return BOOL_FALSE;
+	if (0 == events)
+		events = entry->events;
+	if (0 == (entry->disarmed & events)) // Already armed
+		return BOOL_TRUE;
+	entry->disarmed = entry->disarmed & (~events);
+
+	return faux_eloop_fd_sync(eloop, entry);
+}
+
+
 /** @brief Registers additional event for specified fd.
  *
  * See poll() for explanation of possible file events ("events" argument).
@@ -478,7 +949,7 @@ bool_t faux_eloop_add_fd(faux_eloop_t *eloop, int fd, short events,
  * necessary to remove fd by faux_eloop_del_fd() and then re-add it with new
  * event mask. User can include additional events by
  * faux_eloop_include_fd_event(). Specified event will be added to existent
- * event mask.
+ * event mask. The included event is armed for edge-triggered and one-shot fd.
  *
  * @param [in] eloop Allocated and initialized event loop object.
  * @param [in] fd File descriptor to change event mask.
@@ -500,10 +971,9 @@ bool_t faux_eloop_include_fd_event(faux_eloop_t *eloop, int fd, short event)
 	if (!entry)
 		return BOOL_FALSE;
 	entry->events = entry->events | event;
-	faux_pollfd_del_by_fd(eloop->pollfds, fd);
-	faux_pollfd_add(eloop->pollfds, fd, entry->events);
+	entry->disarmed = entry->disarmed & (~event);
 
-	return BOOL_TRUE;
+	return faux_eloop_fd_sync(eloop, entry);
 }
 
 
@@ -537,10 +1007,9 @@ bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event)
 	if (!entry)
 		return BOOL_FALSE;
 	entry->events = entry->events & (~event);
-	faux_pollfd_del_by_fd(eloop->pollfds, fd);
-	faux_pollfd_add(eloop->pollfds, fd, entry->events);
+	entry->disarmed = entry->disarmed & entry->events;
 
-	return BOOL_TRUE;
+	return faux_eloop_fd_sync(eloop, entry);
 }
 
 
@@ -552,13 +1021,22 @@ bool_t faux_eloop_exclude_fd_event(faux_eloop_t *eloop, int fd, short event)
  */
 bool_t faux_eloop_del_fd(faux_eloop_t *eloop, int fd)
 {
+	faux_eloop_fd_t *entry = NULL;
+	bool_t parked = BOOL_FALSE;
+
 	if (!eloop || (fd < 0))
 		return BOOL_FALSE;
 
+	entry = (faux_eloop_fd_t *)faux_list_kfind(eloop->fds, &fd);
+	if (!entry)
+		return BOOL_FALSE;
+	// Parked fd is not within poll vector
+	parked = faux_eloop_fd_is_parked(entry);
+
 	if (!faux_list_kdel(eloop->fds, &fd))
 		return BOOL_FALSE;
 
-	if (!faux_pollfd_del_by_fd(eloop->pollfds, fd))
+	if (!faux_pollfd_del_by_fd(eloop->pollfds, fd) && !parked)
 		return BOOL_FALSE;
 
 	return BOOL_TRUE;
@@ -627,6 +1105,7 @@ bool_t faux_eloop_add_signal(faux_eloop_t *eloop, int signo,
 	entry->signo = signo;
 	entry->context.event_cb = event_cb;
 	entry->context.user_data = user_data;
+	entry->context.cb_rec = NULL;
 
 	if (!faux_list_add(eloop->signals, entry)) {
 		faux_free(entry);
@@ -714,7 +1193,7 @@ bool_t faux_eloop_del_signal_all(faux_eloop_t *eloop)
 }
 
 
-/** @brief Service function to create new context for event.
+/** @brief Service function to create new context for scheduled event.
  *
  * @param [in] event_cb Callback for event.
  * @param [in] data User data for event.
@@ -732,11 +1211,54 @@ static faux_eloop_context_t *faux_eloop_new_context(
 
 	context->event_cb = event_cb;
 	context->user_data = data;
+	context->cb_rec = NULL;
 
 	return context;
 }
 
 
+/** @brief Removes events from the batch that is dispatching now.
+ *
+ * Static function. The event loop pops scheduled events by batches. So
+ * callback can delete event that is already popped but not dispatched yet.
+ * Such event must be removed from the batch. The not rescheduled events
+ * (not busy) are owned by event loop so they are freed here. The busy
+ * events are deleted by scheduler.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] ev Event to remove. NULL means "any event".
+ * @param [in] ev_id Pointer to event ID to remove. NULL means "any ID".
+ * @return Number of freed (not busy) events.
+ */
+static ssize_t faux_eloop_forget_batch(faux_eloop_t *eloop,
+	const faux_ev_t *ev, const int *ev_id)
+{
+	size_t i = 0;
+	ssize_t freed = 0;
+
+	if (!eloop->sched_batch)
+		return 0;
+
+	for (i = 0; i < eloop->sched_batch_len; i++) {
+		faux_ev_t *item = eloop->sched_batch[i];
+
+		if (!item)
+			continue;
+		if (ev && (item != ev))
+			continue;
+		if (ev_id && (faux_ev_id(item) != *ev_id))
+			continue;
+		eloop->sched_batch[i] = NULL;
+		if (!faux_ev_is_busy(item)) {
+			faux_ev_free(item);
+			freed++;
+		}
+	}
+
+	return freed;
+}
+
+
 /** @brief Registers scheduled time event. See faux_sched_once().
  *
  * @param [in] eloop Allocated and initialized event loop object.
@@ -765,7 +1287,7 @@ faux_ev_t *faux_eloop_add_sched_once(faux_eloop_t *eloop, const struct timespec
 		faux_free(context);
 		return NULL;
 	}
-	faux_ev_set_free_data_cb(ev, faux_free);
+	faux_ev_set_free_data_cb(ev, faux_eloop_context_free);
 
 	return ev;
 }
@@ -799,7 +1321,7 @@ faux_ev_t *faux_eloop_add_sched_once_delayed(faux_eloop_t *eloop, const struct t
 		faux_free(context);
 		return NULL;
 	}
-	faux_ev_set_free_data_cb(ev, faux_free);
+	faux_ev_set_free_data_cb(ev, faux_eloop_context_free);
 
 	return ev;
 }
@@ -837,7 +1359,7 @@ faux_ev_t *faux_eloop_add_sched_periodic(faux_eloop_t *eloop, const struct times
 		faux_free(context);
 		return NULL;
 	}
-	faux_ev_set_free_data_cb(ev, faux_free);
+	faux_ev_set_free_data_cb(ev, faux_eloop_context_free);
 
 	return ev;
 }
@@ -874,7 +1396,7 @@ faux_ev_t *faux_eloop_add_sched_periodic_delayed(faux_eloop_t *eloop,
 		faux_free(context);
 		return NULL;
 	}
-	faux_ev_set_free_data_cb(ev, faux_free);
+	faux_ev_set_free_data_cb(ev, faux_eloop_context_free);
 
 	return ev;
 }
@@ -888,10 +1410,18 @@ faux_ev_t *faux_eloop_add_sched_periodic_delayed(faux_eloop_t *eloop,
  */
 ssize_t faux_eloop_del_sched(faux_eloop_t *eloop, faux_ev_t *ev)
 {
+	ssize_t freed = 0;
+
 	assert(eloop);
 	if (!eloop)
 		return -1;
 
+	if (!ev)
+		return 0;
+	freed = faux_eloop_forget_batch(eloop, ev, NULL);
+	if (freed > 0) // Event is not within scheduler
+		return freed;
+
 	return faux_sched_del(eloop->sched, ev);
 }
 
@@ -907,12 +1437,33 @@ bool_t faux_eloop_del_sched_all(faux_eloop_t *eloop)
 	if (!eloop)
 		return BOOL_FALSE;
 
+	faux_eloop_forget_batch(eloop, NULL, NULL);
 	faux_sched_del_all(eloop->sched);
 
 	return BOOL_TRUE;
 }
 
 
+/** @brief Sets default slack for scheduled time events.
+ *
+ * See faux_sched_set_slack(). Slack allows to coalesce wakeups for events
+ * with near deadlines. Event's own slack can be set by faux_ev_set_slack().
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] slack Slack value. NULL - zero slack.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_set_sched_slack(faux_eloop_t *eloop,
+	const struct timespec *slack)
+{
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	return faux_sched_set_slack(eloop->sched, slack);
+}
+
+
 /** @brief Unregisters scheduled time event by event ID.
  *
  * @param [in] eloop Allocated and initialized event loop object.
@@ -921,9 +1472,169 @@ bool_t faux_eloop_del_sched_all(faux_eloop_t *eloop)
  */
 ssize_t faux_eloop_del_sched_by_id(faux_eloop_t *eloop, int ev_id)
 {
+	ssize_t freed = 0;
+	ssize_t deleted = 0;
+
 	assert(eloop);
 	if (!eloop)
 		return -1;
 
-	return faux_sched_del_by_id(eloop->sched, ev_id);
+	freed = faux_eloop_forget_batch(eloop, NULL, &ev_id);
+	deleted = faux_sched_del_by_id(eloop->sched, ev_id);
+	if (deleted < 0)
+		return deleted;
+
+	return (freed + deleted);
+}
+
+
+/** @brief Enables or disables statistics gathering.
+ *
+ * When statistics is enabled the event loop counts loop iterations, wakeup
+ * lag (the time the loop was woken up later than requested timeout), number
+ * of ready file descriptors per wakeup and per-registration callback
+ * execution time. The disabled statistics costs nothing. The previously
+ * gathered data is not removed on disabling. Use faux_eloop_reset_stat() to
+ * clear it.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] enable BOOL_TRUE - enable, BOOL_FALSE - disable.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_set_stat(faux_eloop_t *eloop, bool_t enable)
+{
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	eloop->stat_enabled = enable;
+	eloop->instrumented = (eloop->stat_enabled || eloop->slow_cb) ?
+		BOOL_TRUE : BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Clears gathered statistics.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ */
+void faux_eloop_reset_stat(faux_eloop_t *eloop)
+{
+	faux_list_node_t *iter = NULL;
+	faux_eloop_cb_rec_t *cb_rec = NULL;
+
+	assert(eloop);
+	if (!eloop)
+		return;
+
+	faux_bzero(&eloop->stat, sizeof(eloop->stat));
+	// Registrations point to records so clear counters only
+	iter = faux_list_head(eloop->cb_stats);
+	while ((cb_rec = (faux_eloop_cb_rec_t *)faux_list_each(&iter))) {
+		cb_rec->stat.dispatch_num = 0;
+		cb_rec->stat.total_nsec = 0;
+		cb_rec->stat.max_nsec = 0;
+	}
+}
+
+
+/** @brief Gets snapshot of gathered statistics.
+ *
+ * The per-registration statistics is an array ordered by type and then by
+ * ID. Only registrations with executed callbacks are included. Statistics
+ * of fd, signal or scheduled event ID is removed with the last registration
+ * of it.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @return Allocated statistics snapshot or NULL on error.
+ * @warning The returned snapshot must be freed by faux_eloop_stat_free().
+ */
+faux_eloop_stat_t *faux_eloop_stat(const faux_eloop_t *eloop)
+{
+	faux_eloop_stat_t *stat = NULL;
+	faux_list_node_t *iter = NULL;
+	faux_eloop_cb_rec_t *cb_rec = NULL;
+	size_t i = 0;
+
+	assert(eloop);
+	if (!eloop)
+		return NULL;
+
+	stat = faux_zmalloc(sizeof(*stat));
+	assert(stat);
+	if (!stat)
+		return NULL;
+	*stat = eloop->stat;
+	stat->cb_stat_num = 0;
+	stat->cb_stat = NULL;
+	iter = faux_list_head(eloop->cb_stats);
+	while ((cb_rec = (faux_eloop_cb_rec_t *)faux_list_each(&iter))) {
+		if (cb_rec->stat.dispatch_num > 0)
+			stat->cb_stat_num++;
+	}
+	if (0 == stat->cb_stat_num)
+		return stat;
+
+	stat->cb_stat = faux_zmalloc(
+		stat->cb_stat_num * sizeof(*stat->cb_stat));
+	assert(stat->cb_stat);
+	if (!stat->cb_stat) {
+		faux_free(stat);
+		return NULL;
+	}
+	iter = faux_list_head(eloop->cb_stats);
+	while ((cb_rec = (faux_eloop_cb_rec_t *)faux_list_each(&iter))) {
+		if (0 == cb_rec->stat.dispatch_num)
+			continue;
+		stat->cb_stat[i] = cb_rec->stat;
+		i++;
+	}
+
+	return stat;
+}
+
+
+/** @brief Frees statistics snapshot.
+ *
+ * @param [in] stat Snapshot got by faux_eloop_stat().
+ */
+void faux_eloop_stat_free(faux_eloop_stat_t *stat)
+{
+	if (!stat)
+		return;
+
+	faux_free(stat->cb_stat);
+	faux_free(stat);
+}
+
+
+/** @brief Sets hook for slow callbacks.
+ *
+ * The hook is called after each callback that was executed longer than
+ * specified threshold. It doesn't depend on statistics gathering. The
+ * hook gets type of event, ID (file descriptor, signal number or scheduled
+ * event ID) and callback execution time.
+ *
+ * @param [in] eloop Allocated and initialized event loop object.
+ * @param [in] threshold Callback execution time threshold. NULL means zero.
+ * @param [in] slow_cb Hook function. NULL to remove hook.
+ * @param [in] user_data User data to pass to hook.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_eloop_set_slow_cb(faux_eloop_t *eloop,
+	const struct timespec *threshold, faux_eloop_slow_cb_fn slow_cb,
+	void *user_data)
+{
+	assert(eloop);
+	if (!eloop)
+		return BOOL_FALSE;
+
+	eloop->slow_threshold = threshold ? faux_timespec_to_nsec(threshold) : 0;
+	eloop->slow_cb = slow_cb;
+	eloop->slow_cb_data = user_data;
+	eloop->instrumented = (eloop->stat_enabled || eloop->slow_cb) ?
+		BOOL_TRUE : BOOL_FALSE;
+
+	return BOOL_TRUE;
 }
@@ -17,17 +17,37 @@ struct faux_eloop_s {
 #ifdef HAVE_SIGNALFD
 	int signal_fd; // Handler for signalfd(). Valid when loop is active only
 #endif
+	faux_ev_t **sched_batch; // Batch of popped events while dispatching
+	size_t sched_batch_len; // Number of items within sched_batch
+	// Instrumentation
+	bool_t instrumented; // Callbacks must be timed (stat or slow hook)
+	bool_t stat_enabled; // Gather statistics
+	faux_eloop_stat_t stat; // Loop-wide counters. The cb_stat is not used
+	faux_list_t *cb_stats; // List of faux_eloop_cb_rec_t
+	uint64_t slow_threshold; // Slow callback threshold in nanoseconds
+	faux_eloop_slow_cb_fn slow_cb; // Slow callback hook
+	void *slow_cb_data; // User data for slow callback hook
 };
 
 
+// Statistics record. Registrations with the same type and ID share it
+typedef struct faux_eloop_cb_rec_s {
+	faux_eloop_cb_stat_t stat; // Must be first. The list compares it
+	faux_eloop_t *eloop; // Owner of record
+	unsigned int ref_num; // Number of registrations and running callbacks
+} faux_eloop_cb_rec_t;
+
 typedef struct faux_eloop_context_s {
 	faux_eloop_cb_fn event_cb;
 	void *user_data;
+	faux_eloop_cb_rec_t *cb_rec; // Statistics record. Got on first dispatch
 } faux_eloop_context_t;
 
 typedef struct faux_eloop_fd_s {
 	int fd;
-	short events;
+	short events; // Registered events
+	short disarmed; // Events disarmed by edge-triggered or one-shot mode
+	unsigned int mode; // Triggering mode. See faux_eloop_fd_mode_e
 	faux_eloop_context_t context;
 } faux_eloop_fd_t;
 
@@ -0,0 +1,314 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "faux/time.h"
+#include "faux/eloop.h"
+
+
+static bool_t fd_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	faux_eloop_info_fd_t *info = (faux_eloop_info_fd_t *)associated_data;
+	char buf[16];
+
+	if (read(info->fd, buf, sizeof(buf)) < 0)
+		return BOOL_FALSE;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static bool_t stop_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_FALSE; // Break the loop
+}
+
+
+static bool_t count_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	unsigned int *counter = (unsigned int *)user_data;
+
+	// Don't read data so fd stays readable
+	(*counter)++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+static void slow_cb(faux_eloop_t *eloop, faux_eloop_type_e type, int id,
+	const struct timespec *duration, void *user_data)
+{
+	unsigned int *slow_num = (unsigned int *)user_data;
+
+	(*slow_num)++;
+
+	eloop = eloop; // Happy compiler
+	type = type; // Happy compiler
+	id = id; // Happy compiler
+	duration = duration; // Happy compiler
+}
+
+
+int testc_faux_eloop_stat(void)
+{
+	int ret = -1; // Pessimistic return value
+	int pipefd[2] = {-1, -1};
+	faux_eloop_t *eloop = NULL;
+	faux_eloop_stat_t *stat = NULL;
+	struct timespec delay = {0, 10000000l}; // 10ms
+	struct timespec period = {3600, 0}; // 1h
+	unsigned int slow_num = 0;
+	unsigned int periodic_num = 0;
+	size_t i = 0;
+	bool_t fd_found = BOOL_FALSE;
+	bool_t sched_found = BOOL_FALSE;
+	bool_t once_found = BOOL_FALSE;
+	const int ids[] = {INT_MAX, -1, INT_MIN, 0, -7, INT_MIN + 1, 1};
+	const size_t ids_num = sizeof(ids) / sizeof(ids[0]);
+
+	if (pipe(pipefd) < 0)
+		return -1;
+	if (write(pipefd[1], "test", 4) != 4)
+		goto err;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_set_stat(eloop, BOOL_TRUE);
+	// Zero threshold. All callbacks are slow
+	faux_eloop_set_slow_cb(eloop, NULL, slow_cb, &slow_num);
+	faux_eloop_add_fd(eloop, pipefd[0], POLLIN, fd_cb, NULL);
+	faux_eloop_add_sched_periodic(eloop, FAUX_SCHED_NOW, 6, count_cb,
+		&periodic_num, &period, FAUX_SCHED_INFINITE);
+	faux_eloop_add_sched_once_delayed(eloop, &delay, 5, stop_cb, NULL);
+	faux_eloop_loop(eloop);
+
+	stat = faux_eloop_stat(eloop);
+	if (!stat) {
+		printf("Can't get statistics snapshot\n");
+		goto err;
+	}
+	if (stat->iteration_num < 2) {
+		printf("Wrong number of iterations: %llu\n",
+			(unsigned long long)stat->iteration_num);
+		goto err;
+	}
+	if (stat->timeout_num < 1) {
+		printf("Timeout is not counted\n");
+		goto err;
+	}
+	if ((stat->ready_batch_num < 1) || (stat->ready_fd_max < 1)) {
+		printf("Ready fds are not counted\n");
+		goto err;
+	}
+	for (i = 0; i < stat->cb_stat_num; i++) {
+		faux_eloop_cb_stat_t *cb_stat = &stat->cb_stat[i];
+		if ((FAUX_ELOOP_FD == cb_stat->type) &&
+			(pipefd[0] == cb_stat->id) &&
+			(1 == cb_stat->dispatch_num))
+			fd_found = BOOL_TRUE;
+		if ((FAUX_ELOOP_SCHED == cb_stat->type) &&
+			(6 == cb_stat->id) &&
+			(1 == cb_stat->dispatch_num))
+			sched_found = BOOL_TRUE;
+		// Statistics is removed with registration
+		if ((FAUX_ELOOP_SCHED == cb_stat->type) &&
+			(5 == cb_stat->id))
+			once_found = BOOL_TRUE;
+	}
+	if (!fd_found || !sched_found || once_found) {
+		printf("Per-registration statistics is wrong\n");
+		goto err;
+	}
+	if (slow_num != 3) {
+		printf("Slow callback hook was called %u times\n", slow_num);
+		goto err;
+	}
+
+	// Unregistration
+	faux_eloop_del_fd(eloop, pipefd[0]);
+	faux_eloop_stat_free(stat);
+	stat = faux_eloop_stat(eloop);
+	if (!stat || (stat->cb_stat_num != 1)) {
+		printf("Statistics is not removed with registration\n");
+		goto err;
+	}
+
+	// Reset
+	faux_eloop_reset_stat(eloop);
+	faux_eloop_stat_free(stat);
+	stat = faux_eloop_stat(eloop);
+	if (!stat || (stat->iteration_num != 0) || (stat->cb_stat_num != 0)) {
+		printf("Statistics is not reset\n");
+		goto err;
+	}
+
+	// Negative and extreme IDs of scheduled events
+	for (i = 0; i < ids_num; i++)
+		faux_eloop_add_sched_periodic(eloop, FAUX_SCHED_NOW, ids[i],
+			count_cb, &periodic_num, &period, FAUX_SCHED_INFINITE);
+	faux_eloop_add_sched_once_delayed(eloop, &delay, 5, stop_cb, NULL);
+	faux_eloop_loop(eloop);
+	faux_eloop_stat_free(stat);
+	stat = faux_eloop_stat(eloop);
+	if (!stat || (stat->cb_stat_num != ids_num)) {
+		printf("Wrong number of records for extreme IDs\n");
+		goto err;
+	}
+	for (i = 1; i < stat->cb_stat_num; i++) {
+		if (stat->cb_stat[i - 1].id >= stat->cb_stat[i].id) {
+			printf("Records are not sorted by ID\n");
+			goto err;
+		}
+	}
+	faux_eloop_del_sched_by_id(eloop, INT_MIN);
+	faux_eloop_del_sched_by_id(eloop, INT_MAX);
+	faux_eloop_stat_free(stat);
+	stat = faux_eloop_stat(eloop);
+	if (!stat || (stat->cb_stat_num != ids_num - 2) ||
+		(INT_MIN + 1 != stat->cb_stat[0].id) ||
+		(1 != stat->cb_stat[stat->cb_stat_num - 1].id)) {
+		printf("Records with extreme IDs are not removed\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_stat_free(stat);
+	faux_eloop_free(eloop);
+	close(pipefd[0]);
+	close(pipefd[1]);
+
+	return ret;
+}
+
+
+static bool_t rearm_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	int *fd = (int *)user_data;
+
+	faux_eloop_rearm_fd(eloop, *fd, 0);
+
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_fd_mode(void)
+{
+	int ret = -1; // Pessimistic return value
+	int oneshot_pipe[2] = {-1, -1};
+	int edge_pipe[2] = {-1, -1};
+	faux_eloop_t *eloop = NULL;
+	struct timespec rearm_delay = {0, 10000000l}; // 10ms
+	struct timespec stop_delay = {0, 30000000l}; // 30ms
+	unsigned int oneshot_num = 0;
+	unsigned int edge_num = 0;
+
+	if ((pipe(oneshot_pipe) < 0) || (pipe(edge_pipe) < 0))
+		goto err;
+	if (write(oneshot_pipe[1], "test", 4) != 4)
+		goto err;
+	if (write(edge_pipe[1], "test", 4) != 4)
+		goto err;
+
+	eloop = faux_eloop_new(NULL);
+	faux_eloop_add_fd_mode(eloop, oneshot_pipe[0], POLLIN,
+		FAUX_ELOOP_FD_ONESHOT, count_cb, &oneshot_num);
+	faux_eloop_add_fd_mode(eloop, edge_pipe[0], POLLIN,
+		FAUX_ELOOP_FD_EDGE, count_cb, &edge_num);
+	faux_eloop_add_sched_once_delayed(eloop, &rearm_delay, 1,
+		rearm_cb, &edge_pipe[0]);
+	faux_eloop_add_sched_once_delayed(eloop, &stop_delay, 2,
+		stop_cb, NULL);
+	faux_eloop_loop(eloop);
+
+	// Level-triggered fds would be reported thousands times
+	if (oneshot_num != 1) {
+		printf("One-shot fd was reported %u times\n", oneshot_num);
+		goto err;
+	}
+	if (edge_num != 2) {
+		printf("Edge-triggered fd was reported %u times\n", edge_num);
+		goto err;
+	}
+	if (!faux_eloop_del_fd(eloop, oneshot_pipe[0])) {
+		printf("Can't delete disarmed fd\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_eloop_free(eloop);
+	close(oneshot_pipe[0]);
+	close(oneshot_pipe[1]);
+	close(edge_pipe[0]);
+	close(edge_pipe[1]);
+
+	return ret;
+}
+
+
+static bool_t del_cb(faux_eloop_t *eloop, faux_eloop_type_e type,
+	void *associated_data, void *user_data)
+{
+	faux_eloop_del_sched_by_id(eloop, 2);
+
+	type = type; // Happy compiler
+	associated_data = associated_data; // Happy compiler
+	user_data = user_data; // Happy compiler
+
+	return BOOL_TRUE;
+}
+
+
+int testc_faux_eloop_sched_batch(void)
+{
+	faux_eloop_t *eloop = NULL;
+	struct timespec stop_delay = {0, 20000000l}; // 20ms
+	unsigned int deleted_num = 0;
+	unsigned int periodic_num = 0;
+	struct timespec period = {0, 1000000l}; // 1ms
+
+	eloop = faux_eloop_new(NULL);
+	// Both events are popped within single batch. First callback deletes
+	// second event so it must not be executed.
+	faux_eloop_add_sched_once(eloop, FAUX_SCHED_NOW, 1, del_cb, NULL);
+	faux_eloop_add_sched_once(eloop, FAUX_SCHED_NOW, 2,
+		count_cb, &deleted_num);
+	faux_eloop_add_sched_periodic_delayed(eloop, 3, count_cb,
+		&periodic_num, &period, 5);
+	faux_eloop_add_sched_once_delayed(eloop, &stop_delay, 4,
+		stop_cb, NULL);
+	faux_eloop_loop(eloop);
+	faux_eloop_free(eloop);
+
+	if (deleted_num != 0) {
+		printf("Deleted event was executed\n");
+		return -1;
+	}
+	if (periodic_num != 5) {
+		printf("Periodic event was executed %u times\n", periodic_num);
+		return -1;
+	}
+
+	return 0;
+}
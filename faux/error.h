@@ -11,17 +11,20 @@
 #include <faux/list.h>
 
 typedef struct faux_error_s faux_error_t;
-typedef faux_list_node_t faux_error_node_t;
+typedef struct faux_error_node_s faux_error_node_t;
 
 C_DECL_BEGIN
 
 faux_error_t *faux_error_new(void);
+faux_error_t *faux_error_new_bounded(size_t max_num, size_t max_bytes);
 void faux_error_free(faux_error_t *error);
 void faux_error_reset(faux_error_t *error);
 ssize_t faux_error_len(const faux_error_t *error);
 bool_t faux_error(const faux_error_t *error);
 bool_t faux_error_add(faux_error_t *error, const char *str);
 bool_t faux_error_sprintf(faux_error_t *error, const char *fmt, ...);
+size_t faux_error_dropped(const faux_error_t *error);
+size_t faux_error_truncated(const faux_error_t *error);
 
 faux_error_node_t *faux_error_iter(const faux_error_t *error);
 faux_error_node_t *faux_error_iterr(const faux_error_t *error);
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <assert.h>
+#include <stdarg.h>
 
 #include "private.h"
 #include "faux/faux.h"
@@ -17,6 +18,8 @@
 /** @brief Allocates new error object.
  *
  * Before working with error object it must be allocated and initialized.
+ * Each message of unbounded error object is stored within single allocated
+ * memory block.
  *
  * @return Allocated and initialized error object or NULL on error.
  */
@@ -29,8 +32,49 @@ faux_error_t *faux_error_new(void)
 		return NULL;
 
 	// Init
-	error->list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
-		NULL, NULL, (void (*)(void *))faux_str_free);
+	error->head = NULL;
+	error->tail = NULL;
+	error->len = 0;
+	error->ring = NULL;
+	error->max_bytes = 0;
+	error->max_num = 0;
+	error->dropped = 0;
+	error->truncated = 0;
+
+	return error;
+}
+
+
+/** @brief Allocates new bounded error object.
+ *
+ * Bounded error object stores messages within single preallocated ring
+ * storage. Adding of message doesn't allocate memory. When storage is full
+ * or number of messages reaches the limit the oldest messages are dropped.
+ * Message that is longer than the whole storage is truncated. The numbers of
+ * dropped and truncated messages are available by faux_error_dropped() and
+ * faux_error_truncated().
+ *
+ * @param [in] max_num Max number of messages. 0 - unlimited.
+ * @param [in] max_bytes Size of storage for messages and its headers.
+ * @return Allocated and initialized error object or NULL on error.
+ */
+faux_error_t *faux_error_new_bounded(size_t max_num, size_t max_bytes)
+{
+	faux_error_t *error = NULL;
+
+	if (max_bytes < FAUX_ERROR_MIN_BYTES)
+		max_bytes = FAUX_ERROR_MIN_BYTES;
+
+	error = faux_error_new();
+	if (!error)
+		return NULL;
+	error->max_bytes = FAUX_ERROR_ALIGN(max_bytes);
+	error->max_num = max_num;
+	error->ring = faux_malloc(error->max_bytes);
+	if (!error->ring) {
+		faux_free(error);
+		return NULL;
+	}
 
 	return error;
 }
@@ -47,11 +91,31 @@ void faux_error_free(faux_error_t *error)
 	if (!error)
 		return;
 
-	faux_list_free(error->list);
+	faux_error_reset(error);
+	faux_free(error->ring);
 	faux_free(error);
 }
 
 
+/** @brief Service static function to remove the oldest message.
+ *
+ * @param [in] error Allocated and initialized error object.
+ */
+static void faux_error_del_head(faux_error_t *error)
+{
+	faux_error_node_t *node = error->head;
+
+	error->head = node->next;
+	if (error->head)
+		error->head->prev = NULL;
+	else
+		error->tail = NULL;
+	error->len--;
+	if (!error->ring)
+		faux_free(node);
+}
+
+
 /** @brief Reset error object to empty state.
  *
  * After using the error object must be freed.
@@ -62,7 +126,10 @@ void faux_error_reset(faux_error_t *error)
 	if (!error)
 		return;
 
-	faux_list_del_all(error->list);
+	while (error->head)
+		faux_error_del_head(error);
+	error->dropped = 0;
+	error->truncated = 0;
 }
 
 
@@ -76,7 +143,7 @@ ssize_t faux_error_len(const faux_error_t *error)
 	if (!error)
 		return -1;
 
-	return faux_list_len(error->list);
+	return error->len;
 }
 
 
@@ -97,6 +164,133 @@ bool_t faux_error(const faux_error_t *error)
 }
 
 
+/** @brief Gets number of dropped messages.
+ *
+ * Only bounded error object can drop messages.
+ *
+ * @param [in] error Allocated and initialized error object.
+ * @return Number of dropped messages since last reset.
+ */
+size_t faux_error_dropped(const faux_error_t *error)
+{
+	if (!error)
+		return 0;
+
+	return error->dropped;
+}
+
+
+/** @brief Gets number of truncated messages.
+ *
+ * Only bounded error object can truncate messages.
+ *
+ * @param [in] error Allocated and initialized error object.
+ * @return Number of truncated messages since last reset.
+ */
+size_t faux_error_truncated(const faux_error_t *error)
+{
+	if (!error)
+		return 0;
+
+	return error->truncated;
+}
+
+
+/** @brief Service static function to find place within bounded storage.
+ *
+ * Records are placed one after another. Record is never split. If there is
+ * no space at the end of storage then record is placed at the beginning. The
+ * oldest records that overlap new one are dropped.
+ *
+ * @param [in] error Allocated and initialized error object.
+ * @param [in,out] str_len Length of message. Can be truncated.
+ * @return Pointer to record or NULL on error.
+ */
+static faux_error_node_t *faux_error_ring_place(faux_error_t *error,
+	size_t *str_len)
+{
+	size_t size = 0;
+	size_t offset = 0;
+	size_t tail_offset = 0;
+	bool_t wrap = BOOL_FALSE;
+
+	size = FAUX_ERROR_ALIGN(sizeof(faux_error_node_t) + *str_len + 1);
+	if (size > error->max_bytes) {
+		size = error->max_bytes;
+		*str_len = size - sizeof(faux_error_node_t) - 1;
+		error->truncated++;
+	}
+
+	if (error->tail) {
+		tail_offset = (char *)error->tail - error->ring;
+		offset = tail_offset + error->tail->size;
+		if (offset + size > error->max_bytes) {
+			offset = 0;
+			wrap = BOOL_TRUE;
+		}
+	}
+
+	// Drop the oldest records to free space. On wrap the records
+	// located after the tail are dropped too to keep the order.
+	while (error->head) {
+		size_t head_offset = (char *)error->head - error->ring;
+		bool_t drop = BOOL_FALSE;
+
+		if ((head_offset < offset + size) &&
+			(offset < head_offset + error->head->size))
+			drop = BOOL_TRUE; // Overlap
+		else if (wrap && (head_offset > tail_offset))
+			drop = BOOL_TRUE;
+		else if ((error->max_num != 0) && (error->len >= error->max_num))
+			drop = BOOL_TRUE;
+		if (!drop)
+			break;
+		faux_error_del_head(error);
+		error->dropped++;
+	}
+
+	((faux_error_node_t *)(error->ring + offset))->size = size;
+
+	return (faux_error_node_t *)(error->ring + offset);
+}
+
+
+/** @brief Service static function to allocate record for message.
+ *
+ * The new record becomes the newest message of error object. Unbounded error
+ * object allocates memory for record. Bounded one uses preallocated storage.
+ *
+ * @param [in] error Allocated and initialized error object.
+ * @param [in,out] str_len Length of message. Can be truncated.
+ * @return Pointer to record or NULL on error.
+ */
+static faux_error_node_t *faux_error_node_new(faux_error_t *error,
+	size_t *str_len)
+{
+	faux_error_node_t *node = NULL;
+
+	if (error->ring) {
+		node = faux_error_ring_place(error, str_len);
+	} else {
+		node = faux_malloc(sizeof(*node) + *str_len + 1);
+		if (!node)
+			return NULL;
+		node->size = 0;
+	}
+
+	node->next = NULL;
+	node->prev = error->tail;
+	if (error->tail)
+		error->tail->next = node;
+	else
+		error->head = node;
+	error->tail = node;
+	error->len++;
+
+	return node;
+}
+
+
 /** @brief Adds error message to message stack.
  *
  * @param [in] error Allocated and initialized error object.
@@ -104,7 +298,8 @@ bool_t faux_error(const faux_error_t *error)
  */
 bool_t faux_error_add(faux_error_t *error, const char *str)
 {
-	char *tmp = NULL;
+	faux_error_node_t *node = NULL;
+	size_t len = 0;
 
 	// If error == NULL it's not bug
 	if (!error)
@@ -112,19 +307,21 @@ bool_t faux_error_add(faux_error_t *error, const char *str)
 	if (!str)
 		return BOOL_FALSE;
 
-	tmp = faux_str_dup(str);
-	if (!tmp)
-		return BOOL_FALSE;
-	if (!faux_list_add(error->list, tmp)) {
-		faux_str_free(tmp);
+	len = strlen(str);
+	node = faux_error_node_new(error, &len);
+	if (!node)
 		return BOOL_FALSE;
-	}
+	memcpy(node->str, str, len);
+	node->str[len] = '\0';
 
 	return BOOL_TRUE;
 }
 
 
 /** @brief Add formatted error message to message stack.
+ *
+ * The message is formatted directly to the record so there is no
+ * intermediate allocation.
  *
  * @param [in] error Allocated and initialized error object.
  * @param [in] fmt Format like printf() one.
@@ -133,26 +330,32 @@ bool_t faux_error_add(faux_error_t *error, const char *str)
  */
 bool_t faux_error_sprintf(faux_error_t *error, const char *fmt, ...)
 {
-	char *line = NULL;
+	faux_error_node_t *node = NULL;
 	va_list ap;
-	bool_t retval = BOOL_TRUE;
+	int rc = 0;
+	size_t len = 0;
 
 	if (!error)
 		return BOOL_FALSE;
 	if (!fmt)
 		return BOOL_FALSE;
 
+	// Calculate length of message
 	va_start(ap, fmt);
-	line = faux_str_vsprintf(fmt, ap);
+	rc = vsnprintf(NULL, 0, fmt, ap);
 	va_end(ap);
-
-	if (!line)
+	if (rc < 0)
 		return BOOL_FALSE;
 
-	retval = faux_error_add(error, line);
-	faux_str_free(line);
+	len = rc;
+	node = faux_error_node_new(error, &len);
+	if (!node)
+		return BOOL_FALSE;
+	va_start(ap, fmt);
+	vsnprintf(node->str, len + 1, fmt, ap);
+	va_end(ap);
 
-	return retval;
+	return BOOL_TRUE;
 }
 
 
@@ -171,7 +374,7 @@ faux_error_node_t *faux_error_iter(const faux_error_t *error)
 	if (!error)
 		return NULL;
 
-	return (faux_error_node_t *)faux_list_head(error->list);
+	return error->head;
 }
 
 
@@ -190,7 +393,7 @@ faux_error_node_t *faux_error_iterr(const faux_error_t *error)
 	if (!error)
 		return NULL;
 
-	return (faux_error_node_t *)faux_list_tail(error->list);
+	return error->tail;
 }
 
 
@@ -208,7 +411,14 @@ faux_error_node_t *faux_error_iterr(const faux_error_t *error)
  */
 const char *faux_error_each(faux_error_node_t **iter)
 {
-	return (const char *)faux_list_each((faux_list_node_t **)iter);
+	faux_error_node_t *node = NULL;
+
+	if (!iter || !*iter)
+		return NULL;
+	node = *iter;
+	*iter = node->next;
+
+	return node->str;
 }
 
 
@@ -226,7 +436,14 @@ const char *faux_error_each(faux_error_node_t **iter)
  */
 const char *faux_error_eachr(faux_error_node_t **iter)
 {
-	return (const char *)faux_list_eachr((faux_list_node_t **)iter);
+	faux_error_node_t *node = NULL;
+
+	if (!iter || !*iter)
+		return NULL;
+	node = *iter;
+	*iter = node->prev;
+
+	return node->str;
 }
 
 
@@ -294,17 +511,22 @@ char *faux_error_cstr(const faux_error_t *error)
 {
 	faux_error_node_t *iter = NULL;
 	const char *s = NULL;
-	char *cstr = NULL;
+	faux_strbuf_t *sb = NULL;
 
 	if (!error)
 		return NULL;
+	if (faux_error_len(error) <= 0)
+		return NULL;
 
+	sb = faux_strbuf_new(0);
+	if (!sb)
+		return NULL;
 	iter = faux_error_iter(error);
 	while ((s = faux_error_each(&iter))) {
-		faux_str_cat(&cstr, s);
+		faux_strbuf_append(sb, s);
 		if (iter)
-			faux_str_cat(&cstr, "\n");
+			faux_strbuf_appendc(sb, '\n');
 	}
 
-	return cstr;
+	return faux_strbuf_detach(sb);
 }
@@ -1,7 +1,27 @@
 #include "faux/faux.h"
-#include "faux/list.h"
 #include "faux/error.h"
 
+/** @brief Alignment of message records within bounded storage */
+#define FAUX_ERROR_ALIGN(n) \
+	(((n) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/** @brief Minimal storage size for bounded mode */
+#define FAUX_ERROR_MIN_BYTES 64
+
+struct faux_error_node_s {
+	faux_error_node_t *next; // Newer message
+	faux_error_node_t *prev; // Older message
+	size_t size; // Number of bytes occupied within bounded storage
+	char str[]; // Message. '\0'-terminated
+};
+
 struct faux_error_s {
-	faux_list_t *list;
+	faux_error_node_t *head; // The oldest message
+	faux_error_node_t *tail; // The newest message
+	size_t len; // Number of messages
+	char *ring; // Preallocated storage. NULL for unbounded mode
+	size_t max_bytes; // Size of preallocated storage
+	size_t max_num; // Max number of messages. 0 - unlimited
+	size_t dropped; // Number of dropped messages
+	size_t truncated; // Number of truncated messages
 };
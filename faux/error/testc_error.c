@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "faux/str.h"
+#include "faux/error.h"
+
+
+/** @brief Checks that error object contains last messages in right order */
+static int check_suffix(const faux_error_t *error, unsigned int total)
+{
+	faux_error_node_t *iter = NULL;
+	const char *str = NULL;
+	unsigned int first = total - faux_error_len(error);
+	unsigned int i = 0;
+
+	if (faux_error_len(error) + faux_error_dropped(error) != total) {
+		printf("Wrong len %ld + dropped %lu != %u\n",
+			faux_error_len(error), faux_error_dropped(error), total);
+		return -1;
+	}
+	iter = faux_error_iter(error);
+	for (i = first; (str = faux_error_each(&iter)); i++) {
+		char *etalon = faux_str_sprintf("message %u %*c", i, i % 50, 'x');
+		int rc = strcmp(etalon, str);
+		faux_str_free(etalon);
+		if (rc) {
+			printf("Wrong message %u: [%s]\n", i, str);
+			return -1;
+		}
+	}
+	if (i != total) {
+		printf("Wrong number of messages\n");
+		return -1;
+	}
+	// Reverse order
+	iter = faux_error_iterr(error);
+	for (i = total; (str = faux_error_eachr(&iter)); i--);
+	if (i != first) {
+		printf("Wrong reverse iteration\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int testc_faux_error(void)
+{
+	faux_error_t *error = NULL;
+	faux_error_node_t *iter = NULL;
+	char *str = NULL;
+	int ret = -1; // Pessimistic
+	unsigned int i = 0;
+
+	// Unbounded
+	error = faux_error_new();
+	faux_error_add(error, "first");
+	faux_error_sprintf(error, "second %d", 2);
+	str = faux_error_cstr(error);
+	if (!str || strcmp(str, "first\nsecond 2")) {
+		printf("Wrong cstr [%s]\n", str);
+		goto err;
+	}
+	faux_str_free(str);
+	str = NULL;
+	faux_error_reset(error);
+	if (faux_error(error) || faux_error_iter(error)) {
+		printf("Not empty after reset\n");
+		goto err;
+	}
+	faux_error_free(error);
+
+	// Bounded by number of messages
+	error = faux_error_new_bounded(3, 4096);
+	for (i = 0; i < 10; i++)
+		faux_error_sprintf(error, "message %u %*c", i, i % 50, 'x');
+	if ((faux_error_len(error) != 3) || check_suffix(error, 10))
+		goto err;
+	faux_error_free(error);
+
+	// Bounded by bytes. Messages have different lengths so ring wraps
+	// at different offsets.
+	error = faux_error_new_bounded(0, 1000);
+	for (i = 0; i < 1000; i++) {
+		faux_error_sprintf(error, "message %u %*c", i, i % 50, 'x');
+		if (check_suffix(error, i + 1))
+			goto err;
+	}
+	if (faux_error_truncated(error) != 0)
+		goto err;
+
+	// Truncation
+	faux_error_reset(error);
+	str = faux_str_sprintf("%*c", 2000, 'y');
+	faux_error_add(error, str);
+	iter = faux_error_iter(error);
+	if ((faux_error_len(error) != 1) || (faux_error_truncated(error) != 1) ||
+		(strlen(faux_error_each(&iter)) >= 1000)) {
+		printf("Wrong truncation\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_str_free(str);
+	faux_error_free(error);
+
+	return ret;
+}
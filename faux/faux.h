@@ -83,21 +83,40 @@ typedef enum {
 // For symbol versions
 #define FAUX_SYMVER(symbol,iface,version) asm(".symver symbol,iface@version")
 
+/** @brief Memory allocation statistics.
+ *
+ * See faux_mem_stat_enable().
+ */
+typedef struct faux_mem_stat_s {
+	unsigned long long malloc_num; // Number of allocations
+	unsigned long long malloc_bytes; // Number of allocated bytes
+	unsigned long long realloc_num; // Number of reallocations of memory
+	unsigned long long free_num; // Number of freed non-NULL pointers
+} faux_mem_stat_t;
+
 C_DECL_BEGIN
 
 // Memory
 void faux_free(void *ptr);
 void *faux_malloc(size_t size);
+void *faux_realloc(void *ptr, size_t size);
 void faux_bzero(void *ptr, size_t size);
 void *faux_zmalloc(size_t size);
 void faux_cleanse(void *ptr, size_t size);
+void faux_mem_stat_enable(bool_t enable);
+void faux_mem_stat_reset(void);
+void faux_mem_stat(faux_mem_stat_t *stat);
 
 // I/O
 ssize_t faux_write(int fd, const void *buf, size_t n);
 ssize_t faux_read(int fd, void *buf, size_t n);
 ssize_t faux_write_block(int fd, const void *buf, size_t n);
+ssize_t faux_writev_block(int fd, struct iovec *iov, int iovcnt);
 size_t faux_read_block(int fd, void *buf, size_t n);
 ssize_t faux_read_whole_file(const char *path, void **data);
+ssize_t faux_read_whole_file_mapped(const char *path, void **data,
+	bool_t *mapped);
+void faux_free_whole_file(void *data, size_t len, bool_t mapped);
 
 // Filesystem
 ssize_t faux_filesize(const char *path);
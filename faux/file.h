@@ -13,6 +13,7 @@
 #include <faux/faux.h>
 
 typedef struct faux_file_s faux_file_t;
+typedef struct faux_file_map_s faux_file_map_t;
 
 C_DECL_BEGIN
 
@@ -24,10 +25,21 @@ bool_t faux_file_eof(const faux_file_t *file);
 
 char *faux_file_getline_raw(faux_file_t *file);
 char *faux_file_getline(faux_file_t *file);
+const char *faux_file_getline_view(faux_file_t *file, size_t *len);
+bool_t faux_file_set_buf_size(faux_file_t *file, size_t size);
 ssize_t faux_file_write(faux_file_t *file, const void *buf, size_t n);
 ssize_t faux_file_write_block(faux_file_t *f, const void *buf, size_t n);
 ssize_t faux_file_read(faux_file_t *f, void *buf, size_t n);
 ssize_t faux_file_read_block(faux_file_t *f, void *buf, size_t n);
+bool_t faux_file_set_write_buf(faux_file_t *f, size_t size);
+bool_t faux_file_flush(faux_file_t *f);
+
+// Map whole file
+faux_file_map_t *faux_file_map(const char *pathname);
+void faux_file_unmap(faux_file_map_t *map);
+const void *faux_file_map_data(const faux_file_map_t *map);
+size_t faux_file_map_len(const faux_file_map_t *map);
+bool_t faux_file_map_is_mapped(const faux_file_map_t *map);
 
 C_DECL_END
 
@@ -57,15 +57,23 @@ faux_file_t *faux_file_fdopen(int fd)
 
 	// Init
 	f->fd = fd;
-	f->buf_size = FAUX_FILE_CHUNK_SIZE;
+	// Read-ahead buffer is equal to filesystem's preferred I/O block
+	if (stat_struct.st_blksize > 0)
+		f->buf_size = stat_struct.st_blksize;
+	else
+		f->buf_size = FAUX_FILE_CHUNK_SIZE;
 	f->buf = faux_zmalloc(f->buf_size);
 	assert(f->buf);
 	if (!f->buf) {
 		faux_free(f);
 		return NULL;
 	}
+	f->pos = 0;
 	f->len = 0;
 	f->eof = BOOL_FALSE;
+	f->wbuf = NULL; // Unbuffered write by default
+	f->wbuf_size = 0;
+	f->wlen = 0;
 	f->close_file = BOOL_FALSE; // Don't close fd because it's just a link
 
 	return f;
@@ -126,11 +134,15 @@ bool_t faux_file_close(faux_file_t *f)
 	if (!f)
 		return BOOL_FALSE;
 
+	// Flush-on-close
+	if (!faux_file_flush(f))
+		rc = BOOL_FALSE;
 	if (f->close_file) {
 		if (close(f->fd) < 0)
 			rc = BOOL_FALSE;
 	}
 	faux_free(f->buf);
+	faux_free(f->wbuf);
 	faux_free(f);
 
 	return rc;
@@ -169,213 +181,173 @@ bool_t faux_file_eof(const faux_file_t *f)
 }
 
 
-/** @brief Service static function to take away data block from internal buffer.
+/** @brief Service static function to compact internal buffer.
  *
- * Returns allocated data block in a form of C-string i.e. adds '\0' at the end
- * of data. Additionally function can drop some bytes from internal buffer.
- * It's usefull when it's necessary to get text string from the buffer and
- * drop trailing end of line.
- *
- * @warning Returned pointer must be freed by faux_str_free() later.
+ * Moves unread data to the beginning of internal buffer to free space for
+ * new data. Function is used only when buffer has no free space at the end
+ * so only the tail of incomplete line is moved.
  *
  * @param [in] f File object.
- * @param [in] bytes_get Number of bytes to get from internal buffer.
- * @param [in] bytes_drop Number of bytes to drop. Actually
- * (bytes_drop + bytes_get) bytes will be removed from internal buffer.
- * @return Allocated string (with trailing '\0') with data to get.
  */
-static char *faux_file_takeaway(faux_file_t *f,
-	size_t bytes_get, size_t bytes_drop)
+static void faux_file_compact(faux_file_t *f)
 {
-	size_t remove_len = 0;
-	char *line = NULL;
-
-	assert(f);
-	if (!f)
-		return NULL;
-
-	remove_len = bytes_get + bytes_drop;
-	// Try to take away more bytes than buffer contain
-	if ((remove_len > f->len) || (0 == remove_len))
-		return NULL;
-
-	line = faux_zmalloc(bytes_get + 1); // One extra byte for '\0'
-	assert(line);
-	if (!line)
-		return NULL; // Memory problems
-	memcpy(line, f->buf, bytes_get);
-
-	// Remove block from the internal buffer
-	f->len = f->len - remove_len;
-	memmove(f->buf, f->buf + remove_len, f->len);
-
-	return line;
+	if (0 == f->pos)
+		return;
+	f->len -= f->pos;
+	memmove(f->buf, f->buf + f->pos, f->len);
+	f->pos = 0;
 }
 
 
-/** @brief Service static function to get all data from buf as single C-string.
+/** @brief Service static function to enlarge internal buffer.
  *
- * Gets all the data from internal buffer as a single C-string (i.e. ends with
- * '\0'). This data will be removed from internal buffer.
+ * Each function execution doubles the buffer size so long lines need only
+ * logarithmic number of reallocations.
  *
- * @warning Returned pointer must be freed by faux_str_free() later.
- *
- * @param [in] f File object.
- * @return Allocated string (with trailing '\0') with data to get.
+ * @param [in] f File objects.
+ * @return 0 - success, < 0 - error
  */
-static char *faux_file_takeaway_rest(faux_file_t *f)
+static int faux_file_enlarge_buffer(faux_file_t *f)
 {
+	size_t new_size = 0;
+	char *new_buf = NULL;
+
 	assert(f);
 	if (!f)
-		return NULL;
+		return -1;
+
+	new_size = f->buf_size * 2;
+	new_buf = faux_realloc(f->buf, new_size);
+	assert(new_buf);
+	if (!new_buf)
+		return -1;
+	f->buf = new_buf;
+	f->buf_size = new_size;
 
-	return faux_file_takeaway(f, f->len, 0);
+	return 0;
 }
 
 
-/** @brief Universal static function to get line from buf as single C-string.
- *
- * Universal function for faux_file_takeaway(), faux_file_takeway_raw()
- * implementation.
+/** @brief Sets size of internal read-ahead buffer.
  *
- * @warning Returned pointer must be freed by faux_str_free() later.
+ * By default the buffer size is equal to preferred I/O block size of the
+ * file's filesystem (st_blksize). Each read() fills free space of the buffer
+ * so buffer size is a read-ahead size. Buffer will be enlarged automatically
+ * if line doesn't fit into it. The new size can't be less than amount of
+ * already buffered data.
  *
  * @param [in] f File object.
- * @param [in] raw Boolean flag.
- * BOOL_TRUE - include trailing EOL to resulting string,
- * BOOL_FALSE - don't include
- * @return Allocated string (with trailing '\0') with line.
+ * @param [in] size New buffer size.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
  */
-static char *faux_file_takeaway_line_internal(faux_file_t *f, bool_t raw)
+bool_t faux_file_set_buf_size(faux_file_t *f, size_t size)
 {
-	char *find = NULL;
-	const char *eol = "\n\r";
-	size_t line_len = 0;
+	size_t data_len = 0;
+	char *new_buf = NULL;
 
 	assert(f);
 	if (!f)
-		return NULL;
-
-	// Search buffer for EOL
-	find = faux_str_charsn(f->buf, eol, f->len);
-	if (!find)
-		return NULL; // End of line is not found
-	line_len = find - f->buf;
-
-	if (raw) {
-		// Takeaway line with trailing EOL.
-		return faux_file_takeaway(f, line_len + 1, 0);
-	} else {
-		// Takeaway line without trailing EOL. So drop one last byte
-		return faux_file_takeaway(f, line_len, 1);
-	}
-}
-
-
-/** @brief Service static function to get raw line from buf as single C-string.
- *
- * Gets line (data ends with EOL) from internal buffer as a single C-string
- * (i.e. ends with '\0'). The resulting line will contain trailing EOL.
- *
- * @warning Returned pointer must be freed by faux_str_free() later.
- *
- * @param [in] f File object.
- * @return Allocated string (with trailing '\0') with line.
- */
-static char *faux_file_takeaway_line_raw(faux_file_t *f)
-{
-	return faux_file_takeaway_line_internal(f, BOOL_TRUE);
-}
+		return BOOL_FALSE;
+	data_len = f->len - f->pos;
+	// One extra byte for '\0' after the last line without EOL
+	if ((0 == size) || (size <= data_len))
+		return BOOL_FALSE;
 
+	faux_file_compact(f);
+	new_buf = faux_realloc(f->buf, size);
+	assert(new_buf);
+	if (!new_buf)
+		return BOOL_FALSE;
+	f->buf = new_buf;
+	f->buf_size = size;
 
-/** @brief Service static function to get line from buf as single C-string.
- *
- * Gets line (data ends with EOL) from internal buffer as a single C-string
- * (i.e. ends with '\0'). The resulting line will not contain trailing EOL but
- * EOL will be removed from internal buffer together with line.
- *
- * @warning Returned pointer must be freed by faux_str_free() later.
- *
- * @param [in] f File object.
- * @return Allocated string (with trailing '\0') with line.
- */
-static char *faux_file_takeaway_line(faux_file_t *f)
-{
-	return faux_file_takeaway_line_internal(f, BOOL_FALSE);
+	return BOOL_TRUE;
 }
 
 
-/** @brief Service static function to enlarge internal buffer.
+/** @brief Service static function to find EOL within data block.
  *
- * The initial size of internal buffer is 128 bytes. Each function execution
- * enlarges buffer by chunk of 128 bytes.
+ * The EOL is '\n' or '\r'. The memchr() is vectorized by libc so it's much
+ * faster than byte-by-byte search. The '\r' is searched only before already
+ * found '\n' so data is scanned once in most cases.
  *
- * @param [in] f File objects.
- * @return 0 - success, < 0 - error
+ * @param [in] data Data to search.
+ * @param [in] len Length of data.
+ * @return Pointer to the first EOL or NULL if not found.
  */
-static int faux_file_enlarge_buffer(faux_file_t *f)
+static char *faux_file_find_eol(char *data, size_t len)
 {
-	size_t new_size = 0;
-	char *new_buf = NULL;
+	char *lf = NULL;
+	char *cr = NULL;
 
-	assert(f);
-	if (!f)
-		return -1;
-
-	new_size = f->buf_size + FAUX_FILE_CHUNK_SIZE;
-	new_buf = realloc(f->buf, new_size);
-	assert(new_buf);
-	if (!new_buf)
-		return -1;
-	// NULLify newly allocated memory
-	faux_bzero(new_buf + f->buf_size, new_size - f->buf_size);
-	f->buf = new_buf;
-	f->buf_size = new_size;
+	lf = memchr(data, '\n', len);
+	cr = memchr(data, '\r', lf ? (size_t)(lf - data) : len);
 
-	return 0;
+	return cr ? cr : lf;
 }
 
 
-/** @brief Universal static function to read line from file.
+/** @brief Service static function to read line from file.
  *
- * Function for implementation faux_file_getline_raw() and faux_file_getline().
+ * Function searches for line within internal buffer. If line is not found then
+ * function reads new data from file (as much as buffer can hold) and continues
+ * to search from the place where previous search was stopped. The found line
+ * is removed from the buffer by moving of read position so there is no data
+ * copying for each line. The buffer is compacted or enlarged (twice) only
+ * when there is no free space for new data.
  *
- * @warning Returned pointer must be freed by faux_str_free() later.
+ * The returned pointer points to the internal buffer and it's valid until the
+ * next operation with file object. The byte right after the line (EOL or
+ * unused byte after the last line) can be overwritten by caller.
  *
  * @param [in] f File object.
- * @param [in] raw
- * BOOL_TRUE - raw mode (with trailing EOL)
- * BOOL_FALSE - without trailing EOL
- * @return Line pointer or NULL on error.
+ * @param [out] line_len Length of line without EOL.
+ * @param [out] eol_len Length of EOL (0 or 1).
+ * @return Pointer to line within internal buffer or NULL on error or EOF.
  */
-char *faux_file_getline_internal(faux_file_t *f, bool_t raw)
+static char *faux_file_getline_ptr(faux_file_t *f,
+	size_t *line_len, size_t *eol_len)
 {
+	size_t scanned = 0; // Number of bytes already scanned for EOL
 	ssize_t bytes_readed = 0;
+	char *data = NULL;
+	size_t data_len = 0;
 
 	assert(f);
 	if (!f)
 		return NULL;
 
+	// Written data must reach the file before reading
+	if (!faux_file_flush(f))
+		return NULL;
+
 	do {
 		char *find = NULL;
 
 		// May be buffer already contain line
-		if (raw) { // raw mode
-			find = faux_file_takeaway_line_raw(f);
-		} else { // without trailing EOL
-			find = faux_file_takeaway_line(f);
+		data = f->buf + f->pos;
+		data_len = f->len - f->pos;
+		find = faux_file_find_eol(data + scanned, data_len - scanned);
+		if (find) {
+			*line_len = find - data;
+			*eol_len = 1;
+			f->pos += *line_len + 1;
+			return data;
 		}
-		if (find)
-			return find;
+		scanned = data_len;
 
-		if (f->buf_size == f->len) { // Buffer is full but doesn't contain line
-			if (faux_file_enlarge_buffer(f) < 0) // Make buffer larger
+		// Buffer is full but doesn't contain line. Keep one byte for '\0'
+		if (f->len + 1 >= f->buf_size) {
+			if (f->pos > 0)
+				faux_file_compact(f);
+			else if (faux_file_enlarge_buffer(f) < 0)
 				return NULL; // Memory problem
 		}
 
 		// Read new data from file
 		do {
-			bytes_readed = read(f->fd, f->buf + f->len, f->buf_size - f->len);
+			bytes_readed = read(f->fd, f->buf + f->len,
+				f->buf_size - f->len - 1);
 			if ((bytes_readed < 0) && (errno != EINTR))
 				return NULL; // Some file error
 		} while (bytes_readed < 0); // i.e. EINTR
@@ -387,9 +359,58 @@ char *faux_file_getline_internal(faux_file_t *f, bool_t raw)
 	f->eof = BOOL_TRUE;
 
 	// The last line can be without eol. Consider it as a line too
-	return faux_file_takeaway_rest(f);
+	data = f->buf + f->pos;
+	data_len = f->len - f->pos;
+	f->pos = 0;
+	f->len = 0;
+	if (0 == data_len)
+		return NULL;
+	*line_len = data_len;
+	*eol_len = 0;
+
+	return data;
+}
+
+
+/** @brief Universal static function to read line from file.
+ *
+ * Function for implementation faux_file_getline_raw() and faux_file_getline().
+ *
+ * @warning Returned pointer must be freed by faux_str_free() later.
+ *
+ * @param [in] f File object.
+ * @param [in] raw
+ * BOOL_TRUE - raw mode (with trailing EOL)
+ * BOOL_FALSE - without trailing EOL
+ * @return Line pointer or NULL on error.
+ */
+static char *faux_file_getline_internal(faux_file_t *f, bool_t raw)
+{
+	char *data = NULL;
+	char *line = NULL;
+	size_t line_len = 0;
+	size_t eol_len = 0;
+
+	assert(f);
+	if (!f)
+		return NULL;
+
+	data = faux_file_getline_ptr(f, &line_len, &eol_len);
+	if (!data)
+		return NULL;
+
+	if (raw)
+		line_len += eol_len;
+	line = faux_zmalloc(line_len + 1); // One extra byte for '\0'
+	assert(line);
+	if (!line)
+		return NULL; // Memory problems
+	memcpy(line, data, line_len);
+
+	return line;
 }
 
+
 /** @brief Read raw line from file.
  *
  * Raw line is a line with trailing EOL included.
@@ -425,11 +446,159 @@ char *faux_file_getline(faux_file_t *f)
 }
 
 
+/** @brief Read line from file without memory allocation.
+ *
+ * Function works like faux_file_getline() but doesn't allocate memory for
+ * the line. It returns pointer to the line within internal buffer of file
+ * object. The line is '\0'-terminated and doesn't contain trailing EOL.
+ *
+ * @warning Returned pointer is valid only until the next operation with
+ * file object. Don't free it.
+ *
+ * @param [in] f File object.
+ * @param [out] len Length of line. Can be NULL.
+ * @return Line pointer or NULL on error or EOF.
+ */
+const char *faux_file_getline_view(faux_file_t *f, size_t *len)
+{
+	char *data = NULL;
+	size_t line_len = 0;
+	size_t eol_len = 0;
+
+	assert(f);
+	if (!f)
+		return NULL;
+
+	data = faux_file_getline_ptr(f, &line_len, &eol_len);
+	if (!data)
+		return NULL;
+	// Replace EOL (or unused byte after the last line) by '\0'
+	data[line_len] = '\0';
+	if (len)
+		*len = line_len;
+
+	return data;
+}
+
+
+/** @brief Service static function to write data through write buffer.
+ *
+ * Small data blocks are copied to write buffer. The buffer is flushed when
+ * it becomes full. If data doesn't fit into free space of buffer then
+ * buffered data and new data are written by single writev() call. So large
+ * blocks are passed through without copying.
+ *
+ * @param [in] f File object.
+ * @param [in] buf Buffer to write.
+ * @param [in] n Number of bytes to write.
+ * @return Number of bytes written (i.e. n) or < 0 on error.
+ */
+static ssize_t faux_file_write_buffered(faux_file_t *f,
+	const void *buf, size_t n)
+{
+	struct iovec iov[2] = {};
+	size_t total = 0;
+
+	assert(buf);
+	if (!buf)
+		return -1;
+
+	// Data fits into buffer
+	if (n < (f->wbuf_size - f->wlen)) {
+		memcpy(f->wbuf + f->wlen, buf, n);
+		f->wlen += n;
+		return n;
+	}
+
+	// Write buffered data and new data together
+	iov[0].iov_base = f->wbuf;
+	iov[0].iov_len = f->wlen;
+	iov[1].iov_base = (void *)buf;
+	iov[1].iov_len = n;
+	total = f->wlen + n;
+	f->wlen = 0;
+	if (faux_writev_block(f->fd, iov, 2) != (ssize_t)total)
+		return -1;
+
+	return n;
+}
+
+
+/** @brief Sets size of write buffer.
+ *
+ * By default file object has no write buffer and each write function
+ * execution leads to write() system call. The write buffer accumulates
+ * written data and flushes it when buffer becomes full, on explicit
+ * faux_file_flush() call or on faux_file_close(). Data that doesn't fit into
+ * free buffer space is written by writev() together with buffered data
+ * without copying. Size 0 disables buffering. The already buffered data is
+ * flushed before buffer resizing.
+ *
+ * @param [in] f File object.
+ * @param [in] size Buffer size. 0 - unbuffered mode.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_file_set_write_buf(faux_file_t *f, size_t size)
+{
+	char *new_buf = NULL;
+
+	assert(f);
+	if (!f)
+		return BOOL_FALSE;
+
+	if (!faux_file_flush(f))
+		return BOOL_FALSE;
+	if (0 == size) {
+		faux_free(f->wbuf);
+		f->wbuf = NULL;
+		f->wbuf_size = 0;
+		return BOOL_TRUE;
+	}
+	new_buf = faux_realloc(f->wbuf, size);
+	assert(new_buf);
+	if (!new_buf)
+		return BOOL_FALSE;
+	f->wbuf = new_buf;
+	f->wbuf_size = size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Writes buffered data to file.
+ *
+ * Does nothing for unbuffered file object.
+ *
+ * @param [in] f File object.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_file_flush(faux_file_t *f)
+{
+	struct iovec iov = {};
+
+	assert(f);
+	if (!f)
+		return BOOL_FALSE;
+
+	if (0 == f->wlen)
+		return BOOL_TRUE;
+
+	iov.iov_base = f->wbuf;
+	iov.iov_len = f->wlen;
+	f->wlen = 0; // Drop data on error. It's hard to say what was written
+	if (faux_writev_block(f->fd, &iov, 1) != (ssize_t)iov.iov_len)
+		return BOOL_FALSE;
+
+	return BOOL_TRUE;
+}
+
+
 /** @brief Writes data to file.
  *
  * The system write() can be interrupted by signal or can write less bytes
  * than specified. This function will continue to write data until all data
- * will be written or error occured.
+ * will be written or error occured. If write buffer is set by
+ * faux_file_set_write_buf() then data can be buffered.
  *
  * @param [in] f File object.
  * @param [in] buf Buffer to write.
@@ -442,13 +611,17 @@ ssize_t faux_file_write(faux_file_t *f, const void *buf, size_t n)
 	if (!f)
 		return -1;
 
+	if (f->wbuf)
+		return faux_file_write_buffered(f, buf, n);
+
 	return faux_write(f->fd, buf, n);
 }
 
 
 /** @brief Writes data block to file.
  *
- * See faux_write_block() for documentation.
+ * See faux_write_block() for documentation. If write buffer is set by
+ * faux_file_set_write_buf() then data can be buffered.
  *
  * @param [in] f File object.
  * @param [in] buf Buffer to write.
@@ -461,10 +634,42 @@ ssize_t faux_file_write_block(faux_file_t *f, const void *buf, size_t n)
 	if (!f)
 		return -1;
 
+	if (f->wbuf)
+		return faux_file_write_buffered(f, buf, n);
+
 	return faux_write_block(f->fd, buf, n);
 }
 
 
+/** @brief Service static function to get already buffered data.
+ *
+ * The internal buffer can contain data readed ahead by getline functions.
+ * This data must be returned before the data from file.
+ *
+ * @param [in] f File object.
+ * @param [in] buf Buffer.
+ * @param [in] n Size of buffer.
+ * @return Number of bytes copied from internal buffer.
+ */
+static size_t faux_file_take_buffered(faux_file_t *f, void *buf, size_t n)
+{
+	size_t data_len = f->len - f->pos;
+
+	if (n > data_len)
+		n = data_len;
+	if (0 == n)
+		return 0;
+	memcpy(buf, f->buf + f->pos, n);
+	f->pos += n;
+	if (f->pos == f->len) {
+		f->pos = 0;
+		f->len = 0;
+	}
+
+	return n;
+}
+
+
 /** @brief Read data from file.
  *
  * See faux_read() for documentation.
@@ -476,11 +681,19 @@ ssize_t faux_file_write_block(faux_file_t *f, const void *buf, size_t n)
  */
 ssize_t faux_file_read(faux_file_t *f, void *buf, size_t n)
 {
+	size_t buffered = 0;
+
 	assert(f);
 	if (!f)
 		return -1;
 
-// TODO: Read buffer first
+	if (!faux_file_flush(f))
+		return -1;
+
+	// Read buffer first. Don't wait for file if buffer contains data
+	buffered = faux_file_take_buffered(f, buf, n);
+	if (buffered > 0)
+		return buffered;
 
 	return faux_read(f->fd, buf, n);
 }
@@ -497,11 +710,25 @@ ssize_t faux_file_read(faux_file_t *f, void *buf, size_t n)
  */
 ssize_t faux_file_read_block(faux_file_t *f, void *buf, size_t n)
 {
+	size_t buffered = 0;
+	ssize_t bytes_readed = 0;
+
 	assert(f);
 	if (!f)
 		return -1;
 
-// TODO: Read buffer first
+	if (!faux_file_flush(f))
+		return -1;
+
+	// Read buffer first
+	buffered = faux_file_take_buffered(f, buf, n);
+	if (buffered == n)
+		return buffered;
+
+	bytes_readed = faux_read_block(f->fd, (char *)buf + buffered,
+		n - buffered);
+	if (bytes_readed < 0)
+		return (buffered > 0) ? (ssize_t)buffered : -1;
 
-	return faux_read_block(f->fd, buf, n);
+	return buffered + bytes_readed;
 }
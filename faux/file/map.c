@@ -0,0 +1,116 @@
+/** @file map.c
+ * @brief Read-only mapping of whole file to memory.
+ *
+ * Regular files are mapped by mmap() so content is not copied to the heap
+ * and pages are shared with page cache. The pipes, character devices and
+ * special files (like /proc files with zero size) can't be mapped. For such
+ * files the content is read to the allocated buffer. In both cases the user
+ * gets pointer to the whole file content and its length.
+ */
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/file.h"
+
+
+/** @brief Maps whole file to memory.
+ *
+ * Regular files are mapped read-only. Other files are read to allocated
+ * buffer. See faux_read_whole_file_mapped().
+ *
+ * @warning The returned object must be freed by faux_file_unmap() later.
+ *
+ * @param [in] pathname File name.
+ * @return Allocated map object or NULL on error.
+ */
+faux_file_map_t *faux_file_map(const char *pathname)
+{
+	faux_file_map_t *map = NULL;
+	void *data = NULL;
+	bool_t mapped = BOOL_FALSE;
+	ssize_t len = 0;
+
+	assert(pathname);
+	if (!pathname)
+		return NULL;
+
+	len = faux_read_whole_file_mapped(pathname, &data, &mapped);
+	if (len < 0)
+		return NULL;
+
+	map = faux_zmalloc(sizeof(*map));
+	assert(map);
+	if (!map) {
+		faux_free_whole_file(data, len, mapped);
+		return NULL;
+	}
+	map->data = data;
+	map->len = len;
+	map->mapped = mapped;
+
+	return map;
+}
+
+
+/** @brief Unmaps file and frees map object.
+ *
+ * @param [in] map Map object.
+ */
+void faux_file_unmap(faux_file_map_t *map)
+{
+	if (!map)
+		return;
+
+	faux_free_whole_file(map->data, map->len, map->mapped);
+	faux_free(map);
+}
+
+
+/** @brief Gets pointer to file content.
+ *
+ * @param [in] map Map object.
+ * @return Pointer to file content or NULL for empty file.
+ */
+const void *faux_file_map_data(const faux_file_map_t *map)
+{
+	assert(map);
+	if (!map)
+		return NULL;
+
+	return map->data;
+}
+
+
+/** @brief Gets length of file content.
+ *
+ * @param [in] map Map object.
+ * @return Length of file content.
+ */
+size_t faux_file_map_len(const faux_file_map_t *map)
+{
+	assert(map);
+	if (!map)
+		return 0;
+
+	return map->len;
+}
+
+
+/** @brief Checks if file content is really mapped.
+ *
+ * @param [in] map Map object.
+ * @return BOOL_TRUE if file is mapped or BOOL_FALSE if it was read to buffer.
+ */
+bool_t faux_file_map_is_mapped(const faux_file_map_t *map)
+{
+	assert(map);
+	if (!map)
+		return BOOL_FALSE;
+
+	return map->mapped;
+}
@@ -2,14 +2,24 @@
 #include "faux/list.h"
 #include "faux/file.h"
 
-/** @brief Chunk size to allocate buffer */
+/** @brief Buffer size if filesystem block size is unknown */
 #define FAUX_FILE_CHUNK_SIZE 1024
 
 struct faux_file_s {
 	int fd; // File descriptor
 	char *buf; // Data buffer
 	size_t buf_size; // Current buffer size
-	size_t len; // Current data length
+	size_t pos; // Offset of unread data within buffer
+	size_t len; // End of data within buffer
 	bool_t eof; // EOF flag
+	char *wbuf; // Write buffer. NULL for unbuffered mode
+	size_t wbuf_size; // Write buffer size
+	size_t wlen; // Length of buffered data to write
 	bool_t close_file; // Whether close the file on free function
 };
+
+struct faux_file_map_s {
+	void *data; // File content
+	size_t len; // Content length
+	bool_t mapped; // Is content mapped or readed to allocated buffer
+};
@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "faux/str.h"
+#include "faux/file.h"
+#include "faux/testc_helpers.h"
+
+
+int testc_faux_file_getline(void)
+{
+	const char *etalon[] = {
+		"first",
+		"",
+		"cr line",
+		"0123456789012345678901234567890123456789012345678901234567890123"
+		"456789 long line that doesn't fit into small buffer",
+		"last line without EOL",
+		NULL
+		};
+	const char *content =
+		"first\n"
+		"\n"
+		"cr line\r"
+		"0123456789012345678901234567890123456789012345678901234567890123"
+		"456789 long line that doesn't fit into small buffer\n"
+		"last line without EOL";
+	size_t buf_sizes[] = {2, 7, 16, 4096};
+	int ret = -1; // Pessimistic
+	char *fn = NULL;
+	faux_file_t *f = NULL;
+	size_t s = 0;
+
+	fn = faux_testc_tmpfile_deploy_str(content);
+	if (!fn)
+		goto err;
+
+	for (s = 0; s < sizeof(buf_sizes) / sizeof(buf_sizes[0]); s++) {
+		const char *line = NULL;
+		char *str = NULL;
+		size_t len = 0;
+		int i = 0;
+
+		// Zero-copy view
+		f = faux_file_open(fn, O_RDONLY, 0);
+		if (!f)
+			goto err;
+		if (!faux_file_set_buf_size(f, buf_sizes[s])) {
+			printf("Can't set buffer size %lu\n", buf_sizes[s]);
+			goto err;
+		}
+		for (i = 0; (line = faux_file_getline_view(f, &len)); i++) {
+			if (!etalon[i] || (strlen(etalon[i]) != len) ||
+				strcmp(etalon[i], line)) {
+				printf("Buf %lu. View %d: [%s]\n",
+					buf_sizes[s], i, line);
+				goto err;
+			}
+		}
+		if (etalon[i] || !faux_file_eof(f)) {
+			printf("Buf %lu. View: too few lines\n", buf_sizes[s]);
+			goto err;
+		}
+		faux_file_close(f);
+
+		// Allocated raw lines
+		f = faux_file_open(fn, O_RDONLY, 0);
+		if (!f)
+			goto err;
+		faux_file_set_buf_size(f, buf_sizes[s]);
+		for (i = 0; (str = faux_file_getline_raw(f)); i++) {
+			size_t etalon_len = etalon[i] ? strlen(etalon[i]) : 0;
+			bool_t last = etalon[i] && !etalon[i + 1];
+			if (!etalon[i] ||
+				strncmp(etalon[i], str, etalon_len) ||
+				(strlen(str) != etalon_len + (last ? 0 : 1))) {
+				printf("Buf %lu. Raw %d: [%s]\n",
+					buf_sizes[s], i, str);
+				faux_str_free(str);
+				goto err;
+			}
+			faux_str_free(str);
+		}
+		if (etalon[i]) {
+			printf("Buf %lu. Raw: too few lines\n", buf_sizes[s]);
+			goto err;
+		}
+		faux_file_close(f);
+		f = NULL;
+	}
+
+	// Data readed ahead must be available for faux_file_read()
+	f = faux_file_open(fn, O_RDONLY, 0);
+	if (!f)
+		goto err;
+	{
+		char *str = faux_file_getline(f);
+		char buf[8] = {};
+		if (!str || strcmp(str, etalon[0])) {
+			printf("Can't get first line\n");
+			faux_str_free(str);
+			goto err;
+		}
+		faux_str_free(str);
+		if ((faux_file_read_block(f, buf, sizeof(buf) - 1) !=
+			(sizeof(buf) - 1)) || strcmp(buf, "\ncr lin")) {
+			printf("Wrong buffered read: [%s]\n", buf);
+			goto err;
+		}
+	}
+
+	ret = 0;
+err:
+	faux_file_close(f);
+	if (fn)
+		unlink(fn);
+	faux_str_free(fn);
+
+	return ret;
+}
+
+
+int testc_faux_file_map(void)
+{
+	const size_t len = 300000;
+	int ret = -1; // Pessimistic
+	char *src = NULL;
+	char *fn = NULL;
+	char *empty_fn = NULL;
+	faux_file_map_t *map = NULL;
+
+	src = faux_testc_rnd_buf(len);
+	fn = faux_testc_tmpfile_deploy(src, len);
+	empty_fn = faux_testc_tmpfile_deploy_str("");
+	if (!src || !fn || !empty_fn)
+		goto err;
+
+	// Regular file is mapped
+	map = faux_file_map(fn);
+	if (!map) {
+		printf("Can't map file\n");
+		goto err;
+	}
+	if (!faux_file_map_is_mapped(map) ||
+		(faux_file_map_len(map) != len) ||
+		memcmp(faux_file_map_data(map), src, len)) {
+		printf("Wrong mapped content\n");
+		goto err;
+	}
+	faux_file_unmap(map);
+	map = NULL;
+
+	// Empty file
+	map = faux_file_map(empty_fn);
+	if (!map || (faux_file_map_len(map) != 0)) {
+		printf("Wrong empty file\n");
+		goto err;
+	}
+	faux_file_unmap(map);
+	map = NULL;
+
+	// Special file with zero size is readed to buffer
+	map = faux_file_map("/proc/self/status");
+	if (!map || faux_file_map_is_mapped(map) ||
+		(faux_file_map_len(map) == 0) ||
+		strncmp(faux_file_map_data(map), "Name:", 5)) {
+		printf("Wrong special file\n");
+		goto err;
+	}
+
+	// Not existent file
+	if (faux_file_map("/not/existent/file")) {
+		printf("Map not existent file\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_file_unmap(map);
+	if (fn)
+		unlink(fn);
+	if (empty_fn)
+		unlink(empty_fn);
+	faux_str_free(fn);
+	faux_str_free(empty_fn);
+	faux_free(src);
+
+	return ret;
+}
+
+
+int testc_faux_file_write_buf(void)
+{
+	const size_t big_len = 1000;
+	int ret = -1; // Pessimistic
+	char *fn = NULL;
+	char *big = NULL;
+	faux_file_t *f = NULL;
+	faux_file_map_t *map = NULL;
+	faux_strbuf_t *etalon = NULL;
+	unsigned int i = 0;
+
+	fn = faux_testc_tmpfile_deploy_str("");
+	big = faux_testc_rnd_buf(big_len);
+	etalon = faux_strbuf_new(0);
+	if (!fn || !big || !etalon)
+		goto err;
+
+	f = faux_file_open(fn, O_WRONLY | O_TRUNC, 0);
+	if (!f || !faux_file_set_write_buf(f, 64))
+		goto err;
+
+	// Small writes are buffered
+	if (faux_file_write(f, "line\n", 5) != 5)
+		goto err;
+	faux_strbuf_appendn(etalon, "line\n", 5);
+	if (faux_filesize(fn) != 0) {
+		printf("Data is not buffered\n");
+		goto err;
+	}
+	if (!faux_file_flush(f) || (faux_filesize(fn) != 5)) {
+		printf("Data is not flushed\n");
+		goto err;
+	}
+
+	// Mix of small and large writes
+	for (i = 0; i < 100; i++) {
+		char *line = faux_str_sprintf("line %u\n", i);
+		size_t len = strlen(line);
+		if (faux_file_write_block(f, line, len) != (ssize_t)len) {
+			faux_str_free(line);
+			goto err;
+		}
+		faux_strbuf_appendn(etalon, line, len);
+		faux_str_free(line);
+		if ((i % 10) == 0) {
+			if (faux_file_write(f, big, big_len) != (ssize_t)big_len)
+				goto err;
+			faux_strbuf_appendn(etalon, big, big_len);
+		}
+	}
+
+	// Flush-on-close
+	if (!faux_file_close(f)) {
+		f = NULL;
+		printf("Can't close file\n");
+		goto err;
+	}
+	f = NULL;
+
+	map = faux_file_map(fn);
+	if (!map || (faux_file_map_len(map) != faux_strbuf_len(etalon)) ||
+		memcmp(faux_file_map_data(map), faux_strbuf_str(etalon),
+		faux_strbuf_len(etalon))) {
+		printf("Wrong file content\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_file_unmap(map);
+	faux_file_close(f);
+	if (fn)
+		unlink(fn);
+	faux_str_free(fn);
+	faux_free(big);
+	faux_strbuf_free(etalon);
+
+	return ret;
+}
@@ -475,43 +475,43 @@ char *faux_ini_write_str(const faux_ini_t *ini)
 	faux_ini_node_t *iter = NULL;
 	const faux_pair_t *pair = NULL;
 	const char *spaces = " \t"; // String with spaces needs quotes
-	char *str = NULL;
+	faux_strbuf_t *sb = NULL;
 
 	assert(ini);
 	if (!ini)
 		return NULL;
+	if (faux_ini_is_empty(ini))
+		return NULL;
 
+	sb = faux_strbuf_new(0);
+	if (!sb)
+		return NULL;
 	iter = faux_ini_iter(ini);
 	while ((pair = faux_ini_each(&iter))) {
 		char *quote_name = NULL;
 		char *quote_value = NULL;
 		const char *name = faux_pair_name(pair);
 		const char *value = faux_pair_value(pair);
-		char *line = NULL;
 
 		// Word with spaces needs quotes
 		quote_name = faux_str_chars(name, spaces) ? "\"" : "";
 		quote_value = faux_str_chars(value, spaces) ? "\"" : "";
 
-		// Prepare INI line
-		line = faux_str_sprintf("%s%s%s=%s%s%s\n",
-			quote_name, name, quote_name,
-			quote_value, value, quote_value);
-		if (!line) {
-			faux_str_free(str);
-			return NULL;
-		}
-
-		// Add to string
-		if (!faux_str_cat(&str, line)) {
-			faux_str_free(line);
-			faux_str_free(str);
+		// Add INI line. Plain appends are cheaper than format parsing
+		if (!faux_strbuf_append(sb, quote_name) ||
+			!faux_strbuf_append(sb, name) ||
+			!faux_strbuf_append(sb, quote_name) ||
+			!faux_strbuf_appendc(sb, '=') ||
+			!faux_strbuf_append(sb, quote_value) ||
+			!faux_strbuf_append(sb, value) ||
+			!faux_strbuf_append(sb, quote_value) ||
+			!faux_strbuf_appendc(sb, '\n')) {
+			faux_strbuf_free(sb);
 			return NULL;
 		}
-		faux_str_free(line);
 	}
 
-	return str;
+	return faux_strbuf_detach(sb);
 }
 
 
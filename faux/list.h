@@ -50,6 +50,7 @@ bool_t faux_list_is_empty(const faux_list_t *list);
 
 faux_list_node_t *faux_list_add(faux_list_t *list, void *data);
 faux_list_node_t *faux_list_add_find(faux_list_t *list, void *data);
+ssize_t faux_list_add_batch(faux_list_t *list, void **data, size_t num);
 void *faux_list_takeaway(faux_list_t *list, faux_list_node_t *node);
 bool_t faux_list_del(faux_list_t *list, faux_list_node_t *node);
 bool_t faux_list_kdel(faux_list_t *list, const void *userkey);
@@ -5,15 +5,105 @@
 #ifndef _faux_log_h
 #define _faux_log_h
 
+#include <stdint.h>
+#include <stdarg.h>
 #include <syslog.h>
 
 #include <faux/faux.h>
 
+typedef struct faux_log_s faux_log_t;
+
+/** @brief Public read-only part of logger object.
+ *
+ * It's the head of logger object so level filter doesn't need function
+ * call. Use faux_log_set_level() to change level.
+ */
+typedef struct faux_log_pub_s {
+	int level; // Max priority of records to log
+} faux_log_pub_t;
+
+/** @brief Writes record to the log if priority passes level filter.
+ *
+ * Filtered out record costs single comparison. The arguments are not
+ * evaluated in this case.
+ */
+#define FAUX_LOG(log, prio, ...) \
+	(faux_log_is_enabled((log), (prio)) ? \
+	faux_log_write((log), (prio), __VA_ARGS__) : BOOL_TRUE)
+
+/** @brief Per call site rate limiter.
+ *
+ * Use FAUX_LOG_LIMIT_INIT() to initialize it.
+ */
+typedef struct faux_log_limit_s {
+	uint64_t tat; // Theoretical arrival time (nsec)
+	uint64_t interval; // Interval between records (nsec). 0 - unlimited
+	uint64_t tolerance; // Burst tolerance (nsec)
+	size_t suppressed; // Number of suppressed records
+} faux_log_limit_t;
+
+/** @brief Initializer of rate limiter.
+ *
+ * Limiter allows "burst" records at once and "rate" records per second.
+ */
+#define FAUX_LOG_LIMIT_INIT(rate, burst) { 0, \
+	((rate) ? (1000000000ull / (rate)) : 0), \
+	((rate) ? (1000000000ull / (rate) * ((burst) ? (burst) - 1 : 0)) : 0), \
+	0 }
+
+/** @brief Writes record to the log with per call site rate limiting.
+ *
+ * The limiter is a static variable of call site. The decision is made
+ * before formatting so suppressed record costs a few nanoseconds.
+ */
+#define FAUX_LOG_LIMITED(log, prio, rate, burst, ...) \
+	do { \
+		static faux_log_limit_t faux_log_limit__ = \
+			FAUX_LOG_LIMIT_INIT(rate, burst); \
+		if (faux_log_is_enabled((log), (prio))) \
+			faux_log_write_limited((log), &faux_log_limit__, \
+				(prio), __VA_ARGS__); \
+	} while (0)
+
 C_DECL_BEGIN
 
 bool_t faux_log_facility_id(const char *str, int *facility);
 const char *faux_log_facility_str(int facility_id);
 
+// Asynchronous logger
+faux_log_t *faux_log_new(int fd, size_t ring_size);
+void faux_log_free(faux_log_t *log);
+void faux_log_set_level(faux_log_t *log, int level);
+int faux_log_level(const faux_log_t *log);
+bool_t faux_log_start(faux_log_t *log, unsigned int interval);
+size_t faux_log_flush(faux_log_t *log);
+bool_t faux_log_write(faux_log_t *log, int prio, const char *fmt, ...);
+bool_t faux_log_vwrite(faux_log_t *log, int prio, const char *fmt, va_list ap);
+size_t faux_log_dropped(const faux_log_t *log);
+size_t faux_log_truncated(const faux_log_t *log);
+
+// Rate limiting and deduplication
+void faux_log_set_dedup(faux_log_t *log, bool_t dedup);
+size_t faux_log_deduped(const faux_log_t *log);
+size_t faux_log_limited(const faux_log_t *log);
+bool_t faux_log_limit_check(faux_log_limit_t *limit);
+bool_t faux_log_write_limited(faux_log_t *log, faux_log_limit_t *limit,
+	int prio, const char *fmt, ...);
+
+/** @brief Checks if record with specified priority passes level filter.
+ *
+ * @param [in] log Logger object.
+ * @param [in] prio Priority.
+ * @return BOOL_TRUE - record will be logged, BOOL_FALSE - filtered out.
+ */
+static inline bool_t faux_log_is_enabled(const faux_log_t *log, int prio)
+{
+	const faux_log_pub_t *pub = (const faux_log_pub_t *)log;
+
+	return (LOG_PRI(prio) <= __atomic_load_n(&pub->level,
+		__ATOMIC_RELAXED)) ? BOOL_TRUE : BOOL_FALSE;
+}
+
 C_DECL_END
 
 #endif
@@ -0,0 +1,101 @@
+/** @file limit.c
+ * @brief Rate limiting of log records.
+ *
+ * Each call site of FAUX_LOG_LIMITED() has its own static limiter. The
+ * limiter implements token bucket as generic cell rate algorithm (GCRA). The
+ * whole state is a single "theoretical arrival time" so decision is made by
+ * one atomic compare-and-swap before any formatting work.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <time.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/time.h"
+#include "faux/log.h"
+
+
+/** @brief Checks if limiter allows one more record.
+ *
+ * Limiter allows "burst" records at once and then "rate" records per second.
+ * The denied record is counted within limiter.
+ *
+ * @param [in] limit Limiter.
+ * @return BOOL_TRUE - record is allowed, BOOL_FALSE - denied.
+ */
+bool_t faux_log_limit_check(faux_log_limit_t *limit)
+{
+	struct timespec ts = {};
+	uint64_t now = 0;
+	uint64_t tat = 0;
+	uint64_t new_tat = 0;
+
+	assert(limit);
+	if (!limit)
+		return BOOL_FALSE;
+	if (0 == limit->interval) // Unlimited
+		return BOOL_TRUE;
+
+	faux_timespec_now_monotonic(&ts);
+	now = faux_timespec_to_nsec(&ts);
+	tat = __atomic_load_n(&limit->tat, __ATOMIC_RELAXED);
+	do {
+		// Too many records within burst window
+		if (tat > now + limit->tolerance) {
+			__atomic_add_fetch(&limit->suppressed, 1,
+				__ATOMIC_RELAXED);
+			return BOOL_FALSE;
+		}
+		new_tat = ((tat > now) ? tat : now) + limit->interval;
+	} while (!__atomic_compare_exchange_n(&limit->tat, &tat, new_tat,
+		BOOL_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Writes record to the log if limiter allows it.
+ *
+ * If some records were suppressed by limiter since last written record
+ * then the record about number of suppressed records is written first.
+ *
+ * @param [in] log Logger object.
+ * @param [in] limit Limiter of call site.
+ * @param [in] prio Priority.
+ * @param [in] fmt Format like printf() one.
+ * @return BOOL_TRUE - success, suppressed or filtered out,
+ * BOOL_FALSE - record is dropped.
+ */
+bool_t faux_log_write_limited(faux_log_t *log, faux_log_limit_t *limit,
+	int prio, const char *fmt, ...)
+{
+	size_t suppressed = 0;
+	bool_t rc = BOOL_FALSE;
+	va_list ap;
+
+	assert(log);
+	if (!log)
+		return BOOL_FALSE;
+	if (LOG_PRI(prio) > faux_log_level(log))
+		return BOOL_TRUE;
+
+	if (!faux_log_limit_check(limit)) {
+		__atomic_add_fetch(&log->limited, 1, __ATOMIC_RELAXED);
+		return BOOL_TRUE;
+	}
+
+	suppressed = __atomic_exchange_n(&limit->suppressed, 0, __ATOMIC_RELAXED);
+	if (suppressed > 0)
+		faux_log_write(log, prio, "%lu messages suppressed by rate limit",
+			(unsigned long)suppressed);
+
+	va_start(ap, fmt);
+	rc = faux_log_vwrite(log, prio, fmt, ap);
+	va_end(ap);
+
+	return rc;
+}
@@ -0,0 +1,693 @@
+/** @file logger.c
+ * @brief Asynchronous logger.
+ *
+ * Each thread that writes logs gets its own lock-free ring of preformatted
+ * records. The record is formatted directly to the ring so writing doesn't
+ * allocate memory and doesn't take any lock. If ring is full the record is
+ * dropped and counted. The rings are drained by background thread (see
+ * faux_log_start()) or by explicit faux_log_flush() call that can be
+ * scheduled by event loop. The records are written to file descriptor by
+ * writev() in batches or to syslog.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+#include <syslog.h>
+
+#include "private.h"
+#include "faux/faux.h"
+#include "faux/log.h"
+
+static void faux_log_ring_repeats(faux_log_t *log, faux_log_ring_t *ring);
+
+
+/** @brief Service static function to mark ring of finished thread.
+ *
+ * It's a destructor of thread specific data. The ring can't be freed here
+ * because it can contain records. Flush function will free it.
+ *
+ * @param [in] data Ring.
+ */
+static void faux_log_ring_orphan(void *data)
+{
+	faux_log_ring_t *ring = (faux_log_ring_t *)data;
+
+	__atomic_store_n(&ring->orphan, BOOL_TRUE, __ATOMIC_RELEASE);
+}
+
+
+/** @brief Service static function to free ring.
+ *
+ * @param [in] ring Ring.
+ */
+static void faux_log_ring_free(faux_log_ring_t *ring)
+{
+	if (!ring)
+		return;
+
+	faux_free(ring->data);
+	faux_free(ring);
+}
+
+
+/** @brief Allocates new logger object.
+ *
+ * Records are written to specified file descriptor (file, stderr etc) or to
+ * syslog if fd < 0. The openlog() for syslog must be called by user.
+ * The default level is LOG_INFO.
+ *
+ * @param [in] fd File descriptor or -1 for syslog.
+ * @param [in] ring_size Size of per-thread ring. 0 - default size.
+ * @return Allocated logger object or NULL on error.
+ */
+faux_log_t *faux_log_new(int fd, size_t ring_size)
+{
+	faux_log_t *log = NULL;
+	size_t size = FAUX_LOG_RING_MIN_SIZE;
+
+	if (0 == ring_size)
+		ring_size = FAUX_LOG_RING_SIZE;
+	while (size < ring_size)
+		size <<= 1;
+
+	log = faux_zmalloc(sizeof(*log));
+	assert(log);
+	if (!log)
+		return NULL;
+
+	// Init
+	log->pub.level = LOG_INFO;
+	log->fd = fd;
+	log->ring_size = size;
+	log->rings = NULL;
+	log->dropped = 0;
+	log->truncated = 0;
+	log->dedup = BOOL_FALSE;
+	log->deduped = 0;
+	log->limited = 0;
+	log->started = BOOL_FALSE;
+	log->stop = BOOL_FALSE;
+	log->wake_pending = BOOL_FALSE;
+	log->interval = FAUX_LOG_FLUSH_INTERVAL;
+	if (pthread_key_create(&log->key, faux_log_ring_orphan) != 0) {
+		faux_free(log);
+		return NULL;
+	}
+	pthread_mutex_init(&log->mutex, NULL);
+	sem_init(&log->wake, 0, 0);
+
+	return log;
+}
+
+
+/** @brief Frees logger object.
+ *
+ * Stops background thread and flushes all records. Function must be called
+ * when other threads don't write logs anymore.
+ *
+ * @param [in] log Logger object.
+ */
+void faux_log_free(faux_log_t *log)
+{
+	faux_log_ring_t *ring = NULL;
+
+	if (!log)
+		return;
+
+	if (log->started) {
+		__atomic_store_n(&log->stop, BOOL_TRUE, __ATOMIC_RELEASE);
+		sem_post(&log->wake);
+		pthread_join(log->thread, NULL);
+	}
+	// Producers are finished so their rings can be used here
+	for (ring = log->rings; ring; ring = ring->next)
+		faux_log_ring_repeats(log, ring);
+	faux_log_flush(log);
+
+	pthread_key_delete(log->key);
+	ring = log->rings;
+	while (ring) {
+		faux_log_ring_t *next = ring->next;
+		faux_log_ring_free(ring);
+		ring = next;
+	}
+	pthread_mutex_destroy(&log->mutex);
+	sem_destroy(&log->wake);
+	faux_free(log);
+}
+
+
+/** @brief Sets max priority of records to log.
+ *
+ * Records with numerically greater priority (less important) are filtered
+ * out. Use syslog's LOG_ERR, LOG_DEBUG etc.
+ *
+ * @param [in] log Logger object.
+ * @param [in] level Max priority.
+ */
+void faux_log_set_level(faux_log_t *log, int level)
+{
+	assert(log);
+	if (!log)
+		return;
+
+	__atomic_store_n(&log->pub.level, LOG_PRI(level), __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets max priority of records to log.
+ *
+ * @param [in] log Logger object.
+ * @return Max priority.
+ */
+int faux_log_level(const faux_log_t *log)
+{
+	assert(log);
+	if (!log)
+		return -1;
+
+	return __atomic_load_n(&log->pub.level, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets number of dropped records.
+ *
+ * Record is dropped when ring of thread is full.
+ *
+ * @param [in] log Logger object.
+ * @return Number of dropped records.
+ */
+size_t faux_log_dropped(const faux_log_t *log)
+{
+	assert(log);
+	if (!log)
+		return 0;
+
+	return __atomic_load_n(&log->dropped, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets number of truncated records.
+ *
+ * Record is truncated when its text is longer than FAUX_LOG_MAX_LEN.
+ *
+ * @param [in] log Logger object.
+ * @return Number of truncated records.
+ */
+size_t faux_log_truncated(const faux_log_t *log)
+{
+	assert(log);
+	if (!log)
+		return 0;
+
+	return __atomic_load_n(&log->truncated, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Enables or disables suppression of consecutive duplicates.
+ *
+ * If thread writes the same record (the same text and priority) several
+ * times in a row then only the first one is written. The next different
+ * record is preceded by "last message repeated N times" record. Only records
+ * from the same call site (i.e. with the same format string pointer) are
+ * compared. So records from other call sites pay nothing.
+ *
+ * @param [in] log Logger object.
+ * @param [in] dedup BOOL_TRUE - enable, BOOL_FALSE - disable.
+ */
+void faux_log_set_dedup(faux_log_t *log, bool_t dedup)
+{
+	assert(log);
+	if (!log)
+		return;
+
+	__atomic_store_n(&log->dedup, dedup, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets number of suppressed duplicates.
+ *
+ * @param [in] log Logger object.
+ * @return Number of suppressed duplicates.
+ */
+size_t faux_log_deduped(const faux_log_t *log)
+{
+	assert(log);
+	if (!log)
+		return 0;
+
+	return __atomic_load_n(&log->deduped, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Gets number of records suppressed by rate limit.
+ *
+ * @param [in] log Logger object.
+ * @return Number of records suppressed by rate limit.
+ */
+size_t faux_log_limited(const faux_log_t *log)
+{
+	assert(log);
+	if (!log)
+		return 0;
+
+	return __atomic_load_n(&log->limited, __ATOMIC_RELAXED);
+}
+
+
+/** @brief Service static function to calculate hash of record text.
+ *
+ * FNV-1a like hash that consumes 8 bytes per step.
+ *
+ * @param [in] text Text.
+ * @param [in] len Text length.
+ * @return Hash.
+ */
+static uint64_t faux_log_hash(const char *text, size_t len)
+{
+	uint64_t hash = 14695981039346656037ULL ^ len;
+
+	while (len >= sizeof(uint64_t)) {
+		uint64_t word = 0;
+		memcpy(&word, text, sizeof(word));
+		hash = (hash ^ word) * 1099511628211ULL;
+		hash ^= hash >> 32;
+		text += sizeof(word);
+		len -= sizeof(word);
+	}
+	while (len > 0) {
+		hash = (hash ^ (unsigned char)*text) * 1099511628211ULL;
+		text++;
+		len--;
+	}
+
+	return hash;
+}
+
+
+/** @brief Service static function to get ring of current thread.
+ *
+ * The ring is created on first use. Only the registration of new ring takes
+ * the lock.
+ *
+ * @param [in] log Logger object.
+ * @return Ring or NULL on error.
+ */
+static faux_log_ring_t *faux_log_ring(faux_log_t *log)
+{
+	faux_log_ring_t *ring = NULL;
+
+	ring = pthread_getspecific(log->key);
+	if (ring)
+		return ring;
+
+	ring = faux_zmalloc(sizeof(*ring));
+	if (!ring)
+		return NULL;
+	ring->size = log->ring_size;
+	ring->data = faux_malloc(ring->size);
+	if (!ring->data) {
+		faux_free(ring);
+		return NULL;
+	}
+	ring->head = 0;
+	ring->tail = 0;
+	ring->orphan = BOOL_FALSE;
+	ring->last_fmt = NULL;
+	ring->last_prio = 0;
+	ring->last_hash = 0;
+	ring->repeats = 0;
+
+	pthread_mutex_lock(&log->mutex);
+	ring->next = log->rings;
+	log->rings = ring;
+	pthread_mutex_unlock(&log->mutex);
+	pthread_setspecific(log->key, ring);
+
+	return ring;
+}
+
+
+/** @brief Service static function to put record to the ring.
+ *
+ * @param [in] log Logger object.
+ * @param [in] ring Ring of current thread.
+ * @param [in] prio Priority.
+ * @param [in] site Call site for deduplication. NULL for service records.
+ * @param [in] fmt Format like printf() one.
+ * @param [in] ap List of arguments.
+ * @return BOOL_TRUE - success, BOOL_FALSE - record is dropped.
+ */
+static bool_t faux_log_ring_put(faux_log_t *log, faux_log_ring_t *ring,
+	int prio, const char *site, const char *fmt, va_list ap)
+{
+	faux_log_rec_t *rec = NULL;
+	const size_t hdr = sizeof(faux_log_rec_t);
+	size_t head = 0;
+	size_t space = 0; // Free space
+	size_t pos = 0; // Offset of record within ring
+	size_t contig = 0; // Contiguous space till the end of ring
+	size_t avail = 0;
+	size_t skip = 0; // Padding at the end of ring
+	size_t len = 0; // Text length
+	bool_t fits = BOOL_FALSE;
+	int n = 0;
+	va_list aq;
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	space = ring->size - (ring->tail - head);
+	pos = ring->tail & (ring->size - 1);
+	contig = ring->size - pos;
+	avail = (space < contig) ? space : contig;
+
+	// Optimistically format text in place
+	va_copy(aq, ap);
+	if (avail > hdr) {
+		size_t cap = avail - hdr; // Including '\0'
+		if (cap > FAUX_LOG_MAX_LEN + 1)
+			cap = FAUX_LOG_MAX_LEN + 1;
+		n = vsnprintf(ring->data + pos + hdr, cap, fmt, aq);
+		fits = (n >= 0) &&
+			(((size_t)n < cap) || (FAUX_LOG_MAX_LEN + 1 == cap));
+	} else {
+		n = vsnprintf(NULL, 0, fmt, aq);
+	}
+	va_end(aq);
+	if (n < 0)
+		return BOOL_FALSE;
+	len = n;
+	if (len > FAUX_LOG_MAX_LEN) {
+		len = FAUX_LOG_MAX_LEN;
+		__atomic_add_fetch(&log->truncated, 1, __ATOMIC_RELAXED);
+	}
+
+	// There is no contiguous space at the end of ring. Wrap
+	if (!fits) {
+		size_t need = FAUX_LOG_ALIGN(hdr + len + 1);
+		if ((contig >= space) || (need > space - contig)) {
+			__atomic_add_fetch(&log->dropped, 1, __ATOMIC_RELAXED);
+			return BOOL_FALSE;
+		}
+		rec = (faux_log_rec_t *)(ring->data + pos);
+		rec->size = contig;
+		rec->prio = -1;
+		rec->len = 0;
+		skip = contig;
+		pos = 0;
+		vsnprintf(ring->data + hdr, len + 1, fmt, ap);
+	}
+
+	rec = (faux_log_rec_t *)(ring->data + pos);
+	rec->size = FAUX_LOG_ALIGN(hdr + len + 1);
+	rec->prio = prio;
+	rec->len = len + 1;
+	ring->data[pos + hdr + len] = '\n';
+	if (site && __atomic_load_n(&log->dedup, __ATOMIC_RELAXED)) {
+		ring->last_fmt = site;
+		ring->last_prio = prio;
+		ring->last_hash = faux_log_hash(ring->data + pos + hdr, len);
+	}
+	__atomic_store_n(&ring->tail, ring->tail + skip + rec->size,
+		__ATOMIC_RELEASE);
+
+	// Wake up flusher if ring is half full
+	if (__atomic_load_n(&log->started, __ATOMIC_ACQUIRE) &&
+		((ring->tail - head) > (ring->size / 2)) &&
+		!__atomic_exchange_n(&log->wake_pending, BOOL_TRUE,
+		__ATOMIC_ACQ_REL))
+		sem_post(&log->wake);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Service static function to put record to the ring.
+ *
+ * Variadic version of faux_log_ring_put().
+ *
+ * @param [in] log Logger object.
+ * @param [in] ring Ring of current thread.
+ * @param [in] prio Priority.
+ * @param [in] site Call site for deduplication. NULL for service records.
+ * @param [in] fmt Format like printf() one.
+ * @return BOOL_TRUE - success, BOOL_FALSE - record is dropped.
+ */
+static bool_t faux_log_ring_putf(faux_log_t *log, faux_log_ring_t *ring,
+	int prio, const char *site, const char *fmt, ...)
+{
+	bool_t rc = BOOL_FALSE;
+	va_list ap;
+
+	va_start(ap, fmt);
+	rc = faux_log_ring_put(log, ring, prio, site, fmt, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+
+/** @brief Service static function to write number of suppressed duplicates.
+ *
+ * @param [in] log Logger object.
+ * @param [in] ring Ring of current thread.
+ */
+static void faux_log_ring_repeats(faux_log_t *log, faux_log_ring_t *ring)
+{
+	if (0 == ring->repeats)
+		return;
+	faux_log_ring_putf(log, ring, ring->last_prio, NULL,
+		"last message repeated %lu times", (unsigned long)ring->repeats);
+	ring->repeats = 0;
+}
+
+
+/** @brief Writes record to the log.
+ *
+ * See faux_log_write().
+ *
+ * @param [in] log Logger object.
+ * @param [in] prio Priority.
+ * @param [in] fmt Format like printf() one.
+ * @param [in] ap List of arguments.
+ * @return BOOL_TRUE - success or filtered out, BOOL_FALSE - record is dropped.
+ */
+bool_t faux_log_vwrite(faux_log_t *log, int prio, const char *fmt, va_list ap)
+{
+	faux_log_ring_t *ring = NULL;
+	char text[FAUX_LOG_MAX_LEN + 1];
+	size_t len = 0;
+	int n = 0;
+
+	assert(log);
+	if (!log || !fmt)
+		return BOOL_FALSE;
+	if (!faux_log_is_enabled(log, prio))
+		return BOOL_TRUE;
+
+	ring = faux_log_ring(log);
+	if (!ring) {
+		__atomic_add_fetch(&log->dropped, 1, __ATOMIC_RELAXED);
+		return BOOL_FALSE;
+	}
+
+	if (!__atomic_load_n(&log->dedup, __ATOMIC_RELAXED))
+		return faux_log_ring_put(log, ring, prio, fmt, fmt, ap);
+
+	// Record from another call site can't be a duplicate
+	if ((fmt != ring->last_fmt) || (prio != ring->last_prio)) {
+		faux_log_ring_repeats(log, ring);
+		return faux_log_ring_put(log, ring, prio, fmt, fmt, ap);
+	}
+
+	// The same call site. Compare text
+	n = vsnprintf(text, sizeof(text), fmt, ap);
+	if (n < 0)
+		return BOOL_FALSE;
+	len = n;
+	if (len > FAUX_LOG_MAX_LEN) {
+		len = FAUX_LOG_MAX_LEN;
+		__atomic_add_fetch(&log->truncated, 1, __ATOMIC_RELAXED);
+	}
+	if (faux_log_hash(text, len) == ring->last_hash) {
+		ring->repeats++;
+		__atomic_add_fetch(&log->deduped, 1, __ATOMIC_RELAXED);
+		return BOOL_TRUE;
+	}
+	faux_log_ring_repeats(log, ring);
+
+	return faux_log_ring_putf(log, ring, prio, fmt, "%.*s", (int)len, text);
+}
+
+
+/** @brief Writes record to the log.
+ *
+ * The record is formatted to the ring of current thread. Function doesn't
+ * take locks and doesn't make system calls. The record is dropped if ring
+ * is full. Use FAUX_LOG() macro to avoid function call and arguments
+ * evaluation for records that are filtered out by level.
+ *
+ * @param [in] log Logger object.
+ * @param [in] prio Priority.
+ * @param [in] fmt Format like printf() one.
+ * @return BOOL_TRUE - success or filtered out, BOOL_FALSE - record is dropped.
+ */
+bool_t faux_log_write(faux_log_t *log, int prio, const char *fmt, ...)
+{
+	bool_t rc = BOOL_FALSE;
+	va_list ap;
+
+	va_start(ap, fmt);
+	rc = faux_log_vwrite(log, prio, fmt, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+
+/** @brief Service static function to drain ring.
+ *
+ * @param [in] log Logger object.
+ * @param [in] ring Ring.
+ * @return Number of written records.
+ */
+static size_t faux_log_ring_flush(faux_log_t *log, faux_log_ring_t *ring)
+{
+	struct iovec iov[FAUX_LOG_IOV_MAX] = {};
+	int iov_num = 0;
+	size_t head = 0;
+	size_t tail = 0;
+	size_t num = 0;
+
+	head = ring->head;
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	while (head != tail) {
+		faux_log_rec_t *rec = (faux_log_rec_t *)
+			(ring->data + (head & (ring->size - 1)));
+		char *text = (char *)rec + sizeof(*rec);
+
+		head += rec->size;
+		if (rec->prio < 0) // Padding
+			continue;
+		num++;
+		if (log->fd < 0) {
+			syslog(rec->prio, "%.*s", (int)(rec->len - 1), text);
+			continue;
+		}
+		iov[iov_num].iov_base = text;
+		iov[iov_num].iov_len = rec->len;
+		iov_num++;
+		if (FAUX_LOG_IOV_MAX == iov_num) {
+			faux_writev_block(log->fd, iov, iov_num);
+			iov_num = 0;
+			// Free space only after data is written
+			__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+		}
+	}
+	if (iov_num > 0)
+		faux_writev_block(log->fd, iov, iov_num);
+	__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+	return num;
+}
+
+
+/** @brief Writes all buffered records.
+ *
+ * Drains rings of all threads. It's used by background thread. If background
+ * thread is not started then user must call this function periodically, for
+ * example by event loop scheduled event.
+ *
+ * @param [in] log Logger object.
+ * @return Number of written records.
+ */
+size_t faux_log_flush(faux_log_t *log)
+{
+	faux_log_ring_t **ring_ptr = NULL;
+	size_t num = 0;
+
+	assert(log);
+	if (!log)
+		return 0;
+
+	pthread_mutex_lock(&log->mutex);
+	ring_ptr = &log->rings;
+	while (*ring_ptr) {
+		faux_log_ring_t *ring = *ring_ptr;
+		// Get flag before flush. Thread can't write after it's finished
+		bool_t orphan = __atomic_load_n(&ring->orphan, __ATOMIC_ACQUIRE);
+
+		// Producer is gone so its pending duplicates can be reported
+		if (orphan)
+			faux_log_ring_repeats(log, ring);
+		num += faux_log_ring_flush(log, ring);
+		if (orphan) {
+			*ring_ptr = ring->next;
+			faux_log_ring_free(ring);
+			continue;
+		}
+		ring_ptr = &ring->next;
+	}
+	pthread_mutex_unlock(&log->mutex);
+
+	return num;
+}
+
+
+/** @brief Service static function. Background flusher thread.
+ *
+ * @param [in] arg Logger object.
+ * @return NULL.
+ */
+static void *faux_log_thread(void *arg)
+{
+	faux_log_t *log = (faux_log_t *)arg;
+
+	while (!__atomic_load_n(&log->stop, __ATOMIC_ACQUIRE)) {
+		struct timespec deadline = {};
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += log->interval / 1000;
+		deadline.tv_nsec += (log->interval % 1000) * 1000000l;
+		if (deadline.tv_nsec >= 1000000000l) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000l;
+		}
+		sem_timedwait(&log->wake, &deadline);
+		__atomic_store_n(&log->wake_pending, BOOL_FALSE,
+			__ATOMIC_RELEASE);
+		faux_log_flush(log);
+	}
+
+	return NULL;
+}
+
+
+/** @brief Starts background flusher thread.
+ *
+ * The thread flushes records periodically or when some ring is half full.
+ *
+ * @param [in] log Logger object.
+ * @param [in] interval Flush interval in msec. 0 - default interval.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_log_start(faux_log_t *log, unsigned int interval)
+{
+	assert(log);
+	if (!log)
+		return BOOL_FALSE;
+	if (log->started)
+		return BOOL_FALSE;
+
+	if (interval > 0)
+		log->interval = interval;
+	if (pthread_create(&log->thread, NULL, faux_log_thread, log) != 0)
+		return BOOL_FALSE;
+	__atomic_store_n(&log->started, BOOL_TRUE, __ATOMIC_RELEASE);
+
+	return BOOL_TRUE;
+}
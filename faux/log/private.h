@@ -0,0 +1,72 @@
+#include <stdint.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "faux/faux.h"
+#include "faux/log.h"
+
+/** @brief Default size of per-thread ring */
+#define FAUX_LOG_RING_SIZE 65536
+
+/** @brief Minimal size of per-thread ring */
+#define FAUX_LOG_RING_MIN_SIZE 4096
+
+/** @brief Max length of record text. Longer text is truncated */
+#define FAUX_LOG_MAX_LEN 1024
+
+/** @brief Default flush interval (msec) of background thread */
+#define FAUX_LOG_FLUSH_INTERVAL 100
+
+/** @brief Max number of records written by single writev() */
+#define FAUX_LOG_IOV_MAX 64
+
+/** @brief Alignment of records within ring */
+#define FAUX_LOG_ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+// Record header. Record text follows header. The text is not
+// '\0'-terminated but ends with '\n'.
+typedef struct faux_log_rec_s {
+	uint32_t size; // Whole record size (aligned)
+	int32_t prio; // Priority. Padding at the end of ring has prio < 0
+	uint32_t len; // Text length including trailing '\n'
+	uint32_t reserved;
+} faux_log_rec_t;
+
+typedef struct faux_log_ring_s faux_log_ring_t;
+
+// Per-thread single producer single consumer ring of records.
+// Positions are monotonic counters. Records are never split.
+struct faux_log_ring_s {
+	char *data;
+	size_t size; // Power of two
+	size_t head; // Read position. Changed by consumer only
+	size_t tail; // Write position. Changed by producer only
+	bool_t orphan; // Producer thread is finished
+	faux_log_ring_t *next;
+	// Deduplication. Changed by producer only
+	const char *last_fmt; // Call site (format) of the last record
+	int last_prio; // Priority of the last record
+	uint64_t last_hash; // Hash of the last record text
+	size_t repeats; // Number of suppressed duplicates of the last record
+};
+
+struct faux_log_s {
+	faux_log_pub_t pub; // Must be the first field. See faux_log_is_enabled()
+	int fd; // Target file descriptor. < 0 for syslog
+	size_t ring_size; // Size of per-thread rings
+	pthread_key_t key; // Thread's ring
+	pthread_mutex_t mutex; // Protects list of rings and serializes flush
+	faux_log_ring_t *rings; // List of rings
+	size_t dropped; // Number of records dropped because ring is full
+	size_t truncated; // Number of truncated records
+	bool_t dedup; // Suppress consecutive duplicates
+	size_t deduped; // Number of suppressed duplicates
+	size_t limited; // Number of records suppressed by rate limit
+	// Background flusher
+	bool_t started;
+	bool_t stop;
+	bool_t wake_pending;
+	unsigned int interval; // Flush interval (msec)
+	pthread_t thread;
+	sem_t wake;
+};
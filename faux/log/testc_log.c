@@ -1,9 +1,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #include "faux/log.h"
 #include "faux/str.h"
+#include "faux/file.h"
+#include "faux/testc_helpers.h"
 
 int testc_faux_log_facility_id(void)
 {
@@ -37,3 +41,244 @@ int testc_faux_log_facility_str(void)
 
 	return 0;
 }
+
+
+#define LOG_THREADS 4
+#define LOG_RECORDS 20000
+
+struct log_thread_s {
+	faux_log_t *log;
+	int id;
+};
+
+static void *log_thread(void *arg)
+{
+	struct log_thread_s *p = (struct log_thread_s *)arg;
+	int i = 0;
+
+	for (i = 0; i < LOG_RECORDS; i++) {
+		// Drop doesn't matter. Check it later
+		FAUX_LOG(p->log, LOG_ERR, "thread %d record %d", p->id, i);
+	}
+
+	return NULL;
+}
+
+static int side_effect(int *counter)
+{
+	(*counter)++;
+	return *counter;
+}
+
+int testc_faux_log_async(void)
+{
+	pthread_t threads[LOG_THREADS];
+	struct log_thread_s params[LOG_THREADS];
+	int last[LOG_THREADS];
+	faux_log_t *log = NULL;
+	char *fn = NULL;
+	faux_file_t *f = NULL;
+	char *line = NULL;
+	char *long_str = NULL;
+	size_t lines = 0;
+	size_t dropped = 0;
+	int counter = 0;
+	int ret = -1; // Pessimistic
+	int i = 0;
+
+	fn = faux_testc_tmpfile_deploy_str("");
+	if (!fn)
+		goto err;
+	f = faux_file_open(fn, O_WRONLY | O_APPEND, 0);
+	if (!f)
+		goto err;
+
+	log = faux_log_new(faux_file_fileno(f), 8192);
+	faux_log_set_level(log, LOG_INFO);
+
+	// Level filtering. Arguments are not evaluated
+	FAUX_LOG(log, LOG_DEBUG, "filtered %d", side_effect(&counter));
+	FAUX_LOG(log, LOG_INFO, "info %d", side_effect(&counter));
+	if (counter != 1) {
+		printf("Arguments of filtered record are evaluated\n");
+		goto err;
+	}
+	// Manual flush
+	if (faux_log_flush(log) != 1) {
+		printf("Can't flush\n");
+		goto err;
+	}
+
+	// Truncation
+	long_str = faux_str_sprintf("%*c", 5000, 'z');
+	faux_log_write(log, LOG_INFO, "%s", long_str);
+	if (faux_log_truncated(log) != 1) {
+		printf("Record is not truncated\n");
+		goto err;
+	}
+
+	// Concurrent writers and background flusher
+	if (!faux_log_start(log, 1)) {
+		printf("Can't start flusher\n");
+		goto err;
+	}
+	for (i = 0; i < LOG_THREADS; i++) {
+		params[i].log = log;
+		params[i].id = i;
+		last[i] = -1;
+		pthread_create(&threads[i], NULL, log_thread, &params[i]);
+	}
+	for (i = 0; i < LOG_THREADS; i++)
+		pthread_join(threads[i], NULL);
+	dropped = faux_log_dropped(log);
+	faux_log_free(log);
+	log = NULL;
+	faux_file_close(f);
+
+	// Check result
+	f = faux_file_open(fn, O_RDONLY, 0);
+	if (!f)
+		goto err;
+	while ((line = faux_file_getline(f))) {
+		int id = 0;
+		int rec = 0;
+		lines++;
+		if (sscanf(line, "thread %d record %d", &id, &rec) != 2) {
+			faux_str_free(line);
+			continue;
+		}
+		faux_str_free(line);
+		if ((id < 0) || (id >= LOG_THREADS) || (rec <= last[id])) {
+			printf("Wrong order of records\n");
+			goto err;
+		}
+		last[id] = rec;
+	}
+	printf("Lines: %lu, dropped: %lu\n", lines, dropped);
+	if (lines + dropped != 2 + LOG_THREADS * LOG_RECORDS) {
+		printf("Too few lines\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_log_free(log);
+	faux_file_close(f);
+	if (fn)
+		unlink(fn);
+	faux_str_free(fn);
+	faux_str_free(long_str);
+
+	return ret;
+}
+
+
+static void *log_dup_thread(void *arg)
+{
+	faux_log_t *log = (faux_log_t *)arg;
+	int i = 0;
+
+	// Thread exits with pending duplicates
+	for (i = 0; i < 5; i++)
+		faux_log_write(log, LOG_ERR, "%s", "thread dup");
+
+	return NULL;
+}
+
+int testc_faux_log_limit(void)
+{
+	const char *etalon[] = {
+		"limited 0",
+		"limited 1",
+		"limited 2",
+		"dup",
+		"last message repeated 9 times",
+		"other",
+		"dup",
+		"thread dup",
+		"last message repeated 4 times",
+		NULL
+		};
+	// The FAUX_LOG_LIMIT_INIT() rate is per second so use explicit values
+	faux_log_limit_t limit = { 0, 3600000000000ull,
+		2 * 3600000000000ull, 0 };
+	faux_log_t *log = NULL;
+	char *fn = NULL;
+	faux_file_t *f = NULL;
+	char *line = NULL;
+	pthread_t thread;
+	int ret = -1; // Pessimistic
+	int i = 0;
+
+	fn = faux_testc_tmpfile_deploy_str("");
+	if (!fn)
+		goto err;
+	f = faux_file_open(fn, O_WRONLY | O_APPEND, 0);
+	if (!f)
+		goto err;
+	log = faux_log_new(faux_file_fileno(f), 0);
+
+	// Rate limit. Burst of 3 records and then 1 record per hour. So the
+	// loop can't get new token while running
+	for (i = 0; i < 1000; i++)
+		faux_log_write_limited(log, &limit, LOG_ERR, "limited %d", i);
+	if (faux_log_limited(log) != 997) {
+		printf("Wrong number of limited records: %lu\n",
+			faux_log_limited(log));
+		goto err;
+	}
+
+	// Deduplication
+	faux_log_set_dedup(log, BOOL_TRUE);
+	for (i = 0; i < 10; i++)
+		faux_log_write(log, LOG_ERR, "%s", "dup");
+	faux_log_write(log, LOG_ERR, "other");
+	faux_log_write(log, LOG_ERR, "%s", "dup");
+	if (faux_log_deduped(log) != 9) {
+		printf("Wrong number of duplicates: %lu\n",
+			faux_log_deduped(log));
+		goto err;
+	}
+
+	// Duplicates of finished thread are reported when its ring is freed
+	faux_log_flush(log);
+	if (pthread_create(&thread, NULL, log_dup_thread, log) != 0)
+		goto err;
+	pthread_join(thread, NULL);
+	faux_log_flush(log);
+	if (faux_log_deduped(log) != 13) {
+		printf("Wrong number of thread duplicates: %lu\n",
+			faux_log_deduped(log));
+		goto err;
+	}
+	faux_log_free(log);
+	log = NULL;
+	faux_file_close(f);
+
+	// Check result
+	f = faux_file_open(fn, O_RDONLY, 0);
+	if (!f)
+		goto err;
+	for (i = 0; (line = faux_file_getline(f)); i++) {
+		int rc = etalon[i] ? strcmp(etalon[i], line) : -1;
+		if (rc)
+			printf("Line %d: [%s]\n", i, line);
+		faux_str_free(line);
+		if (rc)
+			goto err;
+	}
+	if (etalon[i]) {
+		printf("Too few lines\n");
+		goto err;
+	}
+
+	ret = 0;
+err:
+	faux_log_free(log);
+	faux_file_close(f);
+	if (fn)
+		unlink(fn);
+	faux_str_free(fn);
+
+	return ret;
+}
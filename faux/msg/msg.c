@@ -28,6 +28,7 @@
 
 #include <faux/faux.h>
 #include <faux/str.h>
+#include <faux/conv.h>
 #include <faux/list.h>
 #include <faux/net.h>
 #include <faux/async.h>
@@ -937,6 +938,31 @@ faux_msg_t *faux_msg_recv(faux_net_t *faux_net)
 }
 
 
+#ifdef DEBUG
+/** @brief Appends string to debug line.
+ *
+ * Static function. The line is always null-terminated. The string is
+ * truncated if there is not enough space.
+ *
+ * @param [in] p Current position within line.
+ * @param [in] end End of line buffer.
+ * @param [in] str String to append.
+ * @return New position within line.
+ */
+static char *faux_msg_debug_str(char *p, const char *end, const char *str)
+{
+	while ((*str != '\0') && (p < (end - 1))) {
+		*p = *str;
+		p++;
+		str++;
+	}
+	*p = '\0';
+
+	return p;
+}
+#endif
+
+
 /** @brief Prints message debug info.
  *
  * Function prints header values and parameters.
@@ -951,32 +977,48 @@ void faux_msg_debug(const faux_msg_t *msg)
 	void *param_data = NULL;
 	uint16_t param_type = 0;
 	uint32_t param_len = 0;
+	// The line is formatted without printf() to keep debug output cheap.
+	// Each part is bounded by the remaining length of line
+	char line[128] = {};
+	char *p = line;
+	char *end = line + sizeof(line);
 
 	assert(msg);
 	if (!msg)
 		return;
 
-	// Header
-	printf("%x(%u.%u): c%04x s%08x i%08x p%u l%u |%lub\n",
-		faux_msg_get_magic(msg),
-		faux_msg_get_major(msg),
-		faux_msg_get_minor(msg),
-		faux_msg_get_cmd(msg),
-		faux_msg_get_status(msg),
-		faux_msg_get_req_id(msg),
-		faux_msg_get_param_num(msg),
-		faux_msg_get_len(msg),
-		sizeof(*msg->hdr)
-		);
-
-	// Parameters
+	// Header. Format is "%x(%u.%u): c%04x s%08x i%08x p%u l%u |%lub"
+	p += faux_conv_hex(faux_msg_get_magic(msg), 0, p, end - p);
+	p = faux_msg_debug_str(p, end, "(");
+	p += faux_conv_ultoa(faux_msg_get_major(msg), p, end - p);
+	p = faux_msg_debug_str(p, end, ".");
+	p += faux_conv_ultoa(faux_msg_get_minor(msg), p, end - p);
+	p = faux_msg_debug_str(p, end, "): c");
+	p += faux_conv_hex(faux_msg_get_cmd(msg), 4, p, end - p);
+	p = faux_msg_debug_str(p, end, " s");
+	p += faux_conv_hex(faux_msg_get_status(msg), 8, p, end - p);
+	p = faux_msg_debug_str(p, end, " i");
+	p += faux_conv_hex(faux_msg_get_req_id(msg), 8, p, end - p);
+	p = faux_msg_debug_str(p, end, " p");
+	p += faux_conv_ultoa(faux_msg_get_param_num(msg), p, end - p);
+	p = faux_msg_debug_str(p, end, " l");
+	p += faux_conv_ultoa(faux_msg_get_len(msg), p, end - p);
+	p = faux_msg_debug_str(p, end, " |");
+	p += faux_conv_ultoa(sizeof(*msg->hdr), p, end - p);
+	faux_msg_debug_str(p, end, "b\n");
+	fputs(line, stdout);
+
+	// Parameters. Format is "  t%04x l%u |%lub"
 	iter = faux_msg_init_param_iter(msg);
 	while (faux_msg_get_param_each(&iter, &param_type, &param_data, &param_len)) {
-		printf("  t%04x l%u |%lub\n",
-			param_type,
-			param_len,
-			sizeof(faux_phdr_t) + param_len
-			);
+		p = faux_msg_debug_str(line, end, "  t");
+		p += faux_conv_hex(param_type, 4, p, end - p);
+		p = faux_msg_debug_str(p, end, " l");
+		p += faux_conv_ultoa(param_len, p, end - p);
+		p = faux_msg_debug_str(p, end, " |");
+		p += faux_conv_ultoa(sizeof(faux_phdr_t) + param_len, p, end - p);
+		faux_msg_debug_str(p, end, "b\n");
+		fputs(line, stdout);
 	}
 }
 #else
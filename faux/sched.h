@@ -37,10 +37,13 @@ faux_sched_periodic_e faux_ev_is_periodic(const faux_ev_t *ev);
 bool_t faux_ev_time_left(const faux_ev_t *ev, struct timespec *left);
 int faux_ev_id(const faux_ev_t *ev);
 void *faux_ev_data(const faux_ev_t *ev);
+bool_t faux_ev_set_slack(faux_ev_t *ev, const struct timespec *slack);
+const struct timespec *faux_ev_slack(const faux_ev_t *ev);
 
 // Time event scheduler
 faux_sched_t *faux_sched_new(void);
 void faux_sched_free(faux_sched_t *sched);
+bool_t faux_sched_set_slack(faux_sched_t *sched, const struct timespec *slack);
 bool_t faux_sched_add(faux_sched_t *sched, faux_ev_t *ev);
 faux_ev_t *faux_sched_once(
 	faux_sched_t *sched, const struct timespec *time, int ev_id, void *data);
@@ -55,6 +58,8 @@ faux_ev_t *faux_sched_periodic_delayed(
 bool_t faux_sched_next_interval(const faux_sched_t *sched, struct timespec *interval);
 void faux_sched_del_all(faux_sched_t *sched);
 faux_ev_t *faux_sched_pop(faux_sched_t *sched);
+ssize_t faux_sched_pop_batch(faux_sched_t *sched,
+	faux_ev_t **evs, size_t max_num);
 ssize_t faux_sched_del(faux_sched_t *sched, faux_ev_t *ev);
 ssize_t faux_sched_del_by_id(faux_sched_t *sched, int id);
 ssize_t faux_sched_del_by_data(faux_sched_t *sched, void *data);
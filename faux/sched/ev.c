@@ -113,6 +113,8 @@ faux_ev_t *faux_ev_new(int ev_id, void *data)
 	faux_nsec_to_timespec(&(ev->period), 0l);
 	faux_ev_reschedule(ev, FAUX_SCHED_NOW);
 	ev->busy = BOOL_FALSE;
+	ev->own_slack = BOOL_FALSE; // Use sched's slack by default
+	faux_nsec_to_timespec(&(ev->slack), 0l);
 
 	return ev;
 }
@@ -337,6 +339,9 @@ bool_t faux_ev_reschedule(faux_ev_t *ev, const struct timespec *new_time)
 	} else { // Time isn't given so use "NOW"
 		faux_timespec_now(&(ev->time));
 	}
+	// Periods are counted from new time
+	ev->anchor = ev->time;
+	ev->period_num = 0;
 
 	return BOOL_TRUE;
 }
@@ -344,28 +349,50 @@ bool_t faux_ev_reschedule(faux_ev_t *ev, const struct timespec *new_time)
 
 /** Reschedules existent event using period.
  *
- * New scheduled time is calculated as "now" + "period".
- * Function decrements number of cycles. If number of cycles is
- * FAUX_SCHED_INFINITE then number of cycles will not be decremented.
+ * New scheduled time is calculated as "anchor" + N * "period" where anchor
+ * is the time of first cycle and N is a number of passed periods. So
+ * callback execution time and late pops don't shift the next cycles.
+ * The new time is the first deadline after now. If some deadlines were
+ * missed (the event was popped too late) then they are skipped.
+ * Function decrements number of cycles by one i.e. number of cycles is a
+ * number of fired events. If number of cycles is FAUX_SCHED_INFINITE then
+ * number of cycles will not be decremented.
  * Private function. Only scheduler can use it.
  *
  * @param [in] ev Allocated and initialized ev object.
+ * @param [in] now Current time.
  * @return BOOL_TRUE - success, BOOL_FALSE on error.
  */
-bool_t faux_ev_reschedule_period(faux_ev_t *ev)
+bool_t faux_ev_reschedule_period(faux_ev_t *ev, const struct timespec *now)
 {
-	struct timespec new_time = {};
+	uint64_t anchor = 0;
+	uint64_t period = 0;
+	uint64_t now_nsec = 0;
+	uint64_t period_num = 0;
 
 	assert(ev);
-	if (!ev)
+	assert(now);
+	if (!ev || !now)
 		return BOOL_FALSE;
 	if (!faux_ev_is_periodic(ev))
 		return BOOL_FALSE;
 	if (ev->cycle_num <= 1)
 		return BOOL_FALSE; // We don't need to reschedule if last cycle left
 
-	faux_timespec_sum(&new_time, &(ev->time), &(ev->period));
-	faux_ev_reschedule(ev, &new_time);
+	anchor = faux_timespec_to_nsec(&(ev->anchor));
+	period = faux_timespec_to_nsec(&(ev->period));
+	now_nsec = faux_timespec_to_nsec(now);
+
+	// First deadline after now
+	period_num = ev->period_num + 1;
+	if ((period > 0) && (now_nsec >= anchor)) {
+		uint64_t next_num = (now_nsec - anchor) / period + 1;
+		if (next_num > period_num)
+			period_num = next_num;
+	}
+	ev->period_num = period_num;
+	// Don't use faux_ev_reschedule() because it resets anchor
+	faux_nsec_to_timespec(&(ev->time), anchor + period_num * period);
 
 	if (ev->cycle_num != FAUX_SCHED_INFINITE)
 		faux_ev_dec_cycles(ev, NULL);
@@ -430,3 +457,50 @@ void *faux_ev_data(const faux_ev_t *ev)
 }
 
 
+/** @brief Sets event's own slack.
+ *
+ * The slack is an allowed delay of event. Scheduler can fire event later
+ * than planned time but not later than "time + slack". So scheduler can
+ * coalesce events with near deadlines and wake up once for all of them.
+ * Event is never fired before planned time. By default event uses slack
+ * of scheduler. See faux_sched_set_slack().
+ *
+ * @param [in] ev Allocated and initialized ev object.
+ * @param [in] slack Slack value. NULL - use scheduler's slack.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_ev_set_slack(faux_ev_t *ev, const struct timespec *slack)
+{
+	assert(ev);
+	if (!ev)
+		return BOOL_FALSE;
+
+	// Slack doesn't influence the order of events so busy (scheduled)
+	// event can be changed too
+	if (!slack) {
+		ev->own_slack = BOOL_FALSE;
+		faux_nsec_to_timespec(&(ev->slack), 0l);
+		return BOOL_TRUE;
+	}
+	ev->own_slack = BOOL_TRUE;
+	ev->slack = *slack;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Returns event's own slack.
+ *
+ * @param [in] ev Allocated and initialized ev object.
+ * @return Pointer to slack or NULL if event uses scheduler's slack.
+ */
+const struct timespec *faux_ev_slack(const faux_ev_t *ev)
+{
+	assert(ev);
+	if (!ev)
+		return NULL;
+	if (!ev->own_slack)
+		return NULL;
+
+	return &(ev->slack);
+}
@@ -1,3 +1,5 @@
+#include <stdint.h>
+
 #include "faux/faux.h"
 #include "faux/list.h"
 #include "faux/time.h"
@@ -6,6 +8,8 @@
 
 struct faux_ev_s {
 	struct timespec time; // Planned time of event
+	struct timespec anchor; // Time of first cycle of periodic event
+	uint64_t period_num; // Number of periods passed since anchor
 	struct timespec period; // Period for periodic event
 	unsigned int cycle_num; // Number of cycles for periodic event
 	faux_sched_periodic_e periodic; // Periodic flag
@@ -13,11 +17,14 @@ struct faux_ev_s {
 	void *data; // Arbitrary data linked to event
 	faux_list_free_fn free_data_cb; // Callback to free user data
 	bool_t busy;
+	bool_t own_slack; // Event has its own slack. Else sched's one is used
+	struct timespec slack; // Allowed delay of event to coalesce wakeups
 };
 
 
 struct faux_sched_s {
 	faux_list_t *list;
+	struct timespec slack; // Default slack for events
 };
 
 
@@ -32,6 +39,7 @@ FAUX_HIDDEN void faux_ev_free_forced(void *ptr);
 FAUX_HIDDEN void faux_ev_set_busy(faux_ev_t *ev, bool_t busy);
 FAUX_HIDDEN bool_t faux_ev_dec_cycles(faux_ev_t *ev, unsigned int *new_cycle_num);
 FAUX_HIDDEN bool_t faux_ev_reschedule(faux_ev_t *ev, const struct timespec *new_time);
-FAUX_HIDDEN bool_t faux_ev_reschedule_period(faux_ev_t *ev);
+FAUX_HIDDEN bool_t faux_ev_reschedule_period(faux_ev_t *ev,
+	const struct timespec *now);
 
 C_DECL_END
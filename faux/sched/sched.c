@@ -10,6 +10,10 @@
  * User can get interval from now to next event time. User can get upcoming
  * events one-by-one.
  *
+ * Events can have slack i.e. allowed delay. The interval to next wakeup
+ * is calculated using slacks so events with near deadlines are fired at
+ * once by single wakeup.
+ *
  * Each scheduled event can has arbitrary ID and pointer to arbitrary data
  * linked to this event. The ID can be used for type of event for
  * example or something else. The linked data can be a service structure.
@@ -19,6 +23,7 @@
 #include <time.h>
 #include <errno.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <assert.h>
 
 #include "private.h"
@@ -45,6 +50,7 @@ faux_sched_t *faux_sched_new(void)
 	// Init
 	sched->list = faux_list_new(FAUX_LIST_SORTED, FAUX_LIST_NONUNIQUE,
 		faux_ev_compare, NULL, faux_ev_free_forced);
+	faux_nsec_to_timespec(&(sched->slack), 0l);
 
 	return sched;
 }
@@ -65,6 +71,49 @@ void faux_sched_free(faux_sched_t *sched)
 }
 
 
+/** @brief Sets default slack for events.
+ *
+ * The slack is used for events that have no own slack. See
+ * faux_ev_set_slack(). Zero slack (default) means no coalescing.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] slack Slack value. NULL - zero slack.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sched_set_slack(faux_sched_t *sched, const struct timespec *slack)
+{
+	assert(sched);
+	if (!sched)
+		return BOOL_FALSE;
+
+	if (slack)
+		sched->slack = *slack;
+	else
+		faux_nsec_to_timespec(&(sched->slack), 0l);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Calculates the latest allowed time of event.
+ *
+ * Static function. It's planned time plus slack.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] ev Event object.
+ * @param [out] deadline Calculated deadline.
+ */
+static void faux_sched_ev_deadline(const faux_sched_t *sched,
+	const faux_ev_t *ev, struct timespec *deadline)
+{
+	const struct timespec *slack = faux_ev_slack(ev);
+
+	if (!slack)
+		slack = &(sched->slack);
+	faux_timespec_sum(deadline, faux_ev_time(ev), slack);
+}
+
+
 /** @brief Adds time event (faux_ev_t) to scheduling list.
  *
  * @param [in] sched Allocated and initialized sched object.
@@ -223,6 +272,10 @@ faux_ev_t *faux_sched_periodic_delayed(
  * If event is in the past then return null interval.
  * If no events was scheduled then return BOOL_FALSE.
  *
+ * The slacks are taken into account. The next wakeup time is the earliest
+ * "time + slack" among events. All the events planned before this moment
+ * will be popped at once.
+ *
  * @param [in] sched Allocated and initialized sched object.
  * @param [out] interval Calculated interval.
  * @return BOOL_TRUE - success, BOOL_FALSE on error or there is no scheduled events.
@@ -231,6 +284,8 @@ bool_t faux_sched_next_interval(const faux_sched_t *sched, struct timespec *inte
 {
 	faux_ev_t *ev = NULL;
 	faux_list_node_t *iter = NULL;
+	struct timespec wakeup = {};
+	struct timespec now = {};
 
 	assert(sched);
 	assert(interval);
@@ -240,10 +295,27 @@ bool_t faux_sched_next_interval(const faux_sched_t *sched, struct timespec *inte
 	iter = faux_list_head(sched->list);
 	if (!iter)
 		return BOOL_FALSE;
-	ev = (faux_ev_t *)faux_list_data(iter);
+	ev = (faux_ev_t *)faux_list_each(&iter);
+	faux_sched_ev_deadline(sched, ev, &wakeup);
+
+	// The list is sorted by time. So the events planned after current
+	// wakeup time can't make wakeup time earlier.
+	while ((ev = (faux_ev_t *)faux_list_each(&iter))) {
+		struct timespec deadline = {};
+
+		if (faux_timespec_cmp(faux_ev_time(ev), &wakeup) >= 0)
+			break;
+		faux_sched_ev_deadline(sched, ev, &deadline);
+		if (faux_timespec_cmp(&deadline, &wakeup) < 0)
+			wakeup = deadline;
+	}
 
-	if (!faux_ev_time_left(ev, interval))
-		return BOOL_FALSE;
+	faux_timespec_now(&now);
+	if (faux_timespec_cmp(&now, &wakeup) > 0) { // Already happened
+		faux_nsec_to_timespec(interval, 0l);
+		return BOOL_TRUE;
+	}
+	faux_timespec_diff(interval, &wakeup, &now);
 
 	return BOOL_TRUE;
 }
@@ -280,6 +352,7 @@ faux_ev_t *faux_sched_pop(faux_sched_t *sched)
 {
 	faux_list_node_t *iter = NULL;
 	faux_ev_t *ev = NULL;
+	struct timespec now = {};
 
 	assert(sched);
 	if (!sched)
@@ -289,18 +362,129 @@ faux_ev_t *faux_sched_pop(faux_sched_t *sched)
 	if (!iter)
 		return NULL;
 	ev = (faux_ev_t *)faux_list_data(iter);
-	if (!faux_timespec_before_now(faux_ev_time(ev)))
+	faux_timespec_now(&now);
+	if (faux_timespec_cmp(faux_ev_time(ev), &now) > 0)
 		return NULL; // No events for this time
 	faux_list_takeaway(sched->list, iter); // Remove entry from list
 	faux_ev_set_busy(ev, BOOL_FALSE);
 
-	if (faux_ev_reschedule_period(ev))
+	if (faux_ev_reschedule_period(ev, &now))
 		faux_sched_add(sched, ev);
 
 	return ev;
 }
 
 
+/** @brief Compares events for qsort().
+ *
+ * Static function.
+ *
+ * @param [in] first Pointer to pointer to first event.
+ * @param [in] second Pointer to pointer to second event.
+ * @return Same as faux_ev_compare().
+ */
+static int faux_sched_ev_qsort_cmp(const void *first, const void *second)
+{
+	return faux_ev_compare(*(faux_ev_t * const *)first,
+		*(faux_ev_t * const *)second);
+}
+
+
+/** @brief Reschedules periodic events of popped batch.
+ *
+ * Static function. The single sorted list insertion searches for the
+ * position so reinsertion of many events one-by-one is expensive. The
+ * rescheduled events are sorted and merged into the list by single pass.
+ * The popped events stay in original order within user's array.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [in] evs Popped events.
+ * @param [in] num Number of popped events.
+ * @param [in] now Current time.
+ */
+static void faux_sched_reschedule_batch(faux_sched_t *sched,
+	faux_ev_t **evs, size_t num, const struct timespec *now)
+{
+	faux_ev_t **periodic = NULL;
+	size_t periodic_num = 0;
+	ssize_t added = 0;
+	size_t i = 0;
+
+	// Sorting is useless for single event. Also the events are added
+	// one-by-one if there is no memory for sorting.
+	if (num > 1)
+		periodic = faux_zmalloc(num * sizeof(*periodic));
+
+	for (i = 0; i < num; i++) {
+		if (!faux_ev_reschedule_period(evs[i], now))
+			continue;
+		if (periodic)
+			periodic[periodic_num++] = evs[i];
+		else
+			faux_sched_add(sched, evs[i]);
+	}
+	if (!periodic)
+		return;
+
+	qsort(periodic, periodic_num, sizeof(*periodic),
+		faux_sched_ev_qsort_cmp);
+	added = faux_list_add_batch(sched->list, (void **)periodic,
+		periodic_num);
+	for (i = 0; (ssize_t)i < added; i++)
+		faux_ev_set_busy(periodic[i], BOOL_TRUE);
+
+	faux_free(periodic);
+}
+
+
+/** @brief Pop all already coming events from list at once.
+ *
+ * It's a batch version of faux_sched_pop(). The current time is got once
+ * for the whole batch. Periodic events are rescheduled after all coming
+ * events are taken away. So each event is popped once per batch. The busy
+ * flag has the same meaning as for faux_sched_pop().
+ *
+ * Note the rescheduled (busy) event can be deleted from scheduler while
+ * user processes the previous events of batch.
+ *
+ * @param [in] sched Allocated and initialized sched object.
+ * @param [out] evs Array to store popped events.
+ * @param [in] max_num Max number of events to pop (size of evs array).
+ * @return Number of popped events or < 0 on error.
+ */
+ssize_t faux_sched_pop_batch(faux_sched_t *sched,
+	faux_ev_t **evs, size_t max_num)
+{
+	faux_list_node_t *iter = NULL;
+	struct timespec now = {};
+	size_t num = 0;
+
+	assert(sched);
+	assert(evs);
+	if (!sched || !evs)
+		return -1;
+
+	faux_timespec_now(&now);
+
+	// The list is sorted so coming events are at the list head
+	while ((num < max_num) && (iter = faux_list_head(sched->list))) {
+		faux_ev_t *ev = (faux_ev_t *)faux_list_data(iter);
+
+		if (faux_timespec_cmp(faux_ev_time(ev), &now) > 0)
+			break; // No events for this time
+		faux_list_takeaway(sched->list, iter); // Remove entry from list
+		faux_ev_set_busy(ev, BOOL_FALSE);
+		evs[num] = ev;
+		num++;
+	}
+
+	// Reinsert periodic events
+	faux_sched_reschedule_batch(sched, evs, num, &now);
+
+	return num;
+}
+
+
 /** @brief Deletes all events with specified value from list.
  *
  * Static function.
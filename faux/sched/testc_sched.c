@@ -195,3 +195,225 @@ int testc_faux_sched_infinite(void)
 
 	return 0;
 }
+
+
+int testc_faux_sched_slack(void)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec slack = {0, 300000000l}; // 300ms
+	struct timespec first = {0, 100000000l}; // 100ms
+	struct timespec second = {0, 350000000l}; // 350ms
+	struct timespec twait = {};
+	faux_ev_t *ev = NULL;
+
+	sched = faux_sched_new();
+	if (!sched)
+		return -1;
+	faux_sched_set_slack(sched, &slack);
+
+	faux_sched_once_delayed(sched, &first, 1, NULL);
+	faux_sched_once_delayed(sched, &second, 2, NULL);
+	// The wakeup is "first + slack" i.e. 400ms. Second event is planned
+	// earlier so both events will be fired by single wakeup.
+	if (!faux_sched_next_interval(sched, &twait))
+		return -1;
+	if (faux_timespec_cmp(&twait, &second) <= 0) {
+		printf("faux_sched_next_interval: Slack is not used\n");
+		return -1;
+	}
+	nanosleep(&twait, NULL); // wait
+	if (!(ev = faux_sched_pop(sched)) || (faux_ev_id(ev) != 1)) {
+		printf("faux_shed_pop: Can't get first event\n");
+		return -1;
+	}
+	faux_ev_free(ev);
+	if (!(ev = faux_sched_pop(sched)) || (faux_ev_id(ev) != 2)) {
+		printf("faux_shed_pop: Can't get second event\n");
+		return -1;
+	}
+	faux_ev_free(ev);
+
+	// Event's own slack overrides sched's one
+	ev = faux_sched_once_delayed(sched, &first, 3, NULL);
+	faux_ev_set_slack(ev, &(struct timespec){0, 0});
+	if (!faux_sched_next_interval(sched, &twait))
+		return -1;
+	if (faux_timespec_cmp(&twait, &first) > 0) {
+		printf("faux_sched_next_interval: Own slack is not used\n");
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
+
+
+int testc_faux_sched_pop_batch(void)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec period = {0, 100000000l}; // 100ms
+	struct timespec anchor = {};
+	struct timespec before = {};
+	struct timespec period3 = {};
+	uint64_t shift = 0;
+	faux_ev_t *evs[8] = {};
+	faux_ev_t *periodic = NULL;
+	faux_ev_t *ev = NULL;
+	faux_ev_t *prev = NULL;
+	faux_list_node_t *iter = NULL;
+	ssize_t num = 0;
+	ssize_t i = 0;
+
+	sched = faux_sched_new();
+	if (!sched)
+		return -1;
+
+	faux_sched_once(sched, FAUX_SCHED_NOW, 1, NULL);
+	faux_sched_once(sched, FAUX_SCHED_NOW, 2, NULL);
+	faux_sched_once(sched, FAUX_SCHED_NOW, 3, NULL);
+	periodic = faux_sched_periodic_delayed(sched, 4, NULL, &period,
+		FAUX_SCHED_INFINITE);
+	anchor = *faux_ev_time(periodic);
+
+	nanosleep(&period, NULL); // wait
+	faux_timespec_now(&before);
+	num = faux_sched_pop_batch(sched, evs, sizeof(evs) / sizeof(evs[0]));
+	if (num != 4) {
+		printf("faux_sched_pop_batch: Popped %zd events\n", num);
+		return -1;
+	}
+	for (i = 0; i < num; i++) {
+		if (faux_ev_id(evs[i]) != (i + 1)) {
+			printf("faux_sched_pop_batch: Wrong order\n");
+			return -1;
+		}
+	}
+	// Periodic event is rescheduled once per batch
+	if (!faux_ev_is_busy(periodic)) {
+		printf("faux_sched_pop_batch: Periodic event is not rescheduled\n");
+		return -1;
+	}
+	// Oversleep skips missed periods. So the next deadline is
+	// anchor + k * period where k >= 1 and it's after pop time.
+	shift = faux_timespec_to_nsec(faux_ev_time(periodic)) -
+		faux_timespec_to_nsec(&anchor);
+	if ((faux_timespec_cmp(faux_ev_time(periodic), &anchor) <= 0) ||
+		(shift % faux_timespec_to_nsec(&period) != 0)) {
+		printf("faux_sched_pop_batch: Periodic event drifts\n");
+		return -1;
+	}
+	if (faux_timespec_cmp(faux_ev_time(periodic), &before) <= 0) {
+		printf("faux_sched_pop_batch: Periodic event is in the past\n");
+		return -1;
+	}
+	for (i = 0; i < 3; i++)
+		faux_ev_free(evs[i]);
+
+	// Limited batch
+	faux_sched_once(sched, FAUX_SCHED_NOW, 5, NULL);
+	faux_sched_once(sched, FAUX_SCHED_NOW, 6, NULL);
+	num = faux_sched_pop_batch(sched, evs, 1);
+	if ((num != 1) || (faux_ev_id(evs[0]) != 5)) {
+		printf("faux_sched_pop_batch: Limit is not used\n");
+		return -1;
+	}
+	faux_ev_free(evs[0]);
+
+	// Several periodic events are merged into the list at once
+	faux_timespec_sum(&period3, &period, &period);
+	faux_timespec_sum(&period3, &period3, &period);
+	faux_sched_periodic(sched, FAUX_SCHED_NOW, 7, NULL, &period3, 2);
+	faux_sched_periodic(sched, FAUX_SCHED_NOW, 8, NULL, &period, 2);
+	faux_sched_periodic(sched, FAUX_SCHED_NOW, 9, NULL, &period3, 2);
+	num = faux_sched_pop_batch(sched, evs, sizeof(evs) / sizeof(evs[0]));
+	if (num != 4) {
+		printf("faux_sched_pop_batch: Popped %zd events\n", num);
+		return -1;
+	}
+	faux_ev_free(evs[0]); // Event 6
+	iter = faux_sched_init_ev_iter(sched);
+	i = 0;
+	while ((ev = (faux_ev_t *)faux_list_each(&iter))) {
+		if (prev && (faux_timespec_cmp(faux_ev_time(prev),
+			faux_ev_time(ev)) > 0)) {
+			printf("faux_sched_pop_batch: Rescheduled events are "
+				"not sorted\n");
+			return -1;
+		}
+		prev = ev;
+		i++;
+	}
+	if (i != 4) {
+		printf("faux_sched_pop_batch: Scheduled %zd events\n", i);
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
+
+
+int testc_faux_sched_skip(void)
+{
+	faux_sched_t *sched = NULL;
+	struct timespec period = {1, 0}; // 1s
+	struct timespec now = {};
+	struct timespec anchor = {};
+	struct timespec expected = {};
+	faux_ev_t *ev = NULL;
+	faux_ev_t *infinite = NULL;
+	faux_ev_t *finite = NULL;
+	faux_ev_t *last = NULL;
+	unsigned int i = 0;
+
+	sched = faux_sched_new();
+	if (!sched)
+		return -1;
+
+	// The anchor is five and a half periods ago
+	faux_timespec_now(&now);
+	faux_nsec_to_timespec(&anchor, faux_timespec_to_nsec(&now) -
+		(11 * faux_timespec_to_nsec(&period)) / 2);
+	infinite = faux_sched_periodic(sched, &anchor, 1, NULL, &period,
+		FAUX_SCHED_INFINITE);
+	finite = faux_sched_periodic(sched, &anchor, 2, NULL, &period, 8);
+	last = faux_sched_periodic(sched, &anchor, 3, NULL, &period, 2);
+
+	// Each event fires once for all the missed periods
+	for (i = 0; i < 3; i++) {
+		ev = faux_sched_pop(sched);
+		if (!ev) {
+			printf("faux_sched_pop: Not all events are popped\n");
+			return -1;
+		}
+	}
+	if (faux_sched_pop(sched)) {
+		printf("faux_sched_pop: Missed periods are popped\n");
+		return -1;
+	}
+
+	// Next deadline is the first one after now
+	faux_nsec_to_timespec(&expected, faux_timespec_to_nsec(&anchor) +
+		6 * faux_timespec_to_nsec(&period));
+	if (faux_timespec_cmp(faux_ev_time(infinite), &expected) != 0) {
+		printf("faux_sched_pop: Wrong next deadline\n");
+		return -1;
+	}
+
+	// Skipped periods are not charged against number of cycles. Only
+	// fired events are counted.
+	if (!faux_ev_is_busy(finite)) {
+		printf("faux_sched_pop: Finite event is not rescheduled\n");
+		return -1;
+	}
+	if (!faux_ev_is_busy(last)) {
+		printf("faux_sched_pop: Skipped periods are charged\n");
+		return -1;
+	}
+
+	faux_sched_free(sched);
+
+	return 0;
+}
@@ -15,6 +15,13 @@
 #define UTF8_11   0xC0 // First UTF8 byte
 #define UTF8_10   0x80 // Next UTF8 bytes
 
+typedef struct faux_strbuf_s faux_strbuf_t;
+typedef struct faux_intern_s faux_intern_t;
+
+// Flags for faux_intern_new()
+#define FAUX_INTERN_ARENA 0x01 // Store strings within arena chunks
+#define FAUX_INTERN_THREAD_SAFE 0x02 // Pool is protected by mutex
+
 C_DECL_BEGIN
 
 void faux_str_free(char *str);
@@ -36,6 +43,7 @@ int faux_str_cmp(const char *str1, const char *str2);
 int faux_str_casecmpn(const char *str1, const char *str2, size_t n);
 int faux_str_casecmp(const char *str1, const char *str2);
 int faux_str_numcmp(const char *str1, const char *str2);
+char *faux_str_numkey(const char *str);
 char *faux_str_casestr(const char *haystack, const char *needle);
 char *faux_str_charsn(const char *str, const char *chars_to_search, size_t n);
 char *faux_str_chars(const char *str, const char *chars_to_search);
@@ -49,9 +57,35 @@ char *faux_str_c_bin(const char *src, size_t n);
 
 char *faux_str_nextword(const char *str, const char **saveptr,
 	const char *alt_quotes, bool_t *qclosed);
+ssize_t faux_str_nextword_buf(const char *str, const char **saveptr,
+	const char *alt_quotes, bool_t *qclosed, char *buf);
 char *faux_str_getline(const char *str, const char **saveptr);
 bool_t faux_str_unclosed_quotes(const char *str, const char *alt_quotes);
 
+// String builder
+faux_strbuf_t *faux_strbuf_new(size_t reserve);
+void faux_strbuf_free(faux_strbuf_t *sb);
+char *faux_strbuf_detach(faux_strbuf_t *sb);
+const char *faux_strbuf_str(const faux_strbuf_t *sb);
+size_t faux_strbuf_len(const faux_strbuf_t *sb);
+void faux_strbuf_reset(faux_strbuf_t *sb);
+bool_t faux_strbuf_reserve(faux_strbuf_t *sb, size_t add_len);
+bool_t faux_strbuf_appendn(faux_strbuf_t *sb, const char *text, size_t n);
+bool_t faux_strbuf_append(faux_strbuf_t *sb, const char *text);
+bool_t faux_strbuf_appendc(faux_strbuf_t *sb, char c);
+bool_t faux_strbuf_vprintf(faux_strbuf_t *sb, const char *fmt, va_list ap);
+bool_t faux_strbuf_printf(faux_strbuf_t *sb, const char *fmt, ...);
+bool_t faux_strbuf_append_escaped(faux_strbuf_t *sb, const char *text,
+	bool_t escape_space);
+
+// String interning
+faux_intern_t *faux_intern_new(unsigned int flags);
+void faux_intern_free(faux_intern_t *pool);
+const char *faux_intern(faux_intern_t *pool, const char *str);
+const char *faux_intern_n(faux_intern_t *pool, const char *str, size_t len);
+const char *faux_intern_find(faux_intern_t *pool, const char *str);
+size_t faux_intern_num(const faux_intern_t *pool);
+
 C_DECL_END
 
 #endif				/* _faux_str_h */
@@ -0,0 +1,359 @@
+/** @file intern.c
+ * @brief String interning pool.
+ *
+ * The pool returns canonical pointer for each unique string. So equal
+ * interned strings can be compared by pointers and memory for repeated
+ * strings is shared. The strings are indexed by open addressing hash
+ * table. The strings can be stored within large chunks (arena) instead of
+ * allocating each string separately. The interned strings live until the
+ * pool is freed.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "faux/faux.h"
+#include "faux/str.h"
+
+// Initial number of hash table slots. Must be power of two
+#define INTERN_SLOTS 64
+// Size of arena chunk
+#define INTERN_CHUNK 4096
+
+typedef struct {
+	uint64_t hash;
+	const char *str; // NULL for empty slot
+} faux_intern_slot_t;
+
+typedef struct faux_intern_chunk_s faux_intern_chunk_t;
+
+struct faux_intern_chunk_s {
+	faux_intern_chunk_t *next;
+	size_t len; // Used space
+	size_t size; // Size of data
+	char data[];
+};
+
+struct faux_intern_s {
+	unsigned int flags;
+	faux_intern_slot_t *slots;
+	size_t slots_num; // Power of two
+	size_t num; // Number of interned strings
+	faux_intern_chunk_t *chunks; // Arena. The first chunk is current
+	pthread_mutex_t mutex;
+};
+
+
+/** @brief Creates new string interning pool.
+ *
+ * @param [in] flags Combination of FAUX_INTERN_ARENA (store strings within
+ * arena chunks) and FAUX_INTERN_THREAD_SAFE (pool can be used by several
+ * threads).
+ * @return Allocated pool or NULL on error.
+ */
+faux_intern_t *faux_intern_new(unsigned int flags)
+{
+	faux_intern_t *pool = NULL;
+
+	pool = faux_zmalloc(sizeof(*pool));
+	assert(pool);
+	if (!pool)
+		return NULL;
+
+	// Init
+	pool->flags = flags;
+	pool->slots_num = INTERN_SLOTS;
+	pool->num = 0;
+	pool->chunks = NULL;
+	pool->slots = faux_zmalloc(pool->slots_num * sizeof(*pool->slots));
+	assert(pool->slots);
+	if (!pool->slots) {
+		faux_free(pool);
+		return NULL;
+	}
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_init(&pool->mutex, NULL);
+
+	return pool;
+}
+
+
+/** @brief Frees string interning pool and all interned strings.
+ *
+ * @param [in] pool String interning pool.
+ */
+void faux_intern_free(faux_intern_t *pool)
+{
+	faux_intern_chunk_t *chunk = NULL;
+
+	if (!pool)
+		return;
+
+	if (pool->flags & FAUX_INTERN_ARENA) {
+		chunk = pool->chunks;
+		while (chunk) {
+			faux_intern_chunk_t *next = chunk->next;
+			faux_free(chunk);
+			chunk = next;
+		}
+	} else {
+		size_t i = 0;
+		for (i = 0; i < pool->slots_num; i++)
+			faux_free((char *)pool->slots[i].str);
+	}
+	faux_free(pool->slots);
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_destroy(&pool->mutex);
+	faux_free(pool);
+}
+
+
+/** @brief Calculates hash of string (FNV-1a).
+ *
+ * Static function.
+ *
+ * @param [in] str String.
+ * @param [in] len Length of string.
+ * @return Hash value.
+ */
+static uint64_t faux_intern_hash(const char *str, size_t len)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	size_t i = 0;
+
+	for (i = 0; i < len; i++) {
+		hash ^= (unsigned char)str[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+
+/** @brief Finds slot for string.
+ *
+ * Static function. Returns slot with the same string or empty slot where
+ * the string must be placed.
+ *
+ * @param [in] pool String interning pool.
+ * @param [in] str String.
+ * @param [in] len Length of string.
+ * @param [in] hash Hash of string.
+ * @return Slot.
+ */
+static faux_intern_slot_t *faux_intern_slot(const faux_intern_t *pool,
+	const char *str, size_t len, uint64_t hash)
+{
+	size_t mask = pool->slots_num - 1;
+	size_t i = hash & mask;
+
+	while (pool->slots[i].str) {
+		faux_intern_slot_t *slot = &pool->slots[i];
+		if ((slot->hash == hash) &&
+			(strncmp(slot->str, str, len) == 0) &&
+			('\0' == slot->str[len]))
+			return slot;
+		i = (i + 1) & mask; // Linear probing
+	}
+
+	return &pool->slots[i];
+}
+
+
+/** @brief Doubles hash table.
+ *
+ * Static function.
+ *
+ * @param [in] pool String interning pool.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+static bool_t faux_intern_grow(faux_intern_t *pool)
+{
+	faux_intern_slot_t *old_slots = pool->slots;
+	size_t old_num = pool->slots_num;
+	size_t mask = 0;
+	size_t i = 0;
+
+	pool->slots = faux_zmalloc(old_num * 2 * sizeof(*pool->slots));
+	assert(pool->slots);
+	if (!pool->slots) {
+		pool->slots = old_slots;
+		return BOOL_FALSE;
+	}
+	pool->slots_num = old_num * 2;
+	mask = pool->slots_num - 1;
+
+	for (i = 0; i < old_num; i++) {
+		size_t j = 0;
+		if (!old_slots[i].str)
+			continue;
+		j = old_slots[i].hash & mask;
+		while (pool->slots[j].str)
+			j = (j + 1) & mask;
+		pool->slots[j] = old_slots[i];
+	}
+	faux_free(old_slots);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Stores copy of string.
+ *
+ * Static function.
+ *
+ * @param [in] pool String interning pool.
+ * @param [in] str String.
+ * @param [in] len Length of string.
+ * @return Stored copy or NULL on error.
+ */
+static char *faux_intern_store(faux_intern_t *pool, const char *str,
+	size_t len)
+{
+	faux_intern_chunk_t *chunk = pool->chunks;
+	char *copy = NULL;
+
+	if (!(pool->flags & FAUX_INTERN_ARENA))
+		return faux_str_dupn(str, len);
+
+	if (!chunk || ((chunk->size - chunk->len) < (len + 1))) {
+		size_t size = (len + 1 > INTERN_CHUNK) ? (len + 1) : INTERN_CHUNK;
+		chunk = faux_zmalloc(sizeof(*chunk) + size);
+		assert(chunk);
+		if (!chunk)
+			return NULL;
+		chunk->size = size;
+		chunk->len = 0;
+		// The large string gets its own chunk. Keep current chunk
+		if (pool->chunks && (size > INTERN_CHUNK)) {
+			chunk->next = pool->chunks->next;
+			pool->chunks->next = chunk;
+		} else {
+			chunk->next = pool->chunks;
+			pool->chunks = chunk;
+		}
+	}
+	copy = chunk->data + chunk->len;
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+	chunk->len += len + 1;
+
+	return copy;
+}
+
+
+/** @brief Interns n first characters of string.
+ *
+ * @param [in] pool String interning pool.
+ * @param [in] str String. Can be not '\0'-terminated.
+ * @param [in] len Number of characters.
+ * @return Canonical pointer or NULL on error.
+ */
+const char *faux_intern_n(faux_intern_t *pool, const char *str, size_t len)
+{
+	faux_intern_slot_t *slot = NULL;
+	uint64_t hash = 0;
+	const char *res = NULL;
+
+	assert(pool);
+	if (!pool || !str)
+		return NULL;
+
+	len = strnlen(str, len);
+	hash = faux_intern_hash(str, len);
+
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_lock(&pool->mutex);
+
+	slot = faux_intern_slot(pool, str, len, hash);
+	if (slot->str) { // Already interned
+		res = slot->str;
+		goto out;
+	}
+
+	// Keep load factor <= 1/2
+	if (((pool->num + 1) * 2) > pool->slots_num) {
+		if (!faux_intern_grow(pool))
+			goto out;
+		slot = faux_intern_slot(pool, str, len, hash);
+	}
+	res = faux_intern_store(pool, str, len);
+	if (!res)
+		goto out;
+	slot->hash = hash;
+	slot->str = res;
+	// Atomic store for lock-free faux_intern_num()
+	__atomic_store_n(&pool->num, pool->num + 1, __ATOMIC_RELAXED);
+
+out:
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_unlock(&pool->mutex);
+
+	return res;
+}
+
+
+/** @brief Interns string.
+ *
+ * Returns canonical pointer for the string. The equal strings give the
+ * same pointer.
+ *
+ * @param [in] pool String interning pool.
+ * @param [in] str String.
+ * @return Canonical pointer or NULL on error.
+ */
+const char *faux_intern(faux_intern_t *pool, const char *str)
+{
+	if (!str)
+		return NULL;
+
+	return faux_intern_n(pool, str, strlen(str));
+}
+
+
+/** @brief Finds interned string.
+ *
+ * The string is not added to pool.
+ *
+ * @param [in] pool String interning pool.
+ * @param [in] str String.
+ * @return Canonical pointer or NULL if string is not interned.
+ */
+const char *faux_intern_find(faux_intern_t *pool, const char *str)
+{
+	faux_intern_slot_t *slot = NULL;
+	size_t len = 0;
+	const char *res = NULL;
+
+	assert(pool);
+	if (!pool || !str)
+		return NULL;
+
+	len = strlen(str);
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_lock(&pool->mutex);
+	slot = faux_intern_slot(pool, str, len, faux_intern_hash(str, len));
+	res = slot->str;
+	if (pool->flags & FAUX_INTERN_THREAD_SAFE)
+		pthread_mutex_unlock(&pool->mutex);
+
+	return res;
+}
+
+
+/** @brief Gets number of interned strings.
+ *
+ * @param [in] pool String interning pool.
+ * @return Number of unique strings.
+ */
+size_t faux_intern_num(const faux_intern_t *pool)
+{
+	assert(pool);
+	if (!pool)
+		return 0;
+
+	return __atomic_load_n(&pool->num, __ATOMIC_RELAXED);
+}
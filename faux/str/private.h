@@ -0,0 +1,44 @@
+#include <stdint.h>
+
+#include "faux/faux.h"
+#include "faux/str.h"
+
+// Vector implementation levels
+#define FAUX_STR_SIMD_NONE 0 // Scalar code only
+#define FAUX_STR_SIMD_SSE2 1
+#define FAUX_STR_SIMD_AVX2 2
+
+// Max number of explicit characters in charset for vector scanner
+#define FAUX_STR_CHARSET_VEC_MAX 16
+
+/** @brief Set of characters (byte class) to search for.
+ *
+ * The bitmap is used by scalar code. The vector code compares bytes with
+ * explicit list of characters and control characters range. The charsets
+ * with too many characters are scanned by scalar code only.
+ */
+typedef struct {
+	uint32_t map[256 / 32]; // Bitmap of characters
+	char chars[FAUX_STR_CHARSET_VEC_MAX]; // Characters for vector code
+	unsigned int chars_num; // Number of characters in "chars"
+	bool_t ctrl; // Control characters 0x01-0x1f are in set
+	bool_t vector; // Can be scanned by vector code
+} faux_str_charset_t;
+
+C_DECL_BEGIN
+
+FAUX_HIDDEN int faux_str_simd_level(void);
+FAUX_HIDDEN int faux_str_simd_set_level(int level);
+FAUX_HIDDEN int faux_str_simd_casecmpn(const char *str1, const char *str2,
+	size_t n);
+FAUX_HIDDEN void faux_str_simd_case(char *str, size_t n, bool_t upper);
+FAUX_HIDDEN char *faux_str_simd_casestr(const char *haystack, size_t haystack_len,
+	const char *needle, size_t needle_len);
+FAUX_HIDDEN void faux_str_charset_init(faux_str_charset_t *set,
+	const char *chars, bool_t ctrl);
+FAUX_HIDDEN const char *faux_str_charset_scan(const char *str, size_t n,
+	const faux_str_charset_t *set);
+FAUX_HIDDEN size_t faux_str_c_esc_fill(char *dst, const char *src,
+	size_t src_len, bool_t escape_space);
+
+C_DECL_END
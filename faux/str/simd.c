@@ -0,0 +1,704 @@
+/** @file simd.c
+ * @brief Vector implementation of case-insensitive string functions.
+ *
+ * The SSE2 and AVX2 versions are selected at runtime. The scalar code is
+ * used on other platforms and CPUs. The vector code folds ASCII letters
+ * only. So it's used for blocks of ASCII characters. The blocks containing
+ * other bytes are processed by scalar code with faux_ctype_tolower().
+ *
+ * The comparison functions read whole vector from string even if string
+ * ends within this vector. It's safe while the vector doesn't cross page
+ * boundary (such vectors are processed by scalar code). But address
+ * sanitizer doesn't know about it so it's disabled for these functions.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "faux/faux.h"
+#include "faux/ctype.h"
+#include "faux/str.h"
+
+#include "private.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FAUX_STR_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#define PAGE_SIZE_MIN 4096
+
+// Vector can be read while it doesn't cross page boundary
+#define CROSS_PAGE(ptr, width) \
+	(((uintptr_t)(ptr) & (PAGE_SIZE_MIN - 1)) > (PAGE_SIZE_MIN - (width)))
+
+// Vector over-read within a page is intended. Hide it from sanitizers
+#if defined(__has_attribute)
+#if __has_attribute(no_sanitize_address) && __has_attribute(no_sanitize_thread)
+#define NO_ASAN __attribute__((no_sanitize_address, no_sanitize_thread))
+#elif __has_attribute(no_sanitize_address)
+#define NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef NO_ASAN
+#define NO_ASAN
+#endif
+
+// -1 - not initialized yet
+static int simd_level = -1;
+
+
+/** @brief Compares two characters ignoring case.
+ *
+ * Static function. See faux_str_casecmpn().
+ */
+static inline int faux_str_simd_cmp_chars(char char1, char char2)
+{
+	unsigned char ch1 = (unsigned char)faux_ctype_tolower(char1);
+	unsigned char ch2 = (unsigned char)faux_ctype_tolower(char2);
+
+	return (int)ch1 - (int)ch2;
+}
+
+
+/** @brief Scalar version of faux_str_simd_casecmpn().
+ *
+ * Static function. Compares up to "n" characters.
+ *
+ * @param [in] str1 First string to compare.
+ * @param [in] str2 Second string to compare.
+ * @param [in] n Number of characters to compare.
+ * @param [out] done Returns BOOL_TRUE if result is found.
+ * @return < 0, 0, > 0, see the strcasecmp().
+ */
+static inline int faux_str_scalar_casecmpn(const char *str1, const char *str2,
+	size_t n, bool_t *done)
+{
+	size_t i = 0;
+
+	for (i = 0; i < n; i++) {
+		int res = faux_str_simd_cmp_chars(str1[i], str2[i]);
+		if (res != 0) {
+			*done = BOOL_TRUE;
+			return res;
+		}
+		if ('\0' == str1[i]) { // Both strings are ended
+			*done = BOOL_TRUE;
+			return 0;
+		}
+	}
+	*done = BOOL_FALSE;
+
+	return 0;
+}
+
+
+#ifdef FAUX_STR_SIMD_X86
+
+/** @brief Folds ASCII uppercase letters to lowercase (SSE2).
+ *
+ * The bytes 0x80-0xff are negative for signed comparison so they are not
+ * changed.
+ */
+__attribute__((target("sse2")))
+static inline __m128i faux_str_fold_sse2(__m128i v)
+{
+	__m128i upper = _mm_and_si128(
+		_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+		_mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+
+	return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+
+/** @brief SSE2 version of faux_str_simd_casecmpn().
+ */
+__attribute__((target("sse2"))) NO_ASAN
+static int faux_str_casecmpn_sse2(const char *str1, const char *str2, size_t n)
+{
+	const size_t width = 16;
+	size_t i = 0;
+
+	while (i < n) {
+		size_t rest = n - i;
+		__m128i a;
+		__m128i b;
+		unsigned int stop = 0;
+
+		if (CROSS_PAGE(str1 + i, width) || CROSS_PAGE(str2 + i, width))
+			goto scalar;
+		a = _mm_loadu_si128((const __m128i *)(str1 + i));
+		b = _mm_loadu_si128((const __m128i *)(str2 + i));
+		if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0) // Non-ASCII
+			goto scalar;
+		stop = ~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(
+			faux_str_fold_sse2(a), faux_str_fold_sse2(b)));
+		stop |= (unsigned int)_mm_movemask_epi8(
+			_mm_cmpeq_epi8(a, _mm_setzero_si128()));
+		stop &= 0xffff;
+		if (stop != 0) {
+			size_t idx = __builtin_ctz(stop);
+			if (idx >= rest)
+				return 0;
+			return faux_str_simd_cmp_chars(str1[i + idx], str2[i + idx]);
+		}
+		if (rest <= width)
+			return 0;
+		i += width;
+		continue;
+
+scalar:
+		{
+		bool_t done = BOOL_FALSE;
+		size_t len = (rest < width) ? rest : width;
+		int res = faux_str_scalar_casecmpn(str1 + i, str2 + i, len, &done);
+		if (done)
+			return res;
+		i += len;
+		}
+	}
+
+	return 0;
+}
+
+
+/** @brief Folds ASCII uppercase letters to lowercase (AVX2).
+ */
+__attribute__((target("avx2")))
+static inline __m256i faux_str_fold_avx2(__m256i v)
+{
+	__m256i upper = _mm256_and_si256(
+		_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+		_mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+
+	return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+
+/** @brief AVX2 version of faux_str_simd_casecmpn().
+ */
+__attribute__((target("avx2"))) NO_ASAN
+static int faux_str_casecmpn_avx2(const char *str1, const char *str2, size_t n)
+{
+	const size_t width = 32;
+	size_t i = 0;
+
+	while (i < n) {
+		size_t rest = n - i;
+		__m256i a;
+		__m256i b;
+		unsigned int stop = 0;
+
+		if (CROSS_PAGE(str1 + i, width) || CROSS_PAGE(str2 + i, width))
+			goto scalar;
+		a = _mm256_loadu_si256((const __m256i *)(str1 + i));
+		b = _mm256_loadu_si256((const __m256i *)(str2 + i));
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0) // Non-ASCII
+			goto scalar;
+		stop = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+			faux_str_fold_avx2(a), faux_str_fold_avx2(b)));
+		stop |= (unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(a, _mm256_setzero_si256()));
+		if (stop != 0) {
+			size_t idx = __builtin_ctz(stop);
+			if (idx >= rest)
+				return 0;
+			return faux_str_simd_cmp_chars(str1[i + idx], str2[i + idx]);
+		}
+		if (rest <= width)
+			return 0;
+		i += width;
+		continue;
+
+scalar:
+		{
+		bool_t done = BOOL_FALSE;
+		size_t len = (rest < width) ? rest : width;
+		int res = faux_str_scalar_casecmpn(str1 + i, str2 + i, len, &done);
+		if (done)
+			return res;
+		i += len;
+		}
+	}
+
+	return 0;
+}
+
+
+/** @brief SSE2 version of faux_str_simd_casestr().
+ *
+ * Finds candidates by first and last characters of needle. The needle
+ * length must be > 0 and first and last characters must be ASCII.
+ * Returns position to continue with scalar code in "tail".
+ */
+__attribute__((target("sse2")))
+static char *faux_str_casestr_sse2(const char *haystack, size_t haystack_len,
+	const char *needle, size_t needle_len, size_t *tail)
+{
+	const size_t width = 16;
+	const __m128i first = _mm_set1_epi8(faux_ctype_tolower(needle[0]));
+	const __m128i last = _mm_set1_epi8(
+		faux_ctype_tolower(needle[needle_len - 1]));
+	size_t i = 0;
+
+	for (i = 0; (i + needle_len - 1 + width) <= haystack_len; i += width) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(haystack + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)
+			(haystack + i + needle_len - 1));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(faux_str_fold_sse2(a), first),
+			_mm_cmpeq_epi8(faux_str_fold_sse2(b), last)));
+		while (mask != 0) {
+			size_t pos = i + __builtin_ctz(mask);
+			if (faux_str_simd_casecmpn(haystack + pos,
+				needle, needle_len) == 0)
+				return (char *)(haystack + pos);
+			mask &= mask - 1;
+		}
+	}
+	*tail = i;
+
+	return NULL;
+}
+
+
+/** @brief AVX2 version of faux_str_simd_casestr().
+ */
+__attribute__((target("avx2")))
+static char *faux_str_casestr_avx2(const char *haystack, size_t haystack_len,
+	const char *needle, size_t needle_len, size_t *tail)
+{
+	const size_t width = 32;
+	const __m256i first = _mm256_set1_epi8(faux_ctype_tolower(needle[0]));
+	const __m256i last = _mm256_set1_epi8(
+		faux_ctype_tolower(needle[needle_len - 1]));
+	size_t i = 0;
+
+	for (i = 0; (i + needle_len - 1 + width) <= haystack_len; i += width) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(haystack + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)
+			(haystack + i + needle_len - 1));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+			_mm256_and_si256(
+			_mm256_cmpeq_epi8(faux_str_fold_avx2(a), first),
+			_mm256_cmpeq_epi8(faux_str_fold_avx2(b), last)));
+		while (mask != 0) {
+			size_t pos = i + __builtin_ctz(mask);
+			if (faux_str_simd_casecmpn(haystack + pos,
+				needle, needle_len) == 0)
+				return (char *)(haystack + pos);
+			mask &= mask - 1;
+		}
+	}
+	*tail = i;
+
+	return NULL;
+}
+
+
+/** @brief SSE2 scanner for charset. See faux_str_charset_scan().
+ *
+ * Returns index of first found character or index to continue scanning
+ * with scalar code.
+ */
+__attribute__((target("sse2"))) NO_ASAN
+static size_t faux_str_scan_sse2(const char *str, size_t n,
+	const faux_str_charset_t *set, bool_t *found)
+{
+	const size_t width = 16;
+	__m128i chars[FAUX_STR_CHARSET_VEC_MAX];
+	unsigned int k = 0;
+	size_t i = 0;
+
+	for (k = 0; k < set->chars_num; k++)
+		chars[k] = _mm_set1_epi8(set->chars[k]);
+
+	*found = BOOL_FALSE;
+	for (i = 0; i < n; i += width) {
+		size_t rest = n - i;
+		__m128i v;
+		__m128i hit;
+		unsigned int mask = 0;
+
+		if (CROSS_PAGE(str + i, width))
+			break; // Continue with scalar code
+		v = _mm_loadu_si128((const __m128i *)(str + i));
+		hit = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+		if (set->ctrl) // Bytes 0x00-0x1f
+			hit = _mm_or_si128(hit, _mm_and_si128(
+				_mm_cmpgt_epi8(v, _mm_set1_epi8(-1)),
+				_mm_cmpgt_epi8(_mm_set1_epi8(0x20), v)));
+		for (k = 0; k < set->chars_num; k++)
+			hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, chars[k]));
+		mask = (unsigned int)_mm_movemask_epi8(hit);
+		if (rest < width)
+			mask &= (1u << rest) - 1;
+		if (mask != 0) {
+			*found = BOOL_TRUE;
+			return i + __builtin_ctz(mask);
+		}
+	}
+
+	return (i < n) ? i : n;
+}
+
+
+/** @brief AVX2 scanner for charset. See faux_str_charset_scan().
+ */
+__attribute__((target("avx2"))) NO_ASAN
+static size_t faux_str_scan_avx2(const char *str, size_t n,
+	const faux_str_charset_t *set, bool_t *found)
+{
+	const size_t width = 32;
+	__m256i chars[FAUX_STR_CHARSET_VEC_MAX];
+	unsigned int k = 0;
+	size_t i = 0;
+
+	for (k = 0; k < set->chars_num; k++)
+		chars[k] = _mm256_set1_epi8(set->chars[k]);
+
+	*found = BOOL_FALSE;
+	for (i = 0; i < n; i += width) {
+		size_t rest = n - i;
+		__m256i v;
+		__m256i hit;
+		unsigned int mask = 0;
+
+		if (CROSS_PAGE(str + i, width))
+			break; // Continue with scalar code
+		v = _mm256_loadu_si256((const __m256i *)(str + i));
+		hit = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+		if (set->ctrl) // Bytes 0x00-0x1f
+			hit = _mm256_or_si256(hit, _mm256_and_si256(
+				_mm256_cmpgt_epi8(v, _mm256_set1_epi8(-1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v)));
+		for (k = 0; k < set->chars_num; k++)
+			hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, chars[k]));
+		mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (rest < width)
+			mask &= (1u << rest) - 1;
+		if (mask != 0) {
+			*found = BOOL_TRUE;
+			return i + __builtin_ctz(mask);
+		}
+	}
+
+	return (i < n) ? i : n;
+}
+
+/** @brief SSE2 version of faux_str_simd_case().
+ *
+ * The bytes 0x80-0xff are negative for signed comparison so they are not
+ * changed.
+ */
+__attribute__((target("sse2")))
+static size_t faux_str_case_sse2(char *str, size_t n, bool_t upper)
+{
+	const size_t width = 16;
+	const __m128i lo = _mm_set1_epi8((upper ? 'a' : 'A') - 1);
+	const __m128i hi = _mm_set1_epi8((upper ? 'z' : 'Z') + 1);
+	const __m128i bit = _mm_set1_epi8(0x20);
+	size_t i = 0;
+
+	for (i = 0; (i + width) <= n; i += width) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(str + i));
+		__m128i letter = _mm_and_si128(_mm_cmpgt_epi8(v, lo),
+			_mm_cmpgt_epi8(hi, v));
+		v = _mm_xor_si128(v, _mm_and_si128(letter, bit));
+		_mm_storeu_si128((__m128i *)(str + i), v);
+	}
+
+	return i;
+}
+
+
+/** @brief AVX2 version of faux_str_simd_case().
+ */
+__attribute__((target("avx2")))
+static size_t faux_str_case_avx2(char *str, size_t n, bool_t upper)
+{
+	const size_t width = 32;
+	const __m256i lo = _mm256_set1_epi8((upper ? 'a' : 'A') - 1);
+	const __m256i hi = _mm256_set1_epi8((upper ? 'z' : 'Z') + 1);
+	const __m256i bit = _mm256_set1_epi8(0x20);
+	size_t i = 0;
+
+	for (i = 0; (i + width) <= n; i += width) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(str + i));
+		__m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo),
+			_mm256_cmpgt_epi8(hi, v));
+		v = _mm256_xor_si256(v, _mm256_and_si256(letter, bit));
+		_mm256_storeu_si256((__m256i *)(str + i), v);
+	}
+
+	return i;
+}
+
+#endif /* FAUX_STR_SIMD_X86 */
+
+
+/** @brief Detects the best vector implementation supported by CPU.
+ *
+ * Static function.
+ *
+ * @return Vector implementation level.
+ */
+static int faux_str_simd_detect(void)
+{
+#ifdef FAUX_STR_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return FAUX_STR_SIMD_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return FAUX_STR_SIMD_SSE2;
+#endif
+
+	return FAUX_STR_SIMD_NONE;
+}
+
+
+/** @brief Gets current vector implementation level.
+ *
+ * The level is detected on first call.
+ *
+ * @return Vector implementation level.
+ */
+int faux_str_simd_level(void)
+{
+	int level = __atomic_load_n(&simd_level, __ATOMIC_RELAXED);
+
+	if (level < 0) {
+		level = faux_str_simd_detect();
+		__atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+	}
+
+	return level;
+}
+
+
+/** @brief Sets vector implementation level.
+ *
+ * The level can't be greater than CPU supports. It's used by tests to
+ * check all implementations.
+ *
+ * @param [in] level Requested vector implementation level.
+ * @return Level that was really set.
+ */
+int faux_str_simd_set_level(int level)
+{
+	int max_level = faux_str_simd_detect();
+
+	if (level > max_level)
+		level = max_level;
+	if (level < FAUX_STR_SIMD_NONE)
+		level = FAUX_STR_SIMD_NONE;
+	__atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+
+	return level;
+}
+
+
+/** @brief Compares n first characters of two strings ignoring case.
+ *
+ * The strings must be not NULL. See faux_str_casecmpn().
+ *
+ * @param [in] str1 First string to compare.
+ * @param [in] str2 Second string to compare.
+ * @param [in] n Number of characters to compare.
+ * @return < 0, 0, > 0, see the strcasecmp().
+ */
+int faux_str_simd_casecmpn(const char *str1, const char *str2, size_t n)
+{
+	bool_t done = BOOL_FALSE;
+
+	switch (faux_str_simd_level()) {
+#ifdef FAUX_STR_SIMD_X86
+	case FAUX_STR_SIMD_AVX2:
+		return faux_str_casecmpn_avx2(str1, str2, n);
+	case FAUX_STR_SIMD_SSE2:
+		return faux_str_casecmpn_sse2(str1, str2, n);
+#endif
+	default:
+		break;
+	}
+
+	return faux_str_scalar_casecmpn(str1, str2, n, &done);
+}
+
+
+/** @brief Converts string to lowercase or uppercase in place.
+ *
+ * The length of string must be known. The ASCII letters are converted only.
+ *
+ * @param [in,out] str String to convert.
+ * @param [in] n Length of string.
+ * @param [in] upper BOOL_TRUE - convert to uppercase, BOOL_FALSE - lowercase.
+ */
+void faux_str_simd_case(char *str, size_t n, bool_t upper)
+{
+	size_t i = 0;
+
+	switch (faux_str_simd_level()) {
+#ifdef FAUX_STR_SIMD_X86
+	case FAUX_STR_SIMD_AVX2:
+		i = faux_str_case_avx2(str, n, upper);
+		break;
+	case FAUX_STR_SIMD_SSE2:
+		i = faux_str_case_sse2(str, n, upper);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	if (upper) {
+		for (; i < n; i++)
+			str[i] = faux_ctype_toupper(str[i]);
+	} else {
+		for (; i < n; i++)
+			str[i] = faux_ctype_tolower(str[i]);
+	}
+}
+
+
+/** @brief Finds the first occurrence of the substring ignoring case.
+ *
+ * The strings must be not NULL and lengths must be known. See
+ * faux_str_casestr().
+ *
+ * @param [in] haystack String to find substring in it.
+ * @param [in] haystack_len Length of haystack.
+ * @param [in] needle Substring to find.
+ * @param [in] needle_len Length of needle.
+ * @return Pointer to first occurence of substring or NULL if not found.
+ */
+char *faux_str_simd_casestr(const char *haystack, size_t haystack_len,
+	const char *needle, size_t needle_len)
+{
+	size_t i = 0;
+
+	if (needle_len > haystack_len)
+		return NULL;
+	if (0 == needle_len)
+		return ('\0' == *haystack) ? NULL : (char *)haystack;
+
+#ifdef FAUX_STR_SIMD_X86
+	// Vector filter compares ASCII first and last characters only
+	if ((((unsigned char)needle[0] & 0x80) == 0) &&
+		(((unsigned char)needle[needle_len - 1] & 0x80) == 0)) {
+		char *found = NULL;
+		switch (faux_str_simd_level()) {
+		case FAUX_STR_SIMD_AVX2:
+			found = faux_str_casestr_avx2(haystack, haystack_len,
+				needle, needle_len, &i);
+			break;
+		case FAUX_STR_SIMD_SSE2:
+			found = faux_str_casestr_sse2(haystack, haystack_len,
+				needle, needle_len, &i);
+			break;
+		default:
+			break;
+		}
+		if (found)
+			return found;
+	}
+#endif
+
+	for (; (i + needle_len) <= haystack_len; i++) {
+		if (faux_str_simd_casecmpn(haystack + i, needle, needle_len) == 0)
+			return (char *)(haystack + i);
+	}
+
+	return NULL;
+}
+
+
+/** @brief Initializes charset.
+ *
+ * @param [out] set Charset to initialize.
+ * @param [in] chars Characters of set. Can be NULL.
+ * @param [in] ctrl Add control characters 0x01-0x1f to set.
+ */
+void faux_str_charset_init(faux_str_charset_t *set,
+	const char *chars, bool_t ctrl)
+{
+	const char *p = NULL;
+	unsigned int c = 0;
+
+	memset(set, 0, sizeof(*set));
+	set->ctrl = ctrl;
+	set->vector = BOOL_TRUE;
+	if (ctrl) {
+		for (c = 1; c < 0x20; c++)
+			set->map[c / 32] |= 1u << (c % 32);
+	}
+	if (!chars)
+		return;
+
+	for (p = chars; *p != '\0'; p++) {
+		c = (unsigned char)*p;
+		if (set->map[c / 32] & (1u << (c % 32)))
+			continue; // Already in set
+		set->map[c / 32] |= 1u << (c % 32);
+		if (set->chars_num < FAUX_STR_CHARSET_VEC_MAX)
+			set->chars[set->chars_num++] = *p;
+		else
+			set->vector = BOOL_FALSE; // Too many for vector code
+	}
+}
+
+
+/** @brief Finds first character from charset or end of string.
+ *
+ * The scanning stops on '\0' or after n bytes.
+ *
+ * @param [in] str String (or memory block) to search in.
+ * @param [in] n Maximum number of bytes to search within.
+ * @param [in] set Charset to search for.
+ * @return Pointer to found character, to '\0' or to (str + n).
+ */
+const char *faux_str_charset_scan(const char *str, size_t n,
+	const faux_str_charset_t *set)
+{
+	size_t i = 0;
+#ifdef FAUX_STR_SIMD_X86
+	int level = set->vector ? faux_str_simd_level() : FAUX_STR_SIMD_NONE;
+#endif
+
+	while (i < n) {
+		size_t next = n;
+
+#ifdef FAUX_STR_SIMD_X86
+		bool_t found = BOOL_FALSE;
+		switch (level) {
+		case FAUX_STR_SIMD_AVX2:
+			i += faux_str_scan_avx2(str + i, n - i, set, &found);
+			break;
+		case FAUX_STR_SIMD_SSE2:
+			i += faux_str_scan_sse2(str + i, n - i, set, &found);
+			break;
+		default:
+			break;
+		}
+		if (found)
+			return str + i;
+		// Vector code stops before page boundary
+		if (level != FAUX_STR_SIMD_NONE) {
+			next = i + PAGE_SIZE_MIN -
+				((uintptr_t)(str + i) & (PAGE_SIZE_MIN - 1));
+			if (next > n)
+				next = n;
+		}
+#endif
+
+		for (; i < next; i++) {
+			unsigned int c = (unsigned char)str[i];
+			if ((0 == c) || (set->map[c / 32] & (1u << (c % 32))))
+				return str + i;
+		}
+	}
+
+	return str + n;
+}
@@ -7,15 +7,17 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
 #include <stdarg.h>
 
 #include "faux/ctype.h"
-#include "faux/conv.h"
 #include "faux/str.h"
 
+#include "private.h"
+
 /** @brief Free the memory allocated for the string.
  *
  * Safely free the memory allocated for the string. You can use NULL
@@ -33,7 +35,7 @@ void faux_str_free(char *str)
 /** @brief Duplicates the string.
  *
  * Duplicates the string. Same as standard strdup() function. Allocates
- * memory with malloc(). Checks for NULL pointer.
+ * memory with faux_malloc(). Checks for NULL pointer.
  *
  * @warning Resulting string must be freed by faux_str_free().
  *
@@ -42,9 +44,19 @@ void faux_str_free(char *str)
  */
 char *faux_str_dup(const char *str)
 {
+	char *res = NULL;
+	size_t len = 0;
+
 	if (!str)
 		return NULL;
-	return strdup(str);
+	// Allocate by faux_malloc() to be visible for allocation statistics
+	len = strlen(str) + 1;
+	res = faux_malloc(len);
+	if (!res)
+		return NULL;
+	memcpy(res, str, len);
+
+	return res;
 }
 
 
@@ -95,15 +107,10 @@ char *faux_str_dupn(const char *str, size_t n)
 char *faux_str_tolower(const char *str)
 {
 	char *res = faux_str_dup(str);
-	char *p = res;
 
 	if (!res)
 		return NULL;
-
-	while (*p) {
-		*p = faux_ctype_tolower(*p);
-		p++;
-	}
+	faux_str_simd_case(res, strlen(res), BOOL_FALSE);
 
 	return res;
 }
@@ -121,15 +128,10 @@ char *faux_str_tolower(const char *str)
 char *faux_str_toupper(const char *str)
 {
 	char *res = faux_str_dup(str);
-	char *p = res;
 
 	if (!res)
 		return NULL;
-
-	while (*p) {
-		*p = faux_ctype_toupper(*p);
-		p++;
-	}
+	faux_str_simd_case(res, strlen(res), BOOL_TRUE);
 
 	return res;
 }
@@ -161,7 +163,7 @@ char *faux_str_catn(char **str, const char *text, size_t n)
 	text_len = strlen(text);
 	text_len = (text_len < n) ? text_len : n;
 
-	res = realloc(*str, str_len + text_len + 1);
+	res = faux_realloc(*str, str_len + text_len + 1);
 	if (!res)
 		return NULL;
 	p = res + str_len;
@@ -370,7 +372,8 @@ int faux_str_cmp(const char *str1, const char *str2)
  *
  * The difference beetween this function an standard strncasecmp() is
  * faux function uses faux ctype functions. It can be important for
- * portability.
+ * portability. The blocks of ASCII characters are compared by vector
+ * instructions if CPU supports them. See simd.c.
  *
  * @param [in] str1 First string to compare.
  * @param [in] str2 Second string to compare.
@@ -379,25 +382,19 @@ int faux_str_cmp(const char *str1, const char *str2)
  */
 int faux_str_casecmpn(const char *str1, const char *str2, size_t n)
 {
-	const char *p1 = str1;
-	const char *p2 = str2;
-	size_t num = n;
-
-	while (*p1 != '\0' && *p2 != '\0' && num != 0) {
-		int res = faux_str_cmp_chars(
-			faux_ctype_tolower(*p1), faux_ctype_tolower(*p2));
-		if (res != 0)
-			return res;
-		p1++;
-		p2++;
-		num--;
-	}
+	if (0 == n) // Zero first characters are always equal
+		return 0;
 
-	if (0 == n) // It means n first characters are equal.
+	if (!str1 && !str2) // Empty strings are equal
 		return 0;
 
-	return faux_str_cmp_chars(
-		faux_ctype_tolower(*p1), faux_ctype_tolower(*p2));
+	if (!str1) // Consider NULL string to be less then empty string
+		return -1;
+
+	if (!str2) // Consider NULL string to be less then empty string
+		return 1;
+
+	return faux_str_simd_casecmpn(str1, str2, n);
 }
 
 
@@ -413,29 +410,40 @@ int faux_str_casecmpn(const char *str1, const char *str2, size_t n)
  */
 int faux_str_casecmp(const char *str1, const char *str2)
 {
-	const char *p1 = str1;
-	const char *p2 = str2;
-
-	if (!p1 && !p2) // Empty strings are equal
+	if (!str1 && !str2) // Empty strings are equal
 		return 0;
 
-	if (!p1) // Consider NULL string to be less then empty string
+	if (!str1) // Consider NULL string to be less then empty string
 		return -1;
 
-	if (!p2) // Consider NULL string to be less then empty string
+	if (!str2) // Consider NULL string to be less then empty string
 		return 1;
 
-	while (*p1 != '\0' && *p2 != '\0') {
-		int res = faux_str_cmp_chars(
-			faux_ctype_tolower(*p1), faux_ctype_tolower(*p2));
-		if (res != 0)
-			return res;
-		p1++;
-		p2++;
-	}
+	return faux_str_simd_casecmpn(str1, str2, SIZE_MAX);
+}
+
+
+/** @brief Skips leading zeros and measures the digit run.
+ *
+ * Static function.
+ *
+ * @param [in,out] str Pointer to the first digit. It will point to the
+ * first significant digit.
+ * @return Number of significant digits.
+ */
+static size_t faux_str_digit_run(const char **str)
+{
+	const char *p = *str;
+	const char *start = NULL;
 
-	return faux_str_cmp_chars(
-		faux_ctype_tolower(*p1), faux_ctype_tolower(*p2));
+	while ('0' == *p)
+		p++;
+	start = p;
+	while (faux_ctype_isdigit(*p))
+		p++;
+	*str = start;
+
+	return p - start;
 }
 
 
@@ -443,6 +451,10 @@ int faux_str_casecmp(const char *str1, const char *str2)
  *
  * "a2" < "a10"
  *
+ * The digit runs are compared as numbers of any length: leading zeros are
+ * skipped, then run lengths are compared, then digits. Nothing is
+ * converted or allocated.
+ *
  * @param [in] str1 First string to compare.
  * @param [in] str2 Second string to compare.
  * @return < 0, 0, > 0, see the strcasecmp().
@@ -463,20 +475,17 @@ int faux_str_numcmp(const char *str1, const char *str2)
 
 	while (*p1 != '\0' && *p2 != '\0') {
 		if (faux_ctype_isdigit(*p1) && faux_ctype_isdigit(*p2)) {
-			unsigned long long int v1 = 0;
-			unsigned long long int v2 = 0;
-			if (!faux_conv_atoull(p1, &v1, 10) ||
-				!faux_conv_atoull(p2, &v2, 10)) // Overflow?
-				return faux_str_cmp(str1, str2); // Standard comparison
-			if (v1 > v2)
-				return 1;
-			if (v1 < v2)
-				return -1;
+			size_t len1 = faux_str_digit_run(&p1);
+			size_t len2 = faux_str_digit_run(&p2);
+			int res = 0;
+			if (len1 != len2)
+				return (len1 > len2) ? 1 : -1;
+			res = memcmp(p1, p2, len1);
+			if (res != 0)
+				return (res > 0) ? 1 : -1;
 			// Skip all digits if equal
-			while (faux_ctype_isdigit(*p1))
-				p1++;
-			while (faux_ctype_isdigit(*p2))
-				p2++;
+			p1 += len1;
+			p2 += len2;
 		} else {
 			int res = faux_str_cmp_chars(*p1, *p2);
 			if (res != 0)
@@ -490,9 +499,78 @@ int faux_str_numcmp(const char *str1, const char *str2)
 }
 
 
+/** @brief Makes sort key for numeric comparison.
+ *
+ * The result of faux_str_cmp() for keys has the same sign as result of
+ * faux_str_numcmp() for source strings. So the key can be computed once
+ * and stored within sorted object to avoid digit runs parsing on each
+ * comparison. Each digit run is replaced by the '0' marker, the length of
+ * significant part and the significant digits. The length is encoded as
+ * sequence of 0xff bytes (one for each 254) and the rest + 1. So key never
+ * contains '\0' and longer runs are greater.
+ *
+ * @warning The returned pointer must be freed by faux_str_free().
+ * @param [in] str Source string.
+ * @return Allocated key or NULL on error.
+ */
+char *faux_str_numkey(const char *str)
+{
+	const char *p = str;
+	char *key = NULL;
+	char *k = NULL;
+	size_t key_len = 0;
+
+	if (!str)
+		return NULL;
+
+	// Measure key
+	while (*p != '\0') {
+		if (faux_ctype_isdigit(*p)) {
+			size_t len = faux_str_digit_run(&p);
+			key_len += 1 + (len / 254) + 1 + len;
+			p += len;
+		} else {
+			key_len++;
+			p++;
+		}
+	}
+
+	key = faux_malloc(key_len + 1);
+	assert(key);
+	if (!key)
+		return NULL;
+
+	// Fill key
+	k = key;
+	p = str;
+	while (*p != '\0') {
+		if (faux_ctype_isdigit(*p)) {
+			size_t len = faux_str_digit_run(&p);
+			size_t rest = len;
+			*k++ = '0'; // Marker compares with non-digits like digit
+			while (rest >= 254) {
+				*k++ = (char)0xff;
+				rest -= 254;
+			}
+			*k++ = (char)(rest + 1);
+			memcpy(k, p, len);
+			k += len;
+			p += len;
+		} else {
+			*k++ = *p++;
+		}
+	}
+	*k = '\0';
+
+	return key;
+}
+
+
 /** @brief Finds the first occurrence of the substring in the string
  *
- * Function is a faux version of strcasestr() function.
+ * Function is a faux version of strcasestr() function. The candidates are
+ * found by first and last characters of needle using vector instructions
+ * if CPU supports them. See simd.c.
  *
  * @param [in] haystack String to find substring in it.
  * @param [in] needle Substring to find.
@@ -502,25 +580,120 @@ int faux_str_numcmp(const char *str1, const char *str2)
  */
 char *faux_str_casestr(const char *haystack, const char *needle)
 {
-	const char *ptr = haystack;
-	size_t ptr_len = 0;
-	size_t needle_len = 0;
-
 	if (!haystack || !needle)
 		return NULL;
 
-	ptr_len = strlen(haystack);
-	needle_len = strlen(needle);
+	return faux_str_simd_casestr(haystack, strlen(haystack),
+		needle, strlen(needle));
+}
+
 
-	while ((*ptr != '\0') && (ptr_len >= needle_len)) {
-		int res = faux_str_casecmpn(ptr, needle, needle_len);
-		if (0 == res)
-			return (char *)ptr;
-		ptr++;
-		ptr_len--;
+/** @brief Gets escaped replacement for the character.
+ *
+ * Static function.
+ *
+ * @param [in] c Character to escape.
+ * @param [in] escape_space Flag to escape spaces or not.
+ * @param [out] buf Buffer for replacement. At least 4 bytes.
+ * @return Length of replacement.
+ */
+static size_t faux_str_c_esc_char(char c, bool_t escape_space, char *buf)
+{
+	static const char hex[] = "0123456789abcdef";
+	char esc = '\0';
+
+	switch (c) {
+	case '\n':
+		esc = 'n';
+		break;
+	case '\"':
+		esc = '\"';
+		break;
+	case '\\':
+		esc = '\\';
+		break;
+	case '\'':
+		esc = '\'';
+		break;
+	case '\r':
+		esc = 'r';
+		break;
+	case '\t':
+		esc = 't';
+		break;
+	case ' ':
+		if (escape_space)
+			esc = ' ';
+		break;
+	default:
+		// Check is the symbol control character. Control
+		// characters has codes from 0x00 to 0x1f.
+		if (((unsigned char)c & 0xe0) == 0) { // control
+			buf[0] = '\\';
+			buf[1] = 'x';
+			buf[2] = hex[(unsigned char)c >> 4];
+			buf[3] = hex[(unsigned char)c & 0x0f];
+			return 4;
+		}
+		break;
+	}
+
+	if ('\0' == esc) { // Common character
+		buf[0] = c;
+		return 1;
 	}
+	buf[0] = '\\';
+	buf[1] = esc;
 
-	return NULL; // Not found
+	return 2;
+}
+
+
+/** @brief Measures or fills escaped string.
+ *
+ * The runs of common characters are found by charset scanner and copied at
+ * once. If "dst" is NULL then function only measures length of escaped
+ * string. So escaping can be done with exactly one allocation.
+ *
+ * @param [out] dst Buffer for escaped string or NULL. Not '\0'-terminated.
+ * @param [in] src String for escaping.
+ * @param [in] src_len Length of source string.
+ * @param [in] escape_space Flag to escape spaces or not.
+ * @return Length of escaped string.
+ */
+size_t faux_str_c_esc_fill(char *dst, const char *src, size_t src_len,
+	bool_t escape_space)
+{
+	faux_str_charset_t set = {};
+	const char *end = src + src_len;
+	const char *p = src;
+	size_t len = 0;
+
+	// Quotes and backslash. The \n, \r, \t are control characters.
+	faux_str_charset_init(&set, escape_space ? "\"\\\' " : "\"\\\'",
+		BOOL_TRUE);
+
+	while (p < end) {
+		const char *special = faux_str_charset_scan(p, end - p, &set);
+		size_t plain_len = special - p;
+		char buf[4];
+		size_t esc_len = 0;
+
+		if (plain_len > 0) {
+			if (dst)
+				memcpy(dst + len, p, plain_len);
+			len += plain_len;
+		}
+		if (special >= end)
+			break;
+		esc_len = faux_str_c_esc_char(*special, escape_space, buf);
+		if (dst)
+			memcpy(dst + len, buf, esc_len);
+		len += esc_len;
+		p = special + 1;
+	}
+
+	return len;
 }
 
 
@@ -533,82 +706,24 @@ char *faux_str_casestr(const char *haystack, const char *needle)
  */
 static char *faux_str_c_esc_internal(const char *src, bool_t escape_space)
 {
-	const char *src_ptr = src;
-	char *dst = NULL;
-	char *dst_ptr = NULL;
-	char *escaped = NULL;
 	size_t src_len = 0;
 	size_t dst_len = 0;
+	char *dst = NULL;
 
 	if (!src)
 		return NULL;
 
+	// Measure then fill
 	src_len = strlen(src);
-	// Calculate max destination string size.
-	// The worst case is when each src character will be replaced by
-	// something like '\xff'. So it's 4 dst chars for 1 src one.
-	dst_len = (src_len * 4) + 1; // one byte for '\0'
-	dst = faux_zmalloc(dst_len);
+	dst_len = faux_str_c_esc_fill(NULL, src, src_len, escape_space);
+	dst = faux_malloc(dst_len + 1); // one byte for '\0'
 	assert(dst);
 	if (!dst)
 		return NULL;
-	dst_ptr = dst;
-
-	while (*src_ptr != '\0') {
-		char *esc = NULL; // escaped replacement
-		char buf[5]; // longest 'char' (4 bytes) + '\0'
-		size_t len = 0;
+	faux_str_c_esc_fill(dst, src, src_len, escape_space);
+	dst[dst_len] = '\0';
 
-		switch (*src_ptr) {
-		case '\n':
-			esc = "\\n";
-			break;
-		case '\"':
-			esc = "\\\"";
-			break;
-		case '\\':
-			esc = "\\\\";
-			break;
-		case '\'':
-			esc = "\\\'";
-			break;
-		case '\r':
-			esc = "\\r";
-			break;
-		case '\t':
-			esc = "\\t";
-			break;
-		case ' ':
-			if (escape_space)
-				esc = "\\ ";
-			else
-				esc = " ";
-			break;
-		default:
-			// Check is the symbol control character. Control
-			// characters has codes from 0x00 to 0x1f.
-			if (((unsigned char)*src_ptr & 0xe0) == 0) { // control
-				snprintf(buf, sizeof(buf), "\\x%02x",
-					(unsigned char)*src_ptr);
-				buf[4] = '\0'; // for safety
-			} else {
-				buf[0] = *src_ptr; // Common character
-				buf[1] = '\0';
-			}
-			esc = buf;
-			break;
-		}
-
-		len = strlen(esc);
-		memcpy(dst_ptr, esc, len); // zmalloc() nullify the rest
-		dst_ptr += len;
-		src_ptr++;
-	}
-
-	escaped = faux_str_dup(dst); // Free some memory
-	faux_str_free(dst); // 'dst' size >= 'escaped' size
-
-	return escaped;
+	return dst;
 }
 
 
@@ -646,24 +761,33 @@ char *faux_str_c_esc_space(const char *src)
  */
 char *faux_str_c_esc_quote(const char *src)
 {
-	char *space = NULL;
-	char *escaped = NULL;
-	char *result = NULL;
+	size_t src_len = 0;
+	size_t dst_len = 0;
+	size_t quote_len = 0;
+	char *dst = NULL;
 
 	if (!src)
 		return NULL;
 
-	escaped = faux_str_c_esc(src);
 	// String with space must have quotes
-	space = strchr(escaped, ' ');
-	if (space) {
-		result = faux_str_sprintf("\"%s\"", escaped);
-		faux_str_free(escaped);
-	} else {
-		result = escaped;
+	src_len = strlen(src);
+	if (memchr(src, ' ', src_len))
+		quote_len = 1;
+
+	// Measure then fill
+	dst_len = faux_str_c_esc_fill(NULL, src, src_len, BOOL_FALSE);
+	dst = faux_malloc(dst_len + (2 * quote_len) + 1);
+	assert(dst);
+	if (!dst)
+		return NULL;
+	faux_str_c_esc_fill(dst + quote_len, src, src_len, BOOL_FALSE);
+	if (quote_len) {
+		dst[0] = '"';
+		dst[dst_len + 1] = '"';
 	}
+	dst[dst_len + (2 * quote_len)] = '\0';
 
-	return result;
+	return dst;
 }
 
 
@@ -677,6 +801,7 @@ char *faux_str_c_esc_quote(const char *src)
  */
 char *faux_str_c_bin(const char *src, size_t n)
 {
+	static const char hex[] = "0123456789abcdef";
 	const char *src_ptr = src;
 	char *dst = NULL;
 	char *dst_ptr = NULL;
@@ -696,11 +821,13 @@ char *faux_str_c_bin(const char *src, size_t n)
 	dst_ptr = dst;
 
 	while (src_ptr < (src + n)) {
-		char buf[BYTE_CONV_LEN + 1]; // longest 'char' (4 bytes) + '\0'
+		unsigned char c = (unsigned char)*src_ptr;
 
-		snprintf(buf, sizeof(buf), "\\x%02x", (unsigned char)*src_ptr);
-		memcpy(dst_ptr, buf, BYTE_CONV_LEN); // zmalloc() nullify the rest
-		dst_ptr += BYTE_CONV_LEN;
+		dst_ptr[0] = '\\';
+		dst_ptr[1] = 'x';
+		dst_ptr[2] = hex[c >> 4];
+		dst_ptr[3] = hex[c & 0x0f];
+		dst_ptr += BYTE_CONV_LEN; // zmalloc() nullify the rest
 		src_ptr++;
 	}
 
@@ -713,7 +840,8 @@ char *faux_str_c_bin(const char *src, size_t n)
  * The function search for any of specified characters within string.
  * The search is limited to first n characters of the string. If
  * terminating '\0' is before n-th character then search will stop on
- * it. Can be used with raw memory block.
+ * it. Can be used with raw memory block. The string is scanned by vector
+ * instructions if CPU supports them. See simd.c.
  *
  * @param [in] str String (or memory block) to search in.
  * @param [in] chars_to_string Chars enumeration to search for.
@@ -723,20 +851,18 @@ char *faux_str_c_bin(const char *src, size_t n)
  */
 char *faux_str_charsn(const char *str, const char *chars_to_search, size_t n)
 {
-	const char *current_char = str;
-	size_t len = n;
+	faux_str_charset_t set = {};
+	const char *found = NULL;
 
 	if (!str || !chars_to_search)
 		return NULL;
 
-	while ((len > 0) && (*current_char != '\0')) {
-		if (strchr(chars_to_search, *current_char))
-			return (char *)current_char;
-		current_char++;
-		len--;
-	}
+	faux_str_charset_init(&set, chars_to_search, BOOL_FALSE);
+	found = faux_str_charset_scan(str, n, &set);
+	if ((found == (str + n)) || ('\0' == *found))
+		return NULL;
 
-	return NULL;
+	return (char *)found;
 }
 
 
@@ -763,29 +889,18 @@ char *faux_str_chars(const char *str, const char *chars_to_search)
  * Find backslashes (before escaped symbols) and remove it. Escaped symbol
  * will not be analyzed so `\\` will lead to `\`.
  *
+ * @param [out] dst Buffer for de-escaped string. At least "len" bytes. The
+ * result is not '\0'-terminated.
  * @param [in] string Escaped string.
  * @param [in] len Length of string to de-escape.
- * @return Allocated de-escaped string
- * @warning Returned value must be freed by faux_str_free() later.
+ * @return Length of de-escaped string.
  */
-static char *faux_str_deesc(const char *string, size_t len)
+static size_t faux_str_deesc(char *dst, const char *string, size_t len)
 {
 	const char *s = string;
-	char *res = NULL;
-	char *p = NULL;
+	size_t n = 0;
 	bool_t escaped = BOOL_FALSE;
 
-	if (!string)
-		return NULL;
-	if (0 == len)
-		return NULL;
-
-	res = faux_zmalloc(len + 1);
-	assert(res);
-	if (!res)
-		return NULL;
-	p = res;
-
 	while ((*s != '\0') && (s < (string +len))) {
 		if (('\\' == *s) && !escaped) {
 			escaped = BOOL_TRUE;
@@ -793,13 +908,13 @@ static char *faux_str_deesc(const char *string, size_t len)
 			continue;
 		}
 		escaped = BOOL_FALSE;
-		*p = *s;
+		if (dst)
+			dst[n] = *s;
 		s++;
-		p++;
+		n++;
 	}
-	*p = '\0';
 
-	return res;
+	return n;
 }
 
 
@@ -829,15 +944,21 @@ static char *faux_str_deesc(const char *string, size_t len)
  * Parts of text with different quotes can be glued together to get single
  * substring like this: aaa"inside dbl quote"bbb``alt quote"`here``ccc.
  *
+ * The function doesn't allocate memory. The found substring is written to
+ * the buffer. The substring is never longer than the source text it's
+ * found in. So the buffer of (strlen(str) + 1) bytes is always enough.
+ * The buffer can be NULL. Then function only calculates the length of
+ * substring.
+ *
  * @param [in] str String to parse.
  * @param [out] saveptr Pointer to first symbol after found substring.
  * @param [in] alt_quotes Possible alternative quotes.
  * @param [out] qclosed Flag is quote closed.
- * @return Allocated buffer with found substring (without quotes).
- * @warning Returned alocated buffer must be freed later by faux_str_free()
+ * @param [out] buf Buffer for found substring (without quotes) or NULL.
+ * @return Length of found substring or < 0 if substring is not found.
  */
-char *faux_str_nextword(const char *str, const char **saveptr,
-	const char *alt_quotes, bool_t *qclosed)
+ssize_t faux_str_nextword_buf(const char *str, const char **saveptr,
+	const char *alt_quotes, bool_t *qclosed, char *buf)
 {
 	const char *string = str;
 	const char *word = NULL;
@@ -847,7 +968,8 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 	char alt_quote = '\0';
 	unsigned int alt_quote_num = 0; // Number of opening alt quotes
 	bool_t alt_quoted = BOOL_FALSE;
-	char *result = NULL;
+	size_t blen = 0; // Length of found substring
+	bool_t appended = BOOL_FALSE; // Some text was found
 
 	// Find the start of a word (not including an opening quote)
 	while (*string && isspace(*string))
@@ -862,9 +984,9 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 			// End of word
 			if (*string == dbl_quote) {
 				if (len > 0) {
-					char *s = faux_str_deesc(word, len);
-					faux_str_cat(&result, s);
-					faux_str_free(s);
+					blen += faux_str_deesc(buf ? (buf + blen) : NULL,
+						word, len);
+					appended = BOOL_TRUE;
 				}
 				dbl_quoted = BOOL_FALSE;
 				string++;
@@ -896,8 +1018,12 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 			if (0 == qnum) { // End of word was found
 				// Quotes themselfs are not a part of a word
 				len -= alt_quote_num;
-				if (len > 0)
-					faux_str_catn(&result, word, len);
+				if (len > 0) {
+					if (buf)
+						memcpy(buf + blen, word, len);
+					blen += len;
+					appended = BOOL_TRUE;
+				}
 				alt_quoted = BOOL_FALSE;
 				word = string;
 				len = 0;
@@ -911,9 +1037,9 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 			// Start of a double quoted string
 			if (*string == dbl_quote) {
 				if (len > 0) {
-					char *s = faux_str_deesc(word, len);
-					faux_str_cat(&result, s);
-					faux_str_free(s);
+					blen += faux_str_deesc(buf ? (buf + blen) : NULL,
+						word, len);
+					appended = BOOL_TRUE;
 				}
 				dbl_quoted = BOOL_TRUE;
 				string++;
@@ -922,9 +1048,9 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 			// Start of alt quoted string
 			} else if (alt_quotes && strchr(alt_quotes, *string)) {
 				if (len > 0) {
-					char *s = faux_str_deesc(word, len);
-					faux_str_cat(&result, s);
-					faux_str_free(s);
+					blen += faux_str_deesc(buf ? (buf + blen) : NULL,
+						word, len);
+					appended = BOOL_TRUE;
 				}
 				alt_quoted = BOOL_TRUE;
 				alt_quote = *string;
@@ -938,9 +1064,9 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 			// End of word
 			} else if (isspace(*string)) {
 				if (len > 0) {
-					char *s = faux_str_deesc(word, len);
-					faux_str_cat(&result, s);
-					faux_str_free(s);
+					blen += faux_str_deesc(buf ? (buf + blen) : NULL,
+						word, len);
+					appended = BOOL_TRUE;
 				}
 				word = string;
 				len = 0;
@@ -964,11 +1090,14 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 
 	if (len > 0) {
 		if (alt_quoted) {
-			faux_str_catn(&result, word, len);
+			if (buf)
+				memcpy(buf + blen, word, len);
+			blen += len;
+			appended = BOOL_TRUE;
 		} else {
-			char *s = faux_str_deesc(word, len);
-			faux_str_cat(&result, s);
-			faux_str_free(s);
+			blen += faux_str_deesc(buf ? (buf + blen) : NULL,
+				word, len);
+			appended = BOOL_TRUE;
 		}
 	}
 
@@ -976,8 +1105,44 @@ char *faux_str_nextword(const char *str, const char **saveptr,
 		*saveptr = string;
 	if (qclosed)
 		*qclosed = ! (dbl_quoted || alt_quoted);
+	if (buf)
+		buf[blen] = '\0';
+	if (!appended)
+		return -1;
+
+	return blen;
+}
+
+
+/** @brief Find next word or quoted substring within string
+ *
+ * See faux_str_nextword_buf() for quotation rules.
+ *
+ * @param [in] str String to parse.
+ * @param [out] saveptr Pointer to first symbol after found substring.
+ * @param [in] alt_quotes Possible alternative quotes.
+ * @param [out] qclosed Flag is quote closed.
+ * @return Allocated buffer with found substring (without quotes).
+ * @warning Returned alocated buffer must be freed later by faux_str_free()
+ */
+char *faux_str_nextword(const char *str, const char **saveptr,
+	const char *alt_quotes, bool_t *qclosed)
+{
+	char *buf = NULL;
+	ssize_t len = 0;
+
+	// Get the length of word first. So the only allocation of exact size
+	// is needed and there is no allocation when word is not found.
+	len = faux_str_nextword_buf(str, saveptr, alt_quotes, qclosed, NULL);
+	if (len < 0)
+		return NULL;
+	buf = faux_malloc(len + 1);
+	assert(buf);
+	if (!buf)
+		return NULL;
+	faux_str_nextword_buf(str, NULL, alt_quotes, NULL, buf);
 
-	return result;
+	return buf;
 }
 
 
@@ -0,0 +1,352 @@
+/** @file strbuf.c
+ * @brief String builder.
+ *
+ * The string builder keeps length of string and capacity of allocated
+ * storage. So appending doesn't need strlen() of already built string and
+ * storage grows geometrically. The building of N-bytes string from many
+ * pieces is O(N). The resulting string can be detached from builder without
+ * copying.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <assert.h>
+
+#include "faux/faux.h"
+#include "faux/str.h"
+
+#include "private.h"
+
+// Minimal capacity of storage
+#define STRBUF_MIN 64
+
+struct faux_strbuf_s {
+	char *str; // Storage. Always '\0'-terminated if not NULL
+	size_t len; // Length of string
+	size_t size; // Capacity of storage (including '\0')
+};
+
+
+/** @brief Creates new string builder.
+ *
+ * @param [in] reserve Expected length of string. Can be 0.
+ * @return Allocated string builder or NULL on error.
+ */
+faux_strbuf_t *faux_strbuf_new(size_t reserve)
+{
+	faux_strbuf_t *sb = NULL;
+
+	sb = faux_zmalloc(sizeof(*sb));
+	assert(sb);
+	if (!sb)
+		return NULL;
+
+	// Init
+	sb->str = NULL;
+	sb->len = 0;
+	sb->size = 0;
+
+	if (!faux_strbuf_reserve(sb, reserve)) {
+		faux_free(sb);
+		return NULL;
+	}
+
+	return sb;
+}
+
+
+/** @brief Frees string builder and built string.
+ *
+ * @param [in] sb String builder.
+ */
+void faux_strbuf_free(faux_strbuf_t *sb)
+{
+	if (!sb)
+		return;
+
+	faux_free(sb->str);
+	faux_free(sb);
+}
+
+
+/** @brief Detaches built string and frees string builder.
+ *
+ * The string is not copied.
+ *
+ * @warning The returned pointer must be freed by faux_str_free().
+ * @param [in] sb String builder.
+ * @return Built string or NULL on error. The empty builder gives "".
+ */
+char *faux_strbuf_detach(faux_strbuf_t *sb)
+{
+	char *str = NULL;
+
+	if (!sb)
+		return NULL;
+
+	str = sb->str;
+	faux_free(sb);
+	if (!str)
+		str = faux_str_dup("");
+
+	return str;
+}
+
+
+/** @brief Gets built string.
+ *
+ * The string belongs to builder and can be changed by next appending.
+ *
+ * @param [in] sb String builder.
+ * @return Built string. The empty builder gives "".
+ */
+const char *faux_strbuf_str(const faux_strbuf_t *sb)
+{
+	assert(sb);
+	if (!sb)
+		return NULL;
+	if (!sb->str)
+		return "";
+
+	return sb->str;
+}
+
+
+/** @brief Gets length of built string.
+ *
+ * @param [in] sb String builder.
+ * @return Length of string.
+ */
+size_t faux_strbuf_len(const faux_strbuf_t *sb)
+{
+	assert(sb);
+	if (!sb)
+		return 0;
+
+	return sb->len;
+}
+
+
+/** @brief Drops built string but keeps allocated storage.
+ *
+ * @param [in] sb String builder.
+ */
+void faux_strbuf_reset(faux_strbuf_t *sb)
+{
+	assert(sb);
+	if (!sb)
+		return;
+
+	sb->len = 0;
+	if (sb->str)
+		sb->str[0] = '\0';
+}
+
+
+/** @brief Reserves space for additional characters.
+ *
+ * The storage grows geometrically so sequential appending is cheap.
+ *
+ * @param [in] sb String builder.
+ * @param [in] add_len Number of characters to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_reserve(faux_strbuf_t *sb, size_t add_len)
+{
+	size_t need = 0;
+	size_t new_size = 0;
+	char *new_str = NULL;
+
+	assert(sb);
+	if (!sb)
+		return BOOL_FALSE;
+
+	need = sb->len + add_len + 1; // Additional byte for '\0'
+	if (need < sb->len) // Overflow
+		return BOOL_FALSE;
+	if (need <= sb->size)
+		return BOOL_TRUE;
+
+	new_size = (sb->size < STRBUF_MIN) ? STRBUF_MIN : sb->size;
+	while (new_size < need) {
+		if ((new_size * 2) < new_size) { // Overflow
+			new_size = need;
+			break;
+		}
+		new_size *= 2;
+	}
+
+	new_str = faux_realloc(sb->str, new_size);
+	if (!new_str)
+		return BOOL_FALSE;
+	if (!sb->str)
+		new_str[0] = '\0';
+	sb->str = new_str;
+	sb->size = new_size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Appends n bytes of text to built string.
+ *
+ * The text can be not '\0'-terminated. The text must not contain '\0'
+ * within first n bytes.
+ *
+ * @param [in] sb String builder.
+ * @param [in] text Text to add.
+ * @param [in] n Number of bytes to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_appendn(faux_strbuf_t *sb, const char *text, size_t n)
+{
+	assert(sb);
+	if (!sb)
+		return BOOL_FALSE;
+	if (!text)
+		return BOOL_TRUE;
+
+	if (!faux_strbuf_reserve(sb, n))
+		return BOOL_FALSE;
+	memcpy(sb->str + sb->len, text, n);
+	sb->len += n;
+	sb->str[sb->len] = '\0';
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Appends text to built string.
+ *
+ * @param [in] sb String builder.
+ * @param [in] text Text to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_append(faux_strbuf_t *sb, const char *text)
+{
+	if (!text)
+		return BOOL_TRUE;
+
+	return faux_strbuf_appendn(sb, text, strlen(text));
+}
+
+
+/** @brief Appends single character to built string.
+ *
+ * @param [in] sb String builder.
+ * @param [in] c Character to add.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_appendc(faux_strbuf_t *sb, char c)
+{
+	return faux_strbuf_appendn(sb, &c, 1);
+}
+
+
+/** @brief Appends formatted text to built string.
+ *
+ * Format is same as for vsprintf() function. The text is formatted directly
+ * into storage of builder.
+ *
+ * @param [in] sb String builder.
+ * @param [in] fmt Format string like the sprintf()'s fmt.
+ * @param [in] ap The va_list argument.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_vprintf(faux_strbuf_t *sb, const char *fmt, va_list ap)
+{
+	int size = 0;
+	size_t avail = 0;
+	va_list ap2;
+
+	assert(sb);
+	if (!sb || !fmt)
+		return BOOL_FALSE;
+
+	// Try to format into already allocated space
+	if (!faux_strbuf_reserve(sb, 0))
+		return BOOL_FALSE;
+	avail = sb->size - sb->len;
+	va_copy(ap2, ap);
+	size = vsnprintf(sb->str + sb->len, avail, fmt, ap2);
+	va_end(ap2);
+	if (size < 0) {
+		sb->str[sb->len] = '\0';
+		return BOOL_FALSE;
+	}
+
+	// Not enough space. Reserve and format once more
+	if ((size_t)size >= avail) {
+		if (!faux_strbuf_reserve(sb, size)) {
+			sb->str[sb->len] = '\0';
+			return BOOL_FALSE;
+		}
+		size = vsnprintf(sb->str + sb->len, sb->size - sb->len,
+			fmt, ap);
+		if (size < 0) {
+			sb->str[sb->len] = '\0';
+			return BOOL_FALSE;
+		}
+	}
+	sb->len += size;
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Appends formatted text to built string.
+ *
+ * Format is same as for sprintf() function.
+ *
+ * @param [in] sb String builder.
+ * @param [in] fmt Format string like the sprintf()'s fmt.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_printf(faux_strbuf_t *sb, const char *fmt, ...)
+{
+	bool_t retval = BOOL_FALSE;
+	va_list ap;
+
+	va_start(ap, fmt);
+	retval = faux_strbuf_vprintf(sb, fmt, ap);
+	va_end(ap);
+
+	return retval;
+}
+
+
+/** @brief Appends C-escaped text to built string.
+ *
+ * The escaping is the same as faux_str_c_esc() and faux_str_c_esc_space()
+ * do.
+ *
+ * @param [in] sb String builder.
+ * @param [in] text Text to escape and add.
+ * @param [in] escape_space Flag to escape spaces or not.
+ * @return BOOL_TRUE - success, BOOL_FALSE - error.
+ */
+bool_t faux_strbuf_append_escaped(faux_strbuf_t *sb, const char *text,
+	bool_t escape_space)
+{
+	size_t text_len = 0;
+	size_t esc_len = 0;
+
+	assert(sb);
+	if (!sb)
+		return BOOL_FALSE;
+	if (!text)
+		return BOOL_TRUE;
+
+	// Measure then fill directly into storage
+	text_len = strlen(text);
+	esc_len = faux_str_c_esc_fill(NULL, text, text_len, escape_space);
+	if (!faux_strbuf_reserve(sb, esc_len))
+		return BOOL_FALSE;
+	faux_str_c_esc_fill(sb->str + sb->len, text, text_len, escape_space);
+	sb->len += esc_len;
+	sb->str[sb->len] = '\0';
+
+	return BOOL_TRUE;
+}
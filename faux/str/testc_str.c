@@ -1,8 +1,15 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <pthread.h>
 
 #include "faux/str.h"
+#include "faux/ctype.h"
+
+#include "private.h"
 
 
 int testc_faux_str_nextword(void)
@@ -116,9 +123,15 @@ int testc_faux_str_numcmp(void)
 		return -1;
 	}
 
-	// Overflow
-	if (faux_str_numcmp("abc222222222222222222222222222222ccc", "abc1022222222222222222222222222222ccc") <= 0) {
-		printf("'abc222222222222222222222222222222ccc' <= 'abc1022222222222222222222222222222ccc'\n");
+	// Numbers longer than unsigned long long are compared numerically too
+	if (faux_str_numcmp("abc222222222222222222222222222222ccc", "abc1022222222222222222222222222222ccc") >= 0) {
+		printf("'abc222222222222222222222222222222ccc' >= 'abc1022222222222222222222222222222ccc'\n");
+		return -1;
+	}
+
+	// Leading zeros
+	if (faux_str_numcmp("ge-0/0/012", "ge-0/0/12") != 0) {
+		printf("'ge-0/0/012' != 'ge-0/0/12'\n");
 		return -1;
 	}
 
@@ -156,3 +169,527 @@ int testc_faux_str_c_esc_quote(void)
 
 	return 0;
 }
+
+
+int testc_faux_strbuf(void)
+{
+	faux_strbuf_t *sb = NULL;
+	char *str = NULL;
+	char *etalon = NULL;
+	unsigned int i = 0;
+
+	sb = faux_strbuf_new(0);
+	if (!sb) {
+		printf("Can't create string builder\n");
+		return -1;
+	}
+	if (strcmp(faux_strbuf_str(sb), "") != 0) {
+		printf("Empty builder gives non-empty string\n");
+		return -1;
+	}
+
+	// Many pieces. Storage must grow
+	for (i = 0; i < 1000; i++) {
+		if (!faux_strbuf_append(sb, "abc")) {
+			printf("faux_strbuf_append() error\n");
+			return -1;
+		}
+	}
+	if (faux_strbuf_len(sb) != 3000) {
+		printf("Wrong length %lu\n", faux_strbuf_len(sb));
+		return -1;
+	}
+	faux_strbuf_reset(sb);
+
+	faux_strbuf_appendn(sb, "12345", 2);
+	faux_strbuf_appendc(sb, '-');
+	faux_strbuf_printf(sb, "%d:%s", 42, "long enough string to grow the "
+		"storage of string builder over its minimal capacity");
+	faux_strbuf_appendc(sb, ' ');
+	faux_strbuf_append_escaped(sb, "a b\n\"\x01", BOOL_TRUE);
+	etalon = "12-42:long enough string to grow the storage of string "
+		"builder over its minimal capacity a\\ b\\n\\\"\\x01";
+	str = faux_strbuf_detach(sb);
+	if (strcmp(str, etalon) != 0) {
+		printf("etalon=[%s], str=[%s]\n", etalon, str);
+		return -1;
+	}
+	faux_str_free(str);
+
+	return 0;
+}
+
+
+// Reference scalar implementation of faux_str_casecmpn()
+static int ref_casecmpn(const char *str1, const char *str2, size_t n)
+{
+	size_t i = 0;
+
+	for (i = 0; i < n; i++) {
+		unsigned char c1 = (unsigned char)faux_ctype_tolower(str1[i]);
+		unsigned char c2 = (unsigned char)faux_ctype_tolower(str2[i]);
+		if (c1 != c2)
+			return (int)c1 - (int)c2;
+		if ('\0' == str1[i])
+			break;
+	}
+
+	return 0;
+}
+
+
+// Reference scalar implementation of faux_str_casestr()
+static const char *ref_casestr(const char *haystack, const char *needle)
+{
+	size_t hlen = strlen(haystack);
+	size_t nlen = strlen(needle);
+	size_t i = 0;
+
+	if (0 == nlen)
+		return ('\0' == *haystack) ? NULL : haystack;
+	for (i = 0; (i + nlen) <= hlen; i++) {
+		if (ref_casecmpn(haystack + i, needle, nlen) == 0)
+			return haystack + i;
+	}
+
+	return NULL;
+}
+
+
+// Generates random string from small alphabet to get many matches
+static void rnd_str_abc(char *str, size_t len, unsigned int *seed,
+	const char *abc)
+{
+	size_t abc_len = strlen(abc);
+	size_t i = 0;
+
+	for (i = 0; i < len; i++)
+		str[i] = abc[rand_r(seed) % abc_len];
+	str[len] = '\0';
+}
+
+
+static void rnd_str(char *str, size_t len, unsigned int *seed)
+{
+	rnd_str_abc(str, len, seed, "aAbB_zZ@[`{\xc0\xe0");
+}
+
+
+int testc_faux_str_casecmp_simd(void)
+{
+	int level = 0;
+	int max_level = faux_str_simd_level();
+	long page = sysconf(_SC_PAGESIZE);
+	char *area = NULL;
+	char *edge = NULL;
+	int retval = -1;
+
+	// Public functions
+	if ((faux_str_casecmpn("abcX", "ABCy", 3) != 0) ||
+		(faux_str_casestr("abcdef", "BCD") == NULL) ||
+		(faux_str_casecmp(NULL, "") >= 0)) {
+		printf("Public functions error\n");
+		return -1;
+	}
+
+	// Two pages. The second one is protected to catch overreading
+	area = mmap(NULL, page * 2, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == area) {
+		printf("Can't mmap()\n");
+		return -1;
+	}
+	mprotect(area + page, page, PROT_NONE);
+
+	for (level = FAUX_STR_SIMD_NONE; level <= max_level; level++) {
+		unsigned int seed = 1;
+		unsigned int iter = 0;
+		faux_str_simd_set_level(level);
+
+		for (iter = 0; iter < 20000; iter++) {
+			char s1[100] = {};
+			char s2[100] = {};
+			size_t len1 = rand_r(&seed) % 80;
+			size_t len2 = rand_r(&seed) % 80;
+			size_t n = rand_r(&seed) % 90;
+			const char *found = NULL;
+			int res = 0;
+			int etalon = 0;
+
+			rnd_str(s1, len1, &seed);
+			// Mostly equal ignoring case
+			if (rand_r(&seed) % 2) {
+				size_t i = 0;
+				for (i = 0; i <= len1; i++)
+					s2[i] = faux_ctype_toupper(s1[i]);
+				if (len1 && (rand_r(&seed) % 2))
+					s2[rand_r(&seed) % len1] = '_';
+			} else {
+				rnd_str(s2, len2, &seed);
+			}
+
+			res = faux_str_simd_casecmpn(s1, s2, n);
+			etalon = ref_casecmpn(s1, s2, n);
+			if (res != etalon) {
+				printf("casecmpn level %d: [%s] [%s] %lu: %d != %d\n",
+					level, s1, s2, n, res, etalon);
+				goto err;
+			}
+			res = faux_str_simd_casecmpn(s1, s2, SIZE_MAX);
+			etalon = ref_casecmpn(s1, s2, SIZE_MAX);
+			if (res != etalon) {
+				printf("casecmp level %d: [%s] [%s]: %d != %d\n",
+					level, s1, s2, res, etalon);
+				goto err;
+			}
+
+			// Short needle
+			s2[rand_r(&seed) % 6] = '\0';
+			found = faux_str_simd_casestr(s1, strlen(s1),
+				s2, strlen(s2));
+			if (found != ref_casestr(s1, s2)) {
+				printf("casestr level %d: [%s] [%s]\n",
+					level, s1, s2);
+				goto err;
+			}
+
+			// Strings near protected page
+			edge = area + page - len1 - 1;
+			memcpy(edge, s1, len1 + 1);
+			if ((faux_str_simd_casecmpn(edge, s1, SIZE_MAX) != 0) ||
+				(faux_str_simd_casecmpn(s1, edge, SIZE_MAX) != 0) ||
+				(faux_str_simd_casestr(edge, len1, s2, strlen(s2)) !=
+				ref_casestr(edge, s2))) {
+				printf("Page edge level %d: [%s]\n", level, s1);
+				goto err;
+			}
+		}
+	}
+	retval = 0;
+
+err:
+	faux_str_simd_set_level(max_level);
+	munmap(area, page * 2);
+
+	return retval;
+}
+
+
+// Reference implementation of faux_str_charsn()
+static const char *ref_charsn(const char *str, const char *chars, size_t n)
+{
+	size_t i = 0;
+
+	for (i = 0; (i < n) && (str[i] != '\0'); i++) {
+		if (strchr(chars, str[i]))
+			return str + i;
+	}
+
+	return NULL;
+}
+
+
+// Reference implementation of faux_str_c_esc_space()
+static char *ref_c_esc_space(const char *src)
+{
+	char *dst = malloc(strlen(src) * 4 + 1);
+	char *p = dst;
+
+	for (; *src != '\0'; src++) {
+		switch (*src) {
+		case '\n': p += sprintf(p, "\\n"); break;
+		case '\"': p += sprintf(p, "\\\""); break;
+		case '\\': p += sprintf(p, "\\\\"); break;
+		case '\'': p += sprintf(p, "\\\'"); break;
+		case '\r': p += sprintf(p, "\\r"); break;
+		case '\t': p += sprintf(p, "\\t"); break;
+		case ' ': p += sprintf(p, "\\ "); break;
+		default:
+			if (((unsigned char)*src & 0xe0) == 0)
+				p += sprintf(p, "\\x%02x", (unsigned char)*src);
+			else
+				*p++ = *src;
+			break;
+		}
+	}
+	*p = '\0';
+
+	return dst;
+}
+
+
+int testc_faux_str_charsn_simd(void)
+{
+	int level = 0;
+	int max_level = faux_str_simd_level();
+	const char *sets[] = {" \t", "\"\\'", "z", "abcdefghijklmnopqrstuvwxyz",
+		"\xc0", NULL};
+	char *bin = NULL;
+	int retval = -1;
+
+	for (level = FAUX_STR_SIMD_NONE; level <= max_level; level++) {
+		unsigned int seed = 7;
+		unsigned int iter = 0;
+		faux_str_simd_set_level(level);
+
+		for (iter = 0; iter < 5000; iter++) {
+			char str[300] = {};
+			size_t len = rand_r(&seed) % 200;
+			size_t n = rand_r(&seed) % 250;
+			const char **set = NULL;
+			size_t i = 0;
+			char *esc = NULL;
+			char *etalon = NULL;
+			faux_strbuf_t *sb = NULL;
+
+			// Rare special characters
+			for (i = 0; i < len; i++) {
+				unsigned int r = rand_r(&seed) % 64;
+				str[i] = (r < 8) ? " \t\n\"\\'\x01\xc0"[r] :
+					(char)('A' + (r % 26));
+			}
+			str[len] = '\0';
+
+			for (set = sets; *set; set++) {
+				faux_str_charset_t cs = {};
+				const char *found = NULL;
+				faux_str_charset_init(&cs, *set, BOOL_FALSE);
+				found = faux_str_charset_scan(str, n, &cs);
+				if ((found == (str + n)) || ('\0' == *found))
+					found = NULL;
+				if (found != ref_charsn(str, *set, n)) {
+					printf("charsn level %d: [%s] [%s] %lu\n",
+						level, str, *set, n);
+					goto err;
+				}
+			}
+
+			etalon = ref_c_esc_space(str);
+			esc = faux_str_c_esc_space(str);
+			sb = faux_strbuf_new(0);
+			faux_strbuf_append_escaped(sb, str, BOOL_TRUE);
+			if ((strcmp(esc, etalon) != 0) ||
+				(strcmp(faux_strbuf_str(sb), etalon) != 0)) {
+				printf("c_esc level %d: [%s] != [%s]\n",
+					level, esc, etalon);
+				goto err;
+			}
+			faux_strbuf_free(sb);
+			faux_str_free(esc);
+			free(etalon);
+		}
+	}
+
+	// Binary block
+	bin = faux_str_c_bin("\x00\xff\x1a", 3);
+	if (strcmp(bin, "\\x00\\xff\\x1a") != 0) {
+		printf("faux_str_c_bin() error\n");
+		goto err;
+	}
+	retval = 0;
+
+err:
+	faux_str_simd_set_level(max_level);
+	faux_str_free(bin);
+
+	return retval;
+}
+
+
+int testc_faux_str_numkey(void)
+{
+	const char *strs[] = {"", "a", "a0", "a00", "a1", "a01", "a9", "a10",
+		"a10b", "a10/", "a10~", "ab", "a/", "a~", "ge-0/0/2", "ge-0/0/12",
+		"ge-0/1/0", "ge-1/0/0", "xe-0/0/0", "1", "12", "100",
+		"a1000000000000000000000000000000", "a999999999999999999999999999",
+		NULL};
+	char long1[600] = {};
+	char long2[600] = {};
+	unsigned int i = 0;
+	unsigned int j = 0;
+
+	for (i = 0; strs[i]; i++) {
+		char *key1 = faux_str_numkey(strs[i]);
+		for (j = 0; strs[j]; j++) {
+			char *key2 = faux_str_numkey(strs[j]);
+			int res = faux_str_numcmp(strs[i], strs[j]);
+			int kres = faux_str_cmp(key1, key2);
+			if (((res > 0) != (kres > 0)) || ((res < 0) != (kres < 0))) {
+				printf("[%s] [%s]: numcmp=%d keycmp=%d\n",
+					strs[i], strs[j], res, kres);
+				return -1;
+			}
+			faux_str_free(key2);
+		}
+		faux_str_free(key1);
+	}
+
+	// Very long digit runs
+	memset(long1, '9', 300);
+	memset(long2, '1', 301);
+	{
+		char *key1 = faux_str_numkey(long1);
+		char *key2 = faux_str_numkey(long2);
+		if ((faux_str_numcmp(long1, long2) >= 0) ||
+			(faux_str_cmp(key1, key2) >= 0)) {
+			printf("Long digit runs comparison error\n");
+			return -1;
+		}
+		faux_str_free(key1);
+		faux_str_free(key2);
+	}
+
+	return 0;
+}
+
+
+#define INTERN_THREADS 4
+#define INTERN_NUM 3000
+
+static void *intern_thread(void *arg)
+{
+	faux_intern_t *pool = (faux_intern_t *)arg;
+	const char **res = faux_zmalloc(INTERN_NUM * sizeof(*res));
+	unsigned int i = 0;
+
+	for (i = 0; i < INTERN_NUM; i++) {
+		char name[32] = {};
+		snprintf(name, sizeof(name), "ge-0/0/%u", i);
+		res[i] = faux_intern(pool, name);
+	}
+
+	return res;
+}
+
+
+int testc_faux_intern(void)
+{
+	unsigned int flags[] = {0, FAUX_INTERN_ARENA,
+		FAUX_INTERN_ARENA | FAUX_INTERN_THREAD_SAFE};
+	unsigned int f = 0;
+
+	for (f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+		faux_intern_t *pool = faux_intern_new(flags[f]);
+		char name[32] = {};
+		char big[10000] = {};
+		const char *p1 = NULL;
+		const char *p2 = NULL;
+		unsigned int i = 0;
+
+		p1 = faux_intern(pool, "interface");
+		strcpy(name, "interface");
+		p2 = faux_intern(pool, name);
+		if (!p1 || (p1 != p2) || (strcmp(p1, "interface") != 0)) {
+			printf("Flags %u: different pointers\n", flags[f]);
+			return -1;
+		}
+		if ((faux_intern_n(pool, "interfaces", 9) != p1) ||
+			(faux_intern_find(pool, "interface") != p1) ||
+			(faux_intern_find(pool, "absent") != NULL)) {
+			printf("Flags %u: find error\n", flags[f]);
+			return -1;
+		}
+
+		// Hash table growing and big strings
+		memset(big, 'x', sizeof(big) - 1);
+		p2 = faux_intern(pool, big);
+		for (i = 0; i < 1000; i++) {
+			snprintf(name, sizeof(name), "name%u", i);
+			faux_intern(pool, name);
+		}
+		if ((faux_intern_num(pool) != 1002) ||
+			(faux_intern(pool, "interface") != p1) ||
+			(faux_intern(pool, big) != p2) ||
+			(strcmp(faux_intern_find(pool, "name999"), "name999") != 0)) {
+			printf("Flags %u: wrong content after growing\n", flags[f]);
+			return -1;
+		}
+
+		// Threads get the same pointers
+		if (flags[f] & FAUX_INTERN_THREAD_SAFE) {
+			pthread_t threads[INTERN_THREADS];
+			const char **res[INTERN_THREADS];
+			unsigned int t = 0;
+			for (t = 0; t < INTERN_THREADS; t++)
+				pthread_create(&threads[t], NULL,
+					intern_thread, pool);
+			for (t = 0; t < INTERN_THREADS; t++)
+				pthread_join(threads[t], (void **)&res[t]);
+			for (t = 1; t < INTERN_THREADS; t++) {
+				if (memcmp(res[0], res[t],
+					INTERN_NUM * sizeof(*res[0])) != 0) {
+					printf("Threads got different pointers\n");
+					return -1;
+				}
+			}
+			for (t = 0; t < INTERN_THREADS; t++)
+				faux_free(res[t]);
+		}
+
+		faux_intern_free(pool);
+	}
+
+	return 0;
+}
+
+
+int testc_faux_str_case_simd(void)
+{
+	int level = 0;
+	int max_level = faux_str_simd_level();
+	unsigned int seed = 1;
+	int c = 0;
+
+	// Table-driven ctype against "C" locale libc functions
+	for (c = 0; c < 256; c++) {
+		char ch = (char)c;
+		if ((bool_t)!!isdigit(c) != faux_ctype_isdigit(ch) ||
+			(bool_t)!!isspace(c) != faux_ctype_isspace(ch) ||
+			(bool_t)!!isxdigit(c) != faux_ctype_isxdigit(ch) ||
+			(bool_t)!!isupper(c) != faux_ctype_isupper(ch) ||
+			(bool_t)!!islower(c) != faux_ctype_islower(ch) ||
+			(bool_t)!!isalpha(c) != faux_ctype_isalpha(ch)) {
+			printf("Wrong class of char 0x%02x\n", c);
+			return -1;
+		}
+		if ((char)tolower(c) != faux_ctype_tolower(ch) ||
+			(char)toupper(c) != faux_ctype_toupper(ch)) {
+			printf("Wrong case conversion of char 0x%02x\n", c);
+			return -1;
+		}
+	}
+
+	for (level = 0; level <= max_level; level++) {
+		int iter = 0;
+		faux_str_simd_set_level(level);
+
+		for (iter = 0; iter < 5000; iter++) {
+			char src[100] = {};
+			char *lower = NULL;
+			char *upper = NULL;
+			size_t len = rand_r(&seed) % (sizeof(src) - 1);
+			size_t i = 0;
+
+			for (i = 0; i < len; i++)
+				src[i] = 1 + rand_r(&seed) % 255;
+			lower = faux_str_tolower(src);
+			upper = faux_str_toupper(src);
+			for (i = 0; i <= len; i++) {
+				if ((lower[i] != (char)tolower((unsigned char)src[i])) ||
+					(upper[i] != (char)toupper((unsigned char)src[i]))) {
+					printf("Level %d: wrong case conversion at %zu\n",
+						level, i);
+					faux_str_free(lower);
+					faux_str_free(upper);
+					faux_str_simd_set_level(max_level);
+					return -1;
+				}
+			}
+			faux_str_free(lower);
+			faux_str_free(upper);
+		}
+	}
+	faux_str_simd_set_level(max_level);
+
+	return 0;
+}
@@ -12,6 +12,8 @@
 
 #include <faux/faux.h>
 
+typedef struct faux_sysdb_cache_s faux_sysdb_cache_t;
+
 C_DECL_BEGIN
 
 // Wrappers for ugly getpwnam_r()-like functions
@@ -25,6 +27,25 @@ struct group *faux_sysdb_getgrgid(gid_t gid);
 bool_t faux_sysdb_gid_by_name(const char *name, gid_t *gid);
 char *faux_sysdb_name_by_gid(gid_t gid);
 
+// Cache for lookups. TTL is in msec
+faux_sysdb_cache_t *faux_sysdb_cache_new(size_t max_num,
+	unsigned int ttl, unsigned int neg_ttl);
+void faux_sysdb_cache_free(faux_sysdb_cache_t *cache);
+void faux_sysdb_cache_invalidate(faux_sysdb_cache_t *cache);
+void faux_sysdb_cache_release(const void *rec);
+const struct passwd *faux_sysdb_cache_getpwnam(faux_sysdb_cache_t *cache,
+	const char *name);
+const struct passwd *faux_sysdb_cache_getpwuid(faux_sysdb_cache_t *cache,
+	uid_t uid);
+const struct group *faux_sysdb_cache_getgrnam(faux_sysdb_cache_t *cache,
+	const char *name);
+const struct group *faux_sysdb_cache_getgrgid(faux_sysdb_cache_t *cache,
+	gid_t gid);
+bool_t faux_sysdb_cache_uid_by_name(faux_sysdb_cache_t *cache,
+	const char *name, uid_t *uid);
+bool_t faux_sysdb_cache_gid_by_name(faux_sysdb_cache_t *cache,
+	const char *name, gid_t *gid);
+
 C_DECL_END
 
 #endif
@@ -0,0 +1,499 @@
+/** @file cache.c
+ * @brief Cache for system database (passwd, group) lookups.
+ *
+ * The NSS lookups can be slow (LDAP, sssd etc). The cache keeps results of
+ * lookups by name and by UID/GID for limited time. The "not found" results
+ * are cached too (negative caching) with their own TTL. The number of
+ * records is limited. The least recently used record is evicted when limit
+ * is reached.
+ *
+ * The cache returns shared records. The record is immutable and it's valid
+ * until caller releases it by faux_sysdb_cache_release() even if record was
+ * evicted or cache was invalidated. So the cache hit doesn't allocate
+ * memory. The NSS lookup on cache miss is performed without lock.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "faux/faux.h"
+#include "faux/str.h"
+#include "faux/time.h"
+#include "faux/sysdb.h"
+
+#include "private.h"
+
+#define MSEC_NSEC 1000000ULL
+
+
+/** @brief Creates new cache for system database lookups.
+ *
+ * @param [in] max_num Max number of cached records. 0 - default.
+ * @param [in] ttl Time to live (msec) of found records.
+ * @param [in] neg_ttl Time to live (msec) of "not found" results. 0 - don't
+ * cache negative results.
+ * @return Allocated cache or NULL on error.
+ */
+faux_sysdb_cache_t *faux_sysdb_cache_new(size_t max_num,
+	unsigned int ttl, unsigned int neg_ttl)
+{
+	faux_sysdb_cache_t *cache = NULL;
+
+	cache = faux_zmalloc(sizeof(*cache));
+	assert(cache);
+	if (!cache)
+		return NULL;
+
+	// Init
+	cache->max_num = (max_num != 0) ? max_num : FAUX_SYSDB_CACHE_NUM;
+	cache->ttl = ttl * MSEC_NSEC;
+	cache->neg_ttl = neg_ttl * MSEC_NSEC;
+	cache->head = NULL;
+	cache->tail = NULL;
+	cache->num = 0;
+	cache->buckets_num = FAUX_SYSDB_CACHE_BUCKETS;
+	while (cache->buckets_num < cache->max_num)
+		cache->buckets_num <<= 1;
+	cache->buckets = faux_zmalloc(cache->buckets_num *
+		sizeof(*cache->buckets));
+	assert(cache->buckets);
+	if (!cache->buckets) {
+		faux_free(cache);
+		return NULL;
+	}
+	pthread_mutex_init(&cache->mutex, NULL);
+
+	return cache;
+}
+
+
+/** @brief Frees cache.
+ *
+ * The records that are not released by callers yet stay valid.
+ *
+ * @param [in] cache Cache.
+ */
+void faux_sysdb_cache_free(faux_sysdb_cache_t *cache)
+{
+	if (!cache)
+		return;
+
+	faux_sysdb_cache_invalidate(cache);
+	pthread_mutex_destroy(&cache->mutex);
+	faux_free(cache->buckets);
+	faux_free(cache);
+}
+
+
+/** @brief Drops reference to entry. Frees entry on last reference.
+ *
+ * Static function.
+ *
+ * @param [in] entry Cache entry.
+ */
+static void faux_sysdb_entry_unref(faux_sysdb_entry_t *entry)
+{
+	if (__atomic_sub_fetch(&entry->refcnt, 1, __ATOMIC_ACQ_REL) != 0)
+		return;
+	faux_str_free(entry->name);
+	faux_free(entry);
+}
+
+
+/** @brief Releases record got from cache.
+ *
+ * @param [in] rec Pointer to passwd or group structure got from cache.
+ */
+void faux_sysdb_cache_release(const void *rec)
+{
+	if (!rec)
+		return;
+
+	faux_sysdb_entry_unref((faux_sysdb_entry_t *)
+		((char *)rec - offsetof(faux_sysdb_entry_t, rec)));
+}
+
+
+/** @brief Gets current monotonic time in nsec.
+ *
+ * Static function.
+ */
+static uint64_t faux_sysdb_cache_now(void)
+{
+	struct timespec now = {};
+
+	faux_timespec_now_monotonic(&now);
+
+	return faux_timespec_to_nsec(&now);
+}
+
+
+/** @brief Calculates hash of key.
+ *
+ * Static function. FNV-1a for names and multiplicative hash for IDs.
+ *
+ * @param [in] kind Kind of key.
+ * @param [in] name Name or NULL for search by ID.
+ * @param [in] id UID or GID.
+ * @return Hash value.
+ */
+static uint64_t faux_sysdb_cache_hash(faux_sysdb_kind_e kind,
+	const char *name, unsigned long int id)
+{
+	uint64_t hash = 14695981039346656037ULL ^ kind;
+
+	if (!name)
+		return (hash ^ id) * 0x9e3779b97f4a7c15ULL;
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+
+/** @brief Finds entry within hash table.
+ *
+ * Static function. Must be called under lock.
+ */
+static faux_sysdb_entry_t *faux_sysdb_cache_find(faux_sysdb_cache_t *cache,
+	uint64_t hash, faux_sysdb_kind_e kind,
+	const char *name, unsigned long int id)
+{
+	faux_sysdb_entry_t *entry = NULL;
+
+	entry = cache->buckets[hash & (cache->buckets_num - 1)];
+	for (; entry; entry = entry->hnext) {
+		if ((entry->hash != hash) || (entry->kind != kind))
+			continue;
+		if (name ? (strcmp(entry->name, name) == 0) : (entry->id == id))
+			return entry;
+	}
+
+	return NULL;
+}
+
+
+/** @brief Unlinks entry from LRU list.
+ *
+ * Static function. Must be called under lock.
+ */
+static void faux_sysdb_cache_lru_unlink(faux_sysdb_cache_t *cache,
+	faux_sysdb_entry_t *entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		cache->head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		cache->tail = entry->prev;
+	entry->prev = NULL;
+	entry->next = NULL;
+}
+
+
+/** @brief Links entry to the head of LRU list.
+ *
+ * Static function. Must be called under lock.
+ */
+static void faux_sysdb_cache_lru_push(faux_sysdb_cache_t *cache,
+	faux_sysdb_entry_t *entry)
+{
+	entry->prev = NULL;
+	entry->next = cache->head;
+	if (cache->head)
+		cache->head->prev = entry;
+	else
+		cache->tail = entry;
+	cache->head = entry;
+}
+
+
+/** @brief Removes entry from cache and drops cache's reference.
+ *
+ * Static function. Must be called under lock.
+ */
+static void faux_sysdb_cache_remove(faux_sysdb_cache_t *cache,
+	faux_sysdb_entry_t *entry)
+{
+	faux_sysdb_entry_t **link = NULL;
+
+	link = &cache->buckets[entry->hash & (cache->buckets_num - 1)];
+	while (*link != entry)
+		link = &(*link)->hnext;
+	*link = entry->hnext;
+	faux_sysdb_cache_lru_unlink(cache, entry);
+	cache->num--;
+	faux_sysdb_entry_unref(entry);
+}
+
+
+/** @brief Removes all records from cache.
+ *
+ * The next lookups will query the system database. The records that are
+ * not released by callers yet stay valid.
+ *
+ * @param [in] cache Cache.
+ */
+void faux_sysdb_cache_invalidate(faux_sysdb_cache_t *cache)
+{
+	assert(cache);
+	if (!cache)
+		return;
+
+	pthread_mutex_lock(&cache->mutex);
+	while (cache->head)
+		faux_sysdb_cache_remove(cache, cache->head);
+	pthread_mutex_unlock(&cache->mutex);
+}
+
+
+/** @brief Queries system database and creates new entry.
+ *
+ * Static function. The lock is not needed.
+ *
+ * @return New entry with single reference or NULL on error (errno is set).
+ */
+static faux_sysdb_entry_t *faux_sysdb_cache_fetch(faux_sysdb_kind_e kind,
+	const char *name, unsigned long int id)
+{
+	const size_t offset = offsetof(faux_sysdb_entry_t, rec);
+	faux_sysdb_entry_t *entry = NULL;
+	int err = 0;
+
+	switch (kind) {
+	case FAUX_SYSDB_PWNAM:
+	case FAUX_SYSDB_PWUID:
+		entry = faux_sysdb_pw_lookup(name, id, offset);
+		break;
+	default:
+		entry = faux_sysdb_gr_lookup(name, id, offset);
+		break;
+	}
+
+	if (entry) {
+		entry->found = BOOL_TRUE;
+	} else {
+		// Only "not found" result is cached. Other errors can be
+		// temporary.
+		err = errno;
+		if (err != ENOENT)
+			return NULL;
+		entry = faux_zmalloc(sizeof(*entry));
+		if (!entry)
+			return NULL;
+		entry->found = BOOL_FALSE;
+		entry->err = err;
+	}
+	entry->kind = kind;
+	entry->id = id;
+	entry->hash = faux_sysdb_cache_hash(kind, name, id);
+	entry->refcnt = 1;
+	if (name) {
+		entry->name = faux_str_dup(name);
+		if (!entry->name) {
+			faux_free(entry);
+			return NULL;
+		}
+	}
+
+	return entry;
+}
+
+
+/** @brief Gets entry from cache or system database.
+ *
+ * Static function.
+ *
+ * @return Found record or NULL (errno is set).
+ */
+static void *faux_sysdb_cache_get(faux_sysdb_cache_t *cache,
+	faux_sysdb_kind_e kind, const char *name, unsigned long int id)
+{
+	uint64_t hash = faux_sysdb_cache_hash(kind, name, id);
+	uint64_t now = faux_sysdb_cache_now();
+	faux_sysdb_entry_t *entry = NULL;
+	faux_sysdb_entry_t *old = NULL;
+	uint64_t ttl = 0;
+
+	// Fast path: cache hit
+	pthread_mutex_lock(&cache->mutex);
+	entry = faux_sysdb_cache_find(cache, hash, kind, name, id);
+	if (entry && (entry->expire > now)) {
+		faux_sysdb_cache_lru_unlink(cache, entry);
+		faux_sysdb_cache_lru_push(cache, entry);
+		__atomic_add_fetch(&entry->refcnt, 1, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&cache->mutex);
+		goto out;
+	}
+	pthread_mutex_unlock(&cache->mutex);
+
+	// Slow path: query system database without lock
+	entry = faux_sysdb_cache_fetch(kind, name, id);
+	if (!entry)
+		return NULL;
+	ttl = entry->found ? cache->ttl : cache->neg_ttl;
+	if (0 == ttl) // Don't cache it
+		goto out;
+	entry->expire = now + ttl;
+
+	pthread_mutex_lock(&cache->mutex);
+	old = faux_sysdb_cache_find(cache, hash, kind, name, id);
+	if (old && (old->expire >= entry->expire)) {
+		// Another thread has already stored fresh record
+		faux_sysdb_entry_unref(entry);
+		entry = old;
+		faux_sysdb_cache_lru_unlink(cache, entry);
+		faux_sysdb_cache_lru_push(cache, entry);
+		__atomic_add_fetch(&entry->refcnt, 1, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&cache->mutex);
+		goto out;
+	}
+	if (old)
+		faux_sysdb_cache_remove(cache, old);
+	while (cache->num >= cache->max_num)
+		faux_sysdb_cache_remove(cache, cache->tail);
+	entry->hnext = cache->buckets[hash & (cache->buckets_num - 1)];
+	cache->buckets[hash & (cache->buckets_num - 1)] = entry;
+	faux_sysdb_cache_lru_push(cache, entry);
+	cache->num++;
+	entry->refcnt++; // Cache's reference
+	pthread_mutex_unlock(&cache->mutex);
+
+out:
+	if (!entry->found) {
+		errno = entry->err;
+		faux_sysdb_entry_unref(entry);
+		return NULL;
+	}
+
+	return &entry->rec;
+}
+
+
+/** @brief Gets passwd structure by user name using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] name User name.
+ * @return Shared passwd record or NULL on error (errno is set).
+ * @warning The record must be released by faux_sysdb_cache_release().
+ */
+const struct passwd *faux_sysdb_cache_getpwnam(faux_sysdb_cache_t *cache,
+	const char *name)
+{
+	assert(cache);
+	assert(name);
+	if (!cache || !name)
+		return NULL;
+
+	return faux_sysdb_cache_get(cache, FAUX_SYSDB_PWNAM, name, 0);
+}
+
+
+/** @brief Gets passwd structure by UID using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] uid UID.
+ * @return Shared passwd record or NULL on error (errno is set).
+ * @warning The record must be released by faux_sysdb_cache_release().
+ */
+const struct passwd *faux_sysdb_cache_getpwuid(faux_sysdb_cache_t *cache,
+	uid_t uid)
+{
+	assert(cache);
+	if (!cache)
+		return NULL;
+
+	return faux_sysdb_cache_get(cache, FAUX_SYSDB_PWUID, NULL, uid);
+}
+
+
+/** @brief Gets group structure by group name using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] name Group name.
+ * @return Shared group record or NULL on error (errno is set).
+ * @warning The record must be released by faux_sysdb_cache_release().
+ */
+const struct group *faux_sysdb_cache_getgrnam(faux_sysdb_cache_t *cache,
+	const char *name)
+{
+	assert(cache);
+	assert(name);
+	if (!cache || !name)
+		return NULL;
+
+	return faux_sysdb_cache_get(cache, FAUX_SYSDB_GRNAM, name, 0);
+}
+
+
+/** @brief Gets group structure by GID using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] gid GID.
+ * @return Shared group record or NULL on error (errno is set).
+ * @warning The record must be released by faux_sysdb_cache_release().
+ */
+const struct group *faux_sysdb_cache_getgrgid(faux_sysdb_cache_t *cache,
+	gid_t gid)
+{
+	assert(cache);
+	if (!cache)
+		return NULL;
+
+	return faux_sysdb_cache_get(cache, FAUX_SYSDB_GRGID, NULL, gid);
+}
+
+
+/** @brief Get UID by user name using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] name User name.
+ * @param [out] uid UID.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sysdb_cache_uid_by_name(faux_sysdb_cache_t *cache,
+	const char *name, uid_t *uid)
+{
+	const struct passwd *pw = NULL;
+
+	pw = faux_sysdb_cache_getpwnam(cache, name);
+	if (!pw)
+		return BOOL_FALSE; // Unknown user
+	if (uid)
+		*uid = pw->pw_uid;
+	faux_sysdb_cache_release(pw);
+
+	return BOOL_TRUE;
+}
+
+
+/** @brief Get GID by group name using cache.
+ *
+ * @param [in] cache Cache.
+ * @param [in] name Group name.
+ * @param [out] gid GID.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+bool_t faux_sysdb_cache_gid_by_name(faux_sysdb_cache_t *cache,
+	const char *name, gid_t *gid)
+{
+	const struct group *gr = NULL;
+
+	gr = faux_sysdb_cache_getgrnam(cache, name);
+	if (!gr)
+		return BOOL_FALSE; // Unknown group
+	if (gid)
+		*gid = gr->gr_gid;
+	faux_sysdb_cache_release(gr);
+
+	return BOOL_TRUE;
+}
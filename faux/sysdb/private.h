@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <pthread.h>
+
+#include "faux/faux.h"
+#include "faux/sysdb.h"
+
+/** @brief Default max number of cached records */
+#define FAUX_SYSDB_CACHE_NUM 256
+
+/** @brief Min number of hash table buckets. Must be power of two */
+#define FAUX_SYSDB_CACHE_BUCKETS 16
+
+// Kind of cache key
+typedef enum {
+	FAUX_SYSDB_PWNAM,
+	FAUX_SYSDB_PWUID,
+	FAUX_SYSDB_GRNAM,
+	FAUX_SYSDB_GRGID
+} faux_sysdb_kind_e;
+
+typedef struct faux_sysdb_entry_s faux_sysdb_entry_t;
+
+struct faux_sysdb_entry_s {
+	faux_sysdb_entry_t *hnext; // Next entry within hash bucket
+	faux_sysdb_entry_t *prev; // LRU list. The head is most recently used
+	faux_sysdb_entry_t *next;
+	unsigned int refcnt; // Cache and callers references
+	uint64_t expire; // Expiration time (monotonic nsec)
+	uint64_t hash;
+	faux_sysdb_kind_e kind;
+	char *name; // Key for search by name
+	unsigned long int id; // Key for search by UID/GID
+	bool_t found; // BOOL_FALSE for negative entry
+	int err; // errno of negative entry
+	union {
+		struct passwd pw;
+		struct group gr;
+	} rec; // NSS buffer follows the record
+};
+
+struct faux_sysdb_cache_s {
+	faux_sysdb_entry_t **buckets;
+	size_t buckets_num; // Power of two
+	faux_sysdb_entry_t *head; // LRU list
+	faux_sysdb_entry_t *tail;
+	size_t num; // Number of cached entries
+	size_t max_num;
+	uint64_t ttl; // nsec
+	uint64_t neg_ttl; // nsec. 0 - don't cache negative results
+	pthread_mutex_t mutex;
+};
+
+C_DECL_BEGIN
+
+FAUX_HIDDEN void *faux_sysdb_pw_lookup(const char *name, uid_t uid,
+	size_t offset);
+FAUX_HIDDEN void *faux_sysdb_gr_lookup(const char *name, gid_t gid,
+	size_t offset);
+
+C_DECL_END
@@ -19,47 +19,147 @@
 #include "faux/str.h"
 #include "faux/sysdb.h"
 
+#include "private.h"
+
 #define DEFAULT_GETPW_R_SIZE_MAX 1024
+// Upper limit of buffer size for retries on ERANGE
+#define MAX_GETPW_R_SIZE (1024 * 1024)
 
+// Cached sysconf() values. 0 - not initialized yet
+static long int getpw_r_size = 0;
+static long int getgr_r_size = 0;
 
-/** @brief Wrapper for ugly getpwnam_r() function.
+
+/** @brief Gets initial buffer size for getpwnam_r()-like functions.
  *
- * Gets passwd structure by user name. Easy to use.
+ * Static function. The sysconf() is called once. Then value is cached.
  *
- * @param [in] name User name.
- * @return Pointer to allocated passwd structure.
- * @warning The resulting pointer (return value) must be freed by faux_free().
+ * @param [in] group BOOL_TRUE for group functions, BOOL_FALSE for passwd.
+ * @return Buffer size.
  */
-struct passwd *faux_sysdb_getpwnam(const char *name)
+static long int faux_sysdb_buf_size(bool_t group)
 {
-	long int size = 0;
-	char *buf = NULL;
-	struct passwd *pwbuf = NULL;
-	struct passwd *pw = NULL;
-	int res = 0;
+	long int *cached = group ? &getgr_r_size : &getpw_r_size;
+	long int size = __atomic_load_n(cached, __ATOMIC_RELAXED);
+
+	if (size > 0)
+		return size;
 
+	size = -1;
 #ifdef _SC_GETPW_R_SIZE_MAX
-	if ((size = sysconf(_SC_GETPW_R_SIZE_MAX)) < 0)
-		size = DEFAULT_GETPW_R_SIZE_MAX;
-#else
-	size = DEFAULT_GETPW_R_SIZE_MAX;
+	if (!group)
+		size = sysconf(_SC_GETPW_R_SIZE_MAX);
+#endif
+#ifdef _SC_GETGR_R_SIZE_MAX
+	if (group)
+		size = sysconf(_SC_GETGR_R_SIZE_MAX);
 #endif
-	pwbuf = faux_zmalloc(sizeof(*pwbuf) + size);
-	if (!pwbuf)
+	if (size <= 0)
+		size = DEFAULT_GETPW_R_SIZE_MAX;
+	__atomic_store_n(cached, size, __ATOMIC_RELAXED);
+
+	return size;
+}
+
+
+/** @brief Gets passwd structure by user name or UID.
+ *
+ * The allocated block contains "offset" bytes for caller's header, passwd
+ * structure and buffer for strings. The buffer is enlarged if it's not
+ * enough for record.
+ *
+ * @param [in] name User name. If NULL then search by UID.
+ * @param [in] uid UID.
+ * @param [in] offset Offset of passwd structure within allocated block.
+ * @return Allocated block or NULL on error (errno is set).
+ */
+void *faux_sysdb_pw_lookup(const char *name, uid_t uid, size_t offset)
+{
+	long int size = faux_sysdb_buf_size(BOOL_FALSE);
+
+	for (;;) {
+		char *block = NULL;
+		struct passwd *pwbuf = NULL;
+		struct passwd *pw = NULL;
+		int res = 0;
+
+		block = faux_zmalloc(offset + sizeof(*pwbuf) + size);
+		if (!block)
+			return NULL;
+		pwbuf = (struct passwd *)(block + offset);
+		if (name)
+			res = getpwnam_r(name, pwbuf, (char *)(pwbuf + 1),
+				size, &pw);
+		else
+			res = getpwuid_r(uid, pwbuf, (char *)(pwbuf + 1),
+				size, &pw);
+		if ((0 == res) && pw)
+			return block;
+		faux_free(block);
+		if ((ERANGE == res) && (size < MAX_GETPW_R_SIZE)) {
+			size *= 2;
+			continue;
+		}
+		errno = (res != 0) ? res : ENOENT;
 		return NULL;
-	buf = (char *)pwbuf + sizeof(*pwbuf);
+	}
+}
+
 
-	res = getpwnam_r(name, pwbuf, buf, size, &pw);
-	if ((res != 0) || !pw) {
-		faux_free(pwbuf);
-		if (res != 0)
-			errno = res;
+/** @brief Gets group structure by group name or GID.
+ *
+ * See faux_sysdb_pw_lookup().
+ *
+ * @param [in] name Group name. If NULL then search by GID.
+ * @param [in] gid GID.
+ * @param [in] offset Offset of group structure within allocated block.
+ * @return Allocated block or NULL on error (errno is set).
+ */
+void *faux_sysdb_gr_lookup(const char *name, gid_t gid, size_t offset)
+{
+	long int size = faux_sysdb_buf_size(BOOL_TRUE);
+
+	for (;;) {
+		char *block = NULL;
+		struct group *grbuf = NULL;
+		struct group *gr = NULL;
+		int res = 0;
+
+		block = faux_zmalloc(offset + sizeof(*grbuf) + size);
+		if (!block)
+			return NULL;
+		grbuf = (struct group *)(block + offset);
+		if (name)
+			res = getgrnam_r(name, grbuf, (char *)(grbuf + 1),
+				size, &gr);
 		else
-			errno = ENOENT;
+			res = getgrgid_r(gid, grbuf, (char *)(grbuf + 1),
+				size, &gr);
+		if ((0 == res) && gr)
+			return block;
+		faux_free(block);
+		if ((ERANGE == res) && (size < MAX_GETPW_R_SIZE)) {
+			size *= 2;
+			continue;
+		}
+		errno = (res != 0) ? res : ENOENT;
 		return NULL;
 	}
+}
 
-	return pwbuf;
+
+/** @brief Wrapper for ugly getpwnam_r() function.
+ *
+ * Gets passwd structure by user name. Easy to use.
+ *
+ * @param [in] name User name.
+ * @return Pointer to allocated passwd structure.
+ * @warning The resulting pointer (return value) must be freed by faux_free().
+ * @sa faux_sysdb_cache_getpwnam()
+ */
+struct passwd *faux_sysdb_getpwnam(const char *name)
+{
+	return faux_sysdb_pw_lookup(name, 0, 0);
 }
 
 
@@ -70,37 +170,11 @@ struct passwd *faux_sysdb_getpwnam(const char *name)
  * @param [in] uid UID.
  * @return Pointer to allocated passwd structure.
  * @warning The resulting pointer (return value) must be freed by faux_free().
+ * @sa faux_sysdb_cache_getpwuid()
  */
 struct passwd *faux_sysdb_getpwuid(uid_t uid)
 {
-	long int size = 0;
-	char *buf = NULL;
-	struct passwd *pwbuf = NULL;
-	struct passwd *pw = NULL;
-	int res = 0;
-
-#ifdef _SC_GETPW_R_SIZE_MAX
-	if ((size = sysconf(_SC_GETPW_R_SIZE_MAX)) < 0)
-		size = DEFAULT_GETPW_R_SIZE_MAX;
-#else
-	size = DEFAULT_GETPW_R_SIZE_MAX;
-#endif
-	pwbuf = faux_zmalloc(sizeof(*pwbuf) + size);
-	if (!pwbuf)
-		return NULL;
-	buf = (char *)pwbuf + sizeof(*pwbuf);
-
-	res = getpwuid_r(uid, pwbuf, buf, size, &pw);
-	if (!pw) {
-		faux_free(pwbuf);
-		if (res != 0)
-			errno = res;
-		else
-			errno = ENOENT;
-		return NULL;
-	}
-
-	return pwbuf;
+	return faux_sysdb_pw_lookup(NULL, uid, 0);
 }
 
 
@@ -157,37 +231,11 @@ char *faux_sysdb_name_by_uid(uid_t uid)
  * @param [in] name Group name.
  * @return Pointer to allocated group structure.
  * @warning The resulting pointer (return value) must be freed by faux_free().
+ * @sa faux_sysdb_cache_getgrnam()
  */
 struct group *faux_sysdb_getgrnam(const char *name)
 {
-	long int size;
-	char *buf;
-	struct group *grbuf;
-	struct group *gr = NULL;
-	int res = 0;
-
-#ifdef _SC_GETGR_R_SIZE_MAX
-	if ((size = sysconf(_SC_GETGR_R_SIZE_MAX)) < 0)
-		size = DEFAULT_GETPW_R_SIZE_MAX;
-#else
-	size = DEFAULT_GETPW_R_SIZE_MAX;
-#endif
-	grbuf = faux_zmalloc(sizeof(*grbuf) + size);
-	if (!grbuf)
-		return NULL;
-	buf = (char *)grbuf + sizeof(*grbuf);
-
-	res = getgrnam_r(name, grbuf, buf, size, &gr);
-	if (!gr) {
-		faux_free(grbuf);
-		if (res != 0)
-			errno = res;
-		else
-			errno = ENOENT;
-		return NULL;
-	}
-
-	return grbuf;
+	return faux_sysdb_gr_lookup(name, 0, 0);
 }
 
 
@@ -198,37 +246,11 @@ struct group *faux_sysdb_getgrnam(const char *name)
  * @param [in] gid GID.
  * @return Pointer to allocated group structure.
  * @warning The resulting pointer (return value) must be freed by faux_free().
+ * @sa faux_sysdb_cache_getgrgid()
  */
 struct group *faux_sysdb_getgrgid(gid_t gid)
 {
-	long int size;
-	char *buf;
-	struct group *grbuf;
-	struct group *gr = NULL;
-	int res = 0;
-
-#ifdef _SC_GETGR_R_SIZE_MAX
-	if ((size = sysconf(_SC_GETGR_R_SIZE_MAX)) < 0)
-		size = DEFAULT_GETPW_R_SIZE_MAX;
-#else
-	size = DEFAULT_GETPW_R_SIZE_MAX;
-#endif
-	grbuf = faux_zmalloc(sizeof(struct group) + size);
-	if (!grbuf)
-		return NULL;
-	buf = (char *)grbuf + sizeof(struct group);
-
-	res = getgrgid_r(gid, grbuf, buf, size, &gr);
-	if (!gr) {
-		faux_free(grbuf);
-		if (res != 0)
-			errno = res;
-		else
-			errno = ENOENT;
-		return NULL;
-	}
-
-	return grbuf;
+	return faux_sysdb_gr_lookup(NULL, gid, 0);
 }
 
 
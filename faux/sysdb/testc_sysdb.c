@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "faux/sysdb.h"
+
+#define THREADS_NUM 4
+
+
+static void *sysdb_thread(void *arg)
+{
+	faux_sysdb_cache_t *cache = (faux_sysdb_cache_t *)arg;
+	unsigned int i = 0;
+
+	for (i = 0; i < 10000; i++) {
+		const struct passwd *pw = faux_sysdb_cache_getpwuid(cache, 0);
+		if (!pw || (pw->pw_uid != 0))
+			return (void *)1;
+		faux_sysdb_cache_release(pw);
+		if (0 == (i % 1000))
+			faux_sysdb_cache_invalidate(cache);
+	}
+
+	return NULL;
+}
+
+
+int testc_faux_sysdb_cache(void)
+{
+	faux_sysdb_cache_t *cache = NULL;
+	const struct passwd *pw1 = NULL;
+	const struct passwd *pw2 = NULL;
+	const struct group *gr = NULL;
+	pthread_t threads[THREADS_NUM];
+	uid_t uid = 1;
+	unsigned int i = 0;
+	int ret = -1;
+
+	cache = faux_sysdb_cache_new(2, 60000, 60000);
+	if (!cache)
+		return -1;
+
+	// Repeated lookup returns shared record
+	pw1 = faux_sysdb_cache_getpwnam(cache, "root");
+	pw2 = faux_sysdb_cache_getpwnam(cache, "root");
+	if (!pw1 || (pw1 != pw2) || (pw1->pw_uid != 0)) {
+		printf("Cached record for root is not shared\n");
+		goto err;
+	}
+	faux_sysdb_cache_release(pw2);
+	pw2 = NULL;
+
+	// Invalidated record stays valid while it's referenced
+	faux_sysdb_cache_invalidate(cache);
+	pw2 = faux_sysdb_cache_getpwnam(cache, "root");
+	if (!pw2 || (pw2 == pw1) || strcmp(pw1->pw_name, "root")) {
+		printf("Wrong record after invalidation\n");
+		goto err;
+	}
+	faux_sysdb_cache_release(pw1);
+	faux_sysdb_cache_release(pw2);
+	pw1 = NULL;
+	pw2 = NULL;
+
+	// Negative caching
+	errno = 0;
+	if (faux_sysdb_cache_uid_by_name(cache, "faux-no-such-user", &uid) ||
+		(errno != ENOENT)) {
+		printf("Unknown user is found\n");
+		goto err;
+	}
+	errno = 0;
+	if (faux_sysdb_cache_getpwnam(cache, "faux-no-such-user") ||
+		(errno != ENOENT)) {
+		printf("Negative result is not cached\n");
+		goto err;
+	}
+
+	// Groups. The records are evicted because of max_num
+	gr = faux_sysdb_cache_getgrgid(cache, 0);
+	if (!gr || (gr->gr_gid != 0)) {
+		printf("Can't get group 0\n");
+		goto err;
+	}
+	faux_sysdb_cache_release(gr);
+	if (!faux_sysdb_cache_uid_by_name(cache, "root", &uid) || (uid != 0)) {
+		printf("Can't get UID of root\n");
+		goto err;
+	}
+
+	// Concurrent lookups and invalidations
+	for (i = 0; i < THREADS_NUM; i++)
+		pthread_create(&threads[i], NULL, sysdb_thread, cache);
+	ret = 0;
+	for (i = 0; i < THREADS_NUM; i++) {
+		void *res = NULL;
+		pthread_join(threads[i], &res);
+		if (res) {
+			printf("Thread lookup failed\n");
+			ret = -1;
+		}
+	}
+
+err:
+	faux_sysdb_cache_release(pw1);
+	faux_sysdb_cache_release(pw2);
+	faux_sysdb_cache_free(cache);
+
+	return ret;
+}
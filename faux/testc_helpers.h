@@ -6,11 +6,30 @@
 #define _faux_testc_helpers_h
 
 #include <stddef.h>
+#include <stdint.h>
+#include <time.h>
 
 #include <faux/faux.h>
 
 #define FAUX_TESTC_TMPDIR_ENV "TESTC_TMPDIR"
 
+/** @brief Benchmark state.
+ *
+ * The structure is filled by testc and passed to benchmark function
+ * "int bench_xxx(faux_testc_bench_t *bench)". The benchmark function must
+ * execute measured operation "iters" times. Function can exclude setup code
+ * from measurement by faux_testc_bench_stop() and faux_testc_bench_start().
+ * The timer is already started when benchmark function is called. Function
+ * returns 0 on success.
+ */
+typedef struct faux_testc_bench_s {
+	uint64_t iters; // Number of iterations to execute
+	uint64_t bytes; // Bytes processed by single iteration. Optional
+	uint64_t elapsed; // Measured time (nsec)
+	struct timespec start; // Start of current measured interval
+	bool_t running; // Timer is running
+} faux_testc_bench_t;
+
 C_DECL_BEGIN
 
 ssize_t faux_testc_file_deploy(const char *fn, const void *buf, size_t len);
@@ -21,6 +40,41 @@ int faux_testc_file_cmp(const char *first_file, const char *second_file);
 bool_t faux_testc_fill_rnd(void *buf, size_t len);
 char *faux_testc_rnd_buf(size_t len);
 
+// Benchmark timer. The functions are inline because testc itself must not
+// depend on tested library.
+static inline void faux_testc_bench_start(faux_testc_bench_t *bench)
+{
+	if (bench->running)
+		return;
+	bench->running = BOOL_TRUE;
+	clock_gettime(CLOCK_MONOTONIC, &bench->start);
+}
+
+static inline void faux_testc_bench_stop(faux_testc_bench_t *bench)
+{
+	struct timespec now = {};
+
+	if (!bench->running)
+		return;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	bench->elapsed += (now.tv_sec - bench->start.tv_sec) * 1000000000LL +
+		(now.tv_nsec - bench->start.tv_nsec);
+	bench->running = BOOL_FALSE;
+}
+
+static inline void faux_testc_bench_reset(faux_testc_bench_t *bench)
+{
+	bench->elapsed = 0;
+	if (bench->running)
+		clock_gettime(CLOCK_MONOTONIC, &bench->start);
+}
+
+static inline void faux_testc_bench_set_bytes(faux_testc_bench_t *bench,
+	uint64_t bytes)
+{
+	bench->bytes = bytes;
+}
+
 C_DECL_END
 
 #endif				/* _faux_testc_helpers_h */
@@ -12,12 +12,29 @@ const char *testc_module[][2] = {
 
 	// base
 	{"testc_faux_filesize", "Get size of filesystem object"},
+	{"testc_faux_mem_stat", "Allocation statistics"},
+	{"testc_faux_mem_stat_balance", "Allocations and frees are balanced"},
+	{"testc_faux_read_whole_file_mapped", "Read whole file using mapping"},
+
+	// file
+	{"testc_faux_file_getline", "Buffered line reading"},
+	{"testc_faux_file_map", "Map whole file to memory"},
+	{"testc_faux_file_write_buf", "Buffered writing"},
 
 	// str
 	{"testc_faux_str_nextword", "Find next word (quotation)"},
 	{"testc_faux_str_getline", "Get line from string"},
 	{"testc_faux_str_numcmp", "Numeric comparison"},
+	{"testc_faux_str_numkey", "Sort key for numeric comparison"},
 	{"testc_faux_str_c_esc_quote", "Escape and add quotes for string with spaces"},
+	{"testc_faux_strbuf", "String builder"},
+	{"testc_faux_str_casecmp_simd", "Vector case-insensitive functions against scalar ones"},
+	{"testc_faux_str_charsn_simd", "Vector charset scanner and escaping"},
+	{"testc_faux_str_case_simd", "Table-driven ctype and vector case conversion"},
+	{"testc_faux_intern", "String interning pool"},
+
+	// error
+	{"testc_faux_error", "Unbounded and bounded error stack"},
 
 	// ini
 	{"testc_faux_ini_parse_file", "Complex test of INI file parsing"},
@@ -27,6 +44,15 @@ const char *testc_module[][2] = {
 	{"testc_faux_argv_parse", "Parse string to arguments"},
 	{"testc_faux_argv_is_continuable", "Is line continuable"},
 	{"testc_faux_argv_index", "Get argument by index"},
+	{"testc_faux_argv_arena", "Arena mode and incremental reparsing"},
+
+	// sysdb
+	{"testc_faux_sysdb_cache", "Cache for passwd and group lookups"},
+
+	// conv
+	{"testc_faux_conv_ato", "Convert string to integer against strtol()"},
+	{"testc_faux_conv_format", "Convert integer to string against snprintf()"},
+	{"testc_faux_conv_atoull_rnd", "Conversion of random numbers"},
 
 	// time
 	{"testc_faux_nsec_timespec_conversion", "Converts nsec from/to struct timespec"},
@@ -38,10 +64,15 @@ const char *testc_module[][2] = {
 	{"testc_faux_sched_once", "Schedule once event. Simple and delayed ones."},
 	{"testc_faux_sched_periodic", "Schedule periodic event."},
 	{"testc_faux_sched_infinite", "Schedule infinite number of events."},
+	{"testc_faux_sched_slack", "Coalesce events using slack."},
+	{"testc_faux_sched_pop_batch", "Pop batch of events."},
+	{"testc_faux_sched_skip", "Skip missed periods of periodic event."},
 
 	// log
 	{"testc_faux_log_facility_id", "Converts syslog facility string to id"},
 	{"testc_faux_log_facility_str", "Converts syslog facility id to string"},
+	{"testc_faux_log_async", "Asynchronous logger"},
+	{"testc_faux_log_limit", "Rate limiting and deduplication of log records"},
 
 	// vec
 	{"testc_faux_vec", "Complex test of variable length vector"},
@@ -56,7 +87,14 @@ const char *testc_module[][2] = {
 	{"testc_faux_buf_direct", "Dynamic buffer. Direct access"},
 	{"testc_faux_buf_dwrite_unlock0", "Dynamic buffer. Chunk removing"},
 	{"testc_faux_buf_mass", "Massive write and read"},
+	{"testc_faux_buf_concurrent", "Concurrent SPSC and MPSC ring buffer"},
+
+	// eloop
+	{"testc_faux_eloop_stat", "Event loop statistics"},
+	{"testc_faux_eloop_fd_mode", "Edge-triggered and one-shot fds"},
+	{"testc_faux_eloop_sched_batch", "Scheduled events batch dispatching"},
 
 	// End of list
 	{NULL, NULL}
 	};
+
@@ -138,7 +138,7 @@ void *faux_vec_add(faux_vec_t *faux_vec)
 
 	// Allocate space to hold new vector
 	new_data_len = (faux_vec_len(faux_vec) + 1) * faux_vec_item_size(faux_vec);
-	new_vector = realloc(faux_vec->data, new_data_len);
+	new_vector = faux_realloc(faux_vec->data, new_data_len);
 	assert(new_vector);
 	if (!new_vector)
 		return NULL;
@@ -177,7 +177,7 @@ ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index)
 	// It's special case when the only one item left within vector. In this
 	// case we don't need to realloc() but free() the vector.
 	if (faux_vec_len(faux_vec) == 1) {
-		free(faux_vec->data);
+		faux_free(faux_vec->data);
 		faux_vec->data = NULL;
 		faux_vec->len = 0;
 		return 0;
@@ -196,7 +196,7 @@ ssize_t faux_vec_del(faux_vec_t *faux_vec, unsigned int index)
 	// Re-allocate space to hold new vector
 	faux_vec->len--;
 	new_data_len = faux_vec_len(faux_vec) * faux_vec_item_size(faux_vec);
-	new_vector = realloc(faux_vec->data, new_data_len);
+	new_vector = faux_realloc(faux_vec->data, new_data_len);
 	assert(new_vector);
 	if (!new_vector)
 		return -1;
@@ -0,0 +1 @@
+../../faux/str/private.h
\ No newline at end of file
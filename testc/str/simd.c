@@ -0,0 +1 @@
+../../faux/str/simd.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../faux/str/strbuf.c
\ No newline at end of file
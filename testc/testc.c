@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <limits.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <dlfcn.h>
@@ -14,7 +15,15 @@
 #include <sys/uio.h>
 #include <errno.h>
 #include <sys/stat.h>
-#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#if HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
 
 #if WITH_INTERNAL_GETOPT
 #include "libc/getopt.h"
@@ -48,23 +57,141 @@
 #define SYM_TESTC_VERSION_MAJOR "testc_version_major"
 #define SYM_TESTC_VERSION_MINOR "testc_version_minor"
 #define SYM_TESTC_MODULE "testc_module"
+#define SYM_TESTC_BENCH "testc_bench"
+#define SYM_MEM_STAT_ENABLE "faux_mem_stat_enable"
+#define SYM_MEM_STAT_RESET "faux_mem_stat_reset"
+#define SYM_MEM_STAT "faux_mem_stat"
 
 #define CHUNK_SIZE 1024
 #define TEST_OUTPUT_LIMIT 1024 * CHUNK_SIZE
+// Poll interval (msec) while waiting for child that closed its output
+#define REAP_INTERVAL 50
+
+// Benchmark defaults
+#define BENCH_REPEAT 20 // Number of measured repetitions
+#define BENCH_TIME 50 // Target time of single repetition (msec)
+#define BENCH_THRESHOLD 10 // Regression threshold (percents)
+#define BENCH_MAX_ITERS 1000000000ULL
+
+// Number of hardware counters: cycles, instructions, cache misses
+#define PERF_COUNTERS 3
 
 // Command line options */
 struct opts_s {
 	bool_t debug;
 	bool_t preserve_tmp;
+	unsigned int jobs; // Max number of tests running simultaneously
+	unsigned int timeout; // Test timeout in seconds. 0 - no timeout
+	bool_t bench; // Run benchmarks instead of tests
+	unsigned int bench_repeat; // Number of benchmark repetitions
+	unsigned int bench_time; // Target time of repetition (msec)
+	int bench_cpu; // CPU to pin benchmark to. -1 - current CPU
+	unsigned int bench_threshold; // Regression threshold (percents)
+	const char *json_fn; // File to write benchmark results to
+	const char *baseline_fn; // File with baseline benchmark results
+	FILE *json; // Opened JSON file
+	bool_t json_first; // There are no records within JSON file yet
+	faux_list_t *baseline; // Baseline results
+	bool_t perf; // Gather hardware counters
+	bool_t alloc; // Gather allocation statistics
 	faux_list_t *so_list;
 };
 
 typedef struct opts_s opts_t;
 
+// Result of benchmark. It's passed from child to testc through the pipe
+typedef struct {
+	uint64_t iters; // Iterations within single repetition
+	unsigned int repeat; // Number of repetitions
+	double median; // nsec/op
+	double max; // nsec/op. Slowest repetition
+	uint64_t bytes; // bytes/op
+} bench_result_t;
+
+// Hardware counters and allocation statistics of test execution. It's passed
+// from child to testc through the pipe after benchmark result.
+typedef struct {
+	bool_t hw; // Hardware counters are valid
+	uint64_t cycles;
+	uint64_t instructions;
+	uint64_t cache_misses;
+	bool_t mem; // Allocation statistics is valid
+	faux_mem_stat_t mem_stat;
+} test_stat_t;
+
+// Allocation statistics functions of tested module
+typedef struct {
+	void (*enable)(bool_t enable);
+	void (*reset)(void);
+	void (*get)(faux_mem_stat_t *stat);
+} mem_hooks_t;
+
+// Statistics collector. Lives within child process
+typedef struct {
+	int perf_fd[PERF_COUNTERS]; // The first one is a group leader
+	const mem_hooks_t *mem;
+} stat_ctx_t;
+
+// Baseline benchmark result
+typedef struct {
+	char *name;
+	double median; // nsec/op
+} baseline_t;
+
+// Test result category for statistics
+typedef enum {
+	TEST_OK,
+	TEST_FAILED,
+	TEST_INTERRUPTED,
+	TEST_BROKEN
+} test_result_e;
+
+// State of single test execution
+struct test_s {
+	unsigned int num; // Test number within module
+	const char *name;
+	const char *desc;
+	int (*sym)(void);
+	int (*bench_sym)(faux_testc_bench_t *bench); // Benchmark function
+	int res_fd; // Pipe for benchmark result and stat. -1 if it's closed
+	bench_result_t bench; // Benchmark result
+	bool_t bench_done; // Benchmark result is received
+	const mem_hooks_t *mem_hooks; // NULL if allocations are not counted
+	test_stat_t stat; // Hardware counters and allocations
+	bool_t stat_done; // Statistics is received
+	char *tmpdir; // tmp dir for current test
+	pid_t pid; // -1 if test is not running
+	int fd; // Output pipe. -1 if it's closed
+	faux_list_t *buf_list; // Test output
+	size_t out_len; // Length of output
+	long long deadline; // msec. 0 - no timeout
+	bool_t timed_out;
+	bool_t done; // Process is finished and wstatus is valid
+	int wstatus;
+	test_result_e result;
+};
+
+typedef struct test_s test_t;
+
+static bool_t parse_num(const char *str, long int *val);
 static opts_t *opts_parse(int argc, char *argv[]);
 static void opts_free(opts_t *opts);
 static void help(int status, const char *argv0);
-static int exec_test(int (*test_sym)(void), faux_list_t **buf_list, bool_t debug);
+static bool_t exec_test(test_t *test, const test_t *tests,
+	unsigned int tests_num, opts_t *opts);
+static void run_tests(test_t *tests, unsigned int tests_num,
+	opts_t *opts);
+static int exec_bench(test_t *test, opts_t *opts, int res_fd);
+static void report_test(test_t *test, opts_t *opts);
+static void report_bench(test_t *test, opts_t *opts);
+static bool_t baseline_load(opts_t *opts);
+static bool_t perf_open(int *perf_fd);
+static void perf_close(int *perf_fd);
+static bool_t stat_init(stat_ctx_t *ctx, test_t *test, opts_t *opts);
+static void stat_start(stat_ctx_t *ctx);
+static void stat_stop(stat_ctx_t *ctx, test_stat_t *stat);
+static void stat_fini(stat_ctx_t *ctx);
+static char *stat_str(const test_stat_t *stat, uint64_t ops);
 static void print_test_output(faux_list_t *buf_list);
 
 
@@ -97,6 +224,39 @@ int main(int argc, char *argv[])
 		return -1;
 	}
 
+	// Prepare benchmark baseline and output file
+	if (opts->baseline_fn && !baseline_load(opts)) {
+		fprintf(stderr, "Error: Can't load baseline \"%s\"\n",
+			opts->baseline_fn);
+		opts_free(opts);
+		return -1;
+	}
+	if (opts->json_fn) {
+		opts->json = fopen(opts->json_fn, "w");
+		if (!opts->json) {
+			fprintf(stderr, "Error: Can't open \"%s\": %s\n",
+				opts->json_fn, strerror(errno));
+			opts_free(opts);
+			return -1;
+		}
+		fprintf(opts->json, "{\n\t\"benchmarks\": [");
+		opts->json_first = BOOL_TRUE;
+	}
+
+	// Hardware counters can be forbidden by perf_event_paranoid or can be
+	// unsupported by virtual machine
+	if (opts->perf) {
+		int perf_fd[PERF_COUNTERS];
+		if (perf_open(perf_fd)) {
+			perf_close(perf_fd);
+		} else {
+			fprintf(stderr, "Warning: "
+				"Hardware counters are not available: %s\n",
+				strerror(errno));
+			opts->perf = BOOL_FALSE;
+		}
+	}
+
 	// Main loop. Iterate through the list of shared objects
 	iter = faux_list_head(opts->so_list);
 	while ((so = faux_list_each(&iter))) {
@@ -109,6 +269,13 @@ int main(int argc, char *argv[])
 		unsigned char testc_version_minor = TESTC_VERSION_MINOR_DEFAULT;
 		unsigned char *testc_version = NULL;
 		const char *(*testc_module)[2] = NULL;
+		mem_hooks_t mem_hooks = {};
+		bool_t has_mem_hooks = BOOL_FALSE;
+
+		// Tests
+		test_t *tests = NULL;
+		unsigned int tests_num = 0;
+		unsigned int i = 0;
 
 		// Module statistics
 		unsigned int module_tests = 0;
@@ -161,12 +328,15 @@ int main(int argc, char *argv[])
 			continue;
 		}
 
-		// Get testing functions list from module
-		testc_module = dlsym(so_handle, SYM_TESTC_MODULE);
+		// Get testing functions list from module. The benchmark
+		// functions list has the same format.
+		testc_module = dlsym(so_handle,
+			opts->bench ? SYM_TESTC_BENCH : SYM_TESTC_MODULE);
 		if (!testc_module) {
 			fprintf(stderr, "Error: "
-				"Can't get test list for module \"%s\"... "
-				"Skipped\n", so);
+				"Can't get %s list for module \"%s\"... "
+				"Skipped\n", opts->bench ? "benchmark" : "test",
+				so);
 			total_broken_modules++; // Statistics
 			continue;
 		}
@@ -174,6 +344,24 @@ int main(int argc, char *argv[])
 		printf("Processing module \"%s\" v%u.%u ...\n", so,
 			testc_version_major, testc_version_minor);
 
+		// Allocation statistics is available for modules linked with
+		// faux library
+		if (opts->alloc) {
+			mem_hooks.enable = (void (*)(bool_t))dlsym(so_handle,
+				SYM_MEM_STAT_ENABLE);
+			mem_hooks.reset = (void (*)(void))dlsym(so_handle,
+				SYM_MEM_STAT_RESET);
+			mem_hooks.get = (void (*)(faux_mem_stat_t *))dlsym(
+				so_handle, SYM_MEM_STAT);
+			has_mem_hooks = mem_hooks.enable && mem_hooks.reset &&
+				mem_hooks.get;
+			if (!has_mem_hooks) {
+				fprintf(stderr, "Warning: "
+					"Module \"%s\" doesn't provide "
+					"allocation statistics\n", so);
+			}
+		}
+
 		// Create tmpdir for current shared object
 		if (!mkdtemp(testc_tmpdir)) {
 			fprintf(stderr, "Warning: "
@@ -186,117 +374,78 @@ int main(int argc, char *argv[])
 				testc_tmpdir);
 		}
 
-		// Iterate through testing functions list
-		while ((*testc_module)[0]) {
-
-			const char *test_name = NULL;
-			const char *test_desc = NULL;
-			int (*test_sym)(void);
-			int wstatus = 0; // Test's retval
-			char *result_str = NULL;
-			char *attention_str = NULL;
-			faux_list_t *buf_list = NULL;
-			char *tmpdir = NULL; // tmp dir for current test
+		// Collect testing functions list
+		tests_num = 0;
+		while (testc_module[tests_num][0])
+			tests_num++;
+		tests = faux_zmalloc((tests_num + 1) * sizeof(*tests));
+		assert(tests);
+		for (i = 0; i < tests_num; i++) {
+			test_t *test = &tests[i];
+			void *sym = NULL;
 
 			// Get name and description of testing function
-			test_name = (*testc_module)[0];
-			test_desc = (*testc_module)[1];
-			if (!test_desc) // Description can be NULL
-				test_desc = "";
-			testc_module++; // Next test
-
-			module_tests++; // Statistics
+			test->num = i + 1;
+			test->name = testc_module[i][0];
+			test->desc = testc_module[i][1];
+			if (!test->desc) // Description can be NULL
+				test->desc = "";
+			test->pid = -1;
+			test->fd = -1;
+
+			test->res_fd = -1;
+			if (has_mem_hooks)
+				test->mem_hooks = &mem_hooks;
 
 			// Get address of testing function by symbol name
-			test_sym = (int (*)(void))dlsym(so_handle, test_name);
-			if (!test_sym) {
+			sym = dlsym(so_handle, test->name);
+			test->sym = (int (*)(void))sym;
+			if (opts->bench)
+				test->bench_sym = (int (*)(faux_testc_bench_t *))sym;
+			if (!test->sym) {
 				fprintf(stderr, "Error: "
 					"Can't find symbol \"%s\"... "
-					"Skipped\n", test_name);
-				module_broken_tests++; // Statistics
+					"Skipped\n", test->name);
 				continue;
 			}
 
-			// Create tmp dir for current test and set TESTC_TMPDIR
-			tmpdir = faux_str_sprintf("%s/test%03u",
-				testc_tmpdir, module_tests);
-			if (tmpdir) {
-				if (mkdir(tmpdir, 0755) < 0) {
+			// Create tmp dir for current test
+			test->tmpdir = faux_str_sprintf("%s/test%03u",
+				testc_tmpdir, test->num);
+			if (test->tmpdir) {
+				if (mkdir(test->tmpdir, 0755) < 0) {
 					fprintf(stderr, "Warning: "
 						"Can't create temp dir \"%s\": %s\n",
-						tmpdir, strerror(errno));
+						test->tmpdir, strerror(errno));
 				}
-				setenv(FAUX_TESTC_TMPDIR_ENV, tmpdir, 1);
 			} else {
 				fprintf(stderr, "Warning: "
 					"Can't generate name for temp dir\n");
 			}
+		}
 
-			// Execute testing function
-			wstatus = exec_test(test_sym, &buf_list, opts->debug);
-
-			// Analyze testing function return code
-
-			// Normal exit
-			if (WIFEXITED(wstatus)) {
-
-				// Success
-				if (WEXITSTATUS(wstatus) == 0) {
-					result_str = faux_str_dup("OK");
-					attention_str = faux_str_dup("");
+		// Execute testing functions. Up to opts->jobs tests are
+		// running simultaneously. Reports are printed in order of tests.
+		run_tests(tests, tests_num, opts);
 
-				// Failed
-				} else {
-					result_str = faux_str_sprintf(
-						"FAIL (%d)",
-						(int)((signed char)((unsigned char)WEXITSTATUS(wstatus))));
-					attention_str = faux_str_dup("(!) ");
-					module_failed_tests++; // Statistics
-				}
-
-			// Terminated by signal
-			} else if (WIFSIGNALED(wstatus)) {
-				result_str = faux_str_sprintf("SIGNAL (%d)",
-					WTERMSIG(wstatus));
-				attention_str = faux_str_dup("[!] ");
+		// Gather module statistics
+		for (i = 0; i < tests_num; i++) {
+			module_tests++; // Statistics
+			switch (tests[i].result) {
+			case TEST_FAILED:
+				module_failed_tests++; // Statistics
+				break;
+			case TEST_INTERRUPTED:
 				module_interrupted_tests++; // Statistics
-
-			// Stopped by unknown conditions
-			} else {
-				result_str = faux_str_dup("UNKNOWN");
-				attention_str = faux_str_dup("[!] ");
+				break;
+			case TEST_BROKEN:
 				module_broken_tests++; // Statistics
+				break;
+			default:
+				break;
 			}
-
-			// Print test execution report
-			printf("%sTest #%03u %s() %s: %s\n",
-				attention_str, module_tests,
-				test_name, test_desc, result_str);
-			faux_str_free(result_str);
-			faux_str_free(attention_str);
-
-			// Print test output if error or debug
-			if (!WIFEXITED(wstatus) ||
-				WEXITSTATUS(wstatus) != 0 ||
-				opts->debug) {
-				if (opts->preserve_tmp) {
-					fprintf(stderr, "Info: "
-						"Test's temp dir is \"%s\"\n",
-						tmpdir);
-				}
-				if (faux_list_len(buf_list) > 0)
-					printf(">>>\n");
-				print_test_output(buf_list);
-				if (faux_list_len(buf_list) > 0)
-					printf("<<<\n");
-			}
-			faux_list_free(buf_list);
-
-			// Remove test's tmp dir
-			if (!opts->preserve_tmp)
-				faux_rm(tmpdir);
-			faux_str_free(tmpdir);
 		}
+		faux_free(tests);
 
 		dlclose(so_handle);
 		so_handle = NULL;
@@ -325,6 +474,11 @@ int main(int argc, char *argv[])
 
 	}
 
+	if (opts->json) {
+		fprintf(opts->json, "\n\t]\n}\n");
+		fclose(opts->json);
+		opts->json = NULL;
+	}
 	opts_free(opts);
 
 	// Report total statistics
@@ -349,6 +503,275 @@ int main(int argc, char *argv[])
 }
 
 
+/** @brief Prints test execution report
+ *
+ * Analyzes testing function return code and prints report. The test output
+ * is printed on error or in debug mode. Frees test's output and removes
+ * test's tmp dir.
+ *
+ * @param [in] test Finished test.
+ * @param [in] opts Command line options.
+ */
+static void report_test(test_t *test, opts_t *opts)
+{
+	int wstatus = test->wstatus; // Test's retval
+	char *result_str = NULL;
+	char *attention_str = NULL;
+
+	if (!test->sym) {
+		test->result = TEST_BROKEN;
+		return;
+	}
+
+	// Killed by timeout
+	if (test->timed_out) {
+		result_str = faux_str_dup("TIMEOUT");
+		attention_str = faux_str_dup("[!] ");
+		test->result = TEST_INTERRUPTED;
+
+	// Can't start test
+	} else if (!test->done) {
+		result_str = faux_str_dup("UNKNOWN");
+		attention_str = faux_str_dup("[!] ");
+		test->result = TEST_BROKEN;
+
+	// Normal exit
+	} else if (WIFEXITED(wstatus)) {
+
+		// Success
+		if (WEXITSTATUS(wstatus) == 0) {
+			result_str = faux_str_dup("OK");
+			attention_str = faux_str_dup("");
+			test->result = TEST_OK;
+
+		// Failed
+		} else {
+			result_str = faux_str_sprintf(
+				"FAIL (%d)",
+				(int)((signed char)((unsigned char)WEXITSTATUS(wstatus))));
+			attention_str = faux_str_dup("(!) ");
+			test->result = TEST_FAILED;
+		}
+
+	// Terminated by signal
+	} else if (WIFSIGNALED(wstatus)) {
+		result_str = faux_str_sprintf("SIGNAL (%d)",
+			WTERMSIG(wstatus));
+		attention_str = faux_str_dup("[!] ");
+		test->result = TEST_INTERRUPTED;
+
+	// Stopped by unknown conditions
+	} else {
+		result_str = faux_str_dup("UNKNOWN");
+		attention_str = faux_str_dup("[!] ");
+		test->result = TEST_BROKEN;
+	}
+
+	// Benchmark has its own report
+	if (test->bench_sym && (TEST_OK == test->result)) {
+		faux_str_free(result_str);
+		faux_str_free(attention_str);
+		report_bench(test, opts);
+		result_str = NULL;
+		attention_str = NULL;
+
+	// Print test execution report
+	} else {
+		char *stat = NULL;
+		if (test->stat_done && !test->bench_sym)
+			stat = stat_str(&test->stat, 0);
+		printf("%s%s #%03u %s() %s: %s%s%s%s\n",
+			attention_str, test->bench_sym ? "Bench" : "Test",
+			test->num, test->name, test->desc, result_str,
+			stat ? " [" : "", stat ? stat : "", stat ? "]" : "");
+		faux_str_free(stat);
+		faux_str_free(result_str);
+		faux_str_free(attention_str);
+	}
+
+	// Print test output if error or debug
+	if ((test->result != TEST_OK) || opts->debug) {
+		if (opts->preserve_tmp) {
+			fprintf(stderr, "Info: "
+				"Test's temp dir is \"%s\"\n",
+				test->tmpdir);
+		}
+		if (faux_list_len(test->buf_list) > 0)
+			printf(">>>\n");
+		fflush(stdout); // Output is written to descriptor directly
+		print_test_output(test->buf_list);
+		if (faux_list_len(test->buf_list) > 0)
+			printf("<<<\n");
+	}
+	// Report must be printed before output of the next tests
+	fflush(stdout);
+	faux_list_free(test->buf_list);
+	test->buf_list = NULL;
+
+	// Remove test's tmp dir
+	if (!opts->preserve_tmp)
+		faux_rm(test->tmpdir);
+	faux_str_free(test->tmpdir);
+	test->tmpdir = NULL;
+}
+
+
+/** @brief Prints benchmark report
+ *
+ * Compares result with baseline and writes it to JSON file if needed. The
+ * regression is considered as failure.
+ *
+ * @param [in] test Finished benchmark.
+ * @param [in] opts Command line options.
+ */
+static void report_bench(test_t *test, opts_t *opts)
+{
+	const bench_result_t *r = &test->bench;
+	const char *attention_str = "";
+	char *result_str = NULL;
+	char *cmp_str = NULL;
+	faux_list_node_t *iter = NULL;
+	baseline_t *base = NULL;
+
+	if (!test->bench_done) {
+		printf("[!] Bench #%03u %s() %s: NO RESULT\n",
+			test->num, test->name, test->desc);
+		test->result = TEST_BROKEN;
+		return;
+	}
+
+	result_str = faux_str_sprintf("%.1f ns/op, max %.1f ns/op",
+		r->median, r->max);
+	if (r->bytes > 0) {
+		// bytes/nsec * 1000 is equal to MB/s (10^6 bytes)
+		char *bytes_str = faux_str_sprintf(", %llu B/op, %.1f MB/s",
+			(unsigned long long)r->bytes,
+			(r->median > 0) ? r->bytes * 1000.0 / r->median : 0.0);
+		faux_str_cat(&result_str, bytes_str);
+		faux_str_free(bytes_str);
+	}
+	if (test->stat_done) {
+		char *stat = stat_str(&test->stat, r->iters);
+		if (stat) {
+			faux_str_cat(&result_str, ", ");
+			faux_str_cat(&result_str, stat);
+			faux_str_free(stat);
+		}
+	}
+
+	// Compare with baseline
+	if (opts->baseline)
+		iter = faux_list_head(opts->baseline);
+	while (iter && (base = faux_list_each(&iter))) {
+		double diff = 0;
+		if (strcmp(base->name, test->name) != 0)
+			continue;
+		if (base->median <= 0)
+			break;
+		diff = (r->median - base->median) * 100.0 / base->median;
+		if (diff > opts->bench_threshold) {
+			attention_str = "(!) ";
+			test->result = TEST_FAILED;
+			cmp_str = faux_str_sprintf(": REGRESSION %+.1f%% "
+				"(baseline %.1f ns/op)", diff, base->median);
+		} else {
+			cmp_str = faux_str_sprintf(" (%+.1f%%)", diff);
+		}
+		break;
+	}
+
+	printf("%sBench #%03u %s() %s: %s, %llu iters x %u%s\n",
+		attention_str, test->num, test->name, test->desc, result_str,
+		(unsigned long long)r->iters, r->repeat, cmp_str ? cmp_str : "");
+	faux_str_free(result_str);
+	faux_str_free(cmp_str);
+
+	// Machine-readable results. Single record per line.
+	if (opts->json) {
+		fprintf(opts->json, "%s\n\t\t{\"name\": \"%s\", "
+			"\"iters\": %llu, \"repeat\": %u, "
+			"\"median_ns\": %.3f, \"max_ns\": %.3f, "
+			"\"bytes_per_op\": %llu",
+			opts->json_first ? "" : ",", test->name,
+			(unsigned long long)r->iters, r->repeat,
+			r->median, r->max, (unsigned long long)r->bytes);
+		if (test->stat_done && test->stat.hw) {
+			fprintf(opts->json, ", \"cycles_per_op\": %.3f, "
+				"\"instructions_per_op\": %.3f, "
+				"\"cache_misses_per_op\": %.3f",
+				(double)test->stat.cycles / r->iters,
+				(double)test->stat.instructions / r->iters,
+				(double)test->stat.cache_misses / r->iters);
+		}
+		if (test->stat_done && test->stat.mem) {
+			fprintf(opts->json, ", \"allocs_per_op\": %.3f, "
+				"\"alloc_bytes_per_op\": %.3f, "
+				"\"reallocs_per_op\": %.3f",
+				(double)test->stat.mem_stat.malloc_num / r->iters,
+				(double)test->stat.mem_stat.malloc_bytes / r->iters,
+				(double)test->stat.mem_stat.realloc_num / r->iters);
+		}
+		fprintf(opts->json, "}");
+		opts->json_first = BOOL_FALSE;
+	}
+}
+
+
+/** @brief Frees baseline record
+ */
+static void baseline_free(void *data)
+{
+	baseline_t *base = (baseline_t *)data;
+
+	faux_str_free(base->name);
+	faux_free(base);
+}
+
+
+/** @brief Loads baseline benchmark results
+ *
+ * The baseline file is a JSON file generated by testc itself. The parser
+ * is simple. It expects single benchmark record per line.
+ *
+ * @param [in] opts Command line options.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t baseline_load(opts_t *opts)
+{
+	FILE *f = NULL;
+	char line[1024];
+	const char *name_key = "\"name\": \"";
+	const char *median_key = "\"median_ns\": ";
+
+	f = fopen(opts->baseline_fn, "r");
+	if (!f)
+		return BOOL_FALSE;
+	opts->baseline = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, baseline_free);
+
+	while (fgets(line, sizeof(line), f)) {
+		char *name = strstr(line, name_key);
+		char *median = strstr(line, median_key);
+		char *end = NULL;
+		baseline_t *base = NULL;
+		if (!name || !median)
+			continue;
+		name += strlen(name_key);
+		end = strchr(name, '"');
+		if (!end)
+			continue;
+		base = faux_zmalloc(sizeof(*base));
+		assert(base);
+		base->name = faux_str_dupn(name, end - name);
+		base->median = strtod(median + strlen(median_key), NULL);
+		faux_list_add(opts->baseline, base);
+	}
+	fclose(f);
+
+	return BOOL_TRUE;
+}
+
+
 static void free_iov(struct iovec *iov)
 {
 	faux_free(iov->iov_base);
@@ -356,40 +779,48 @@ static void free_iov(struct iovec *iov)
 }
 
 
-static faux_list_t *read_test_output(int fd, size_t limit)
+/** @brief Reads available chunk of test output
+ *
+ * Reads single chunk from test's output pipe and adds it to the test's
+ * buffer list. The pipe is closed on EOF, error or when output length limit
+ * is exceeded.
+ *
+ * @param [in] test Running test.
+ * @param [in] limit Max length of test output.
+ */
+static void read_test_output(test_t *test, size_t limit)
 {
 	struct iovec *iov = NULL;
-	size_t total_len = 0;
-	faux_list_t *buf_list = NULL; // Buffer list
+	ssize_t bytes_readed = 0;
 
-	buf_list = faux_list_new(
-		FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
-		NULL, NULL, (void (*)(void *))free_iov);
+	iov = faux_zmalloc(sizeof(*iov));
+	assert(iov);
+	iov->iov_len = CHUNK_SIZE;
+	iov->iov_base = faux_malloc(iov->iov_len);
+	assert(iov->iov_base);
 
 	do {
-		ssize_t bytes_readed = 0;
-
-		iov = faux_zmalloc(sizeof(*iov));
-		assert(iov);
-		iov->iov_len = CHUNK_SIZE;
-		iov->iov_base = faux_malloc(iov->iov_len);
-		assert(iov->iov_base);
-
-		do {
-			bytes_readed = readv(fd, iov, 1);
-		} while ((bytes_readed < 0) && (errno == EINTR));
-		if (bytes_readed <= 0) { /* Error or EOF */
-			free_iov(iov);
-			break;
-		}
+		bytes_readed = readv(test->fd, iov, 1);
+	} while ((bytes_readed < 0) && (errno == EINTR));
+	if (bytes_readed <= 0) { /* Error or EOF */
+		free_iov(iov);
+		close(test->fd);
+		test->fd = -1;
+		return;
+	}
 
-		iov->iov_len = bytes_readed;
-		faux_list_add(buf_list, iov);
-		total_len += iov->iov_len;
-//write(1, iov->iov_base, iov->iov_len);
-	} while (total_len < limit);
+	iov->iov_len = bytes_readed;
+	faux_list_add(test->buf_list, iov);
+	test->out_len += iov->iov_len;
 
-	return buf_list;
+	// The pipe closing can lead to test interruption when output length
+	// limit is exceeded. But it's ok because it saves us from iternal
+	// loops. It doesn't saves from silent iternal loops. The timeout
+	// does.
+	if (test->out_len >= limit) {
+		close(test->fd);
+		test->fd = -1;
+	}
 }
 
 
@@ -404,53 +835,623 @@ static void print_test_output(faux_list_t *buf_list)
 	}
 }
 
+
+/** @brief Gets current monotonic time in msec
+ */
+static long long now_msec(void)
+{
+	struct timespec ts = {};
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+
 /** Executes testing function
  *
- * Function fork() and executes testing function.
+ * Function fork() and executes testing function. It doesn't wait for
+ * test finishing. The test's output is available through test->fd.
  *
- * @param [in] test_sym Testing function.
- * @param [in] buf_list
- * @return Testing function return value
+ * @param [in] test Test to execute.
+ * @param [in] tests Array of all tests. Used to find pipes of running tests.
+ * @param [in] tests_num Number of tests.
+ * @param [in] opts Command line options.
+ * @return BOOL_TRUE - test is started, BOOL_FALSE on error.
  */
-static int exec_test(int (*test_sym)(void), faux_list_t **buf_list, bool_t debug)
+static bool_t exec_test(test_t *test, const test_t *tests,
+	unsigned int tests_num, opts_t *opts)
 {
 	pid_t pid = -1;
-	int wstatus = -1;
 	int pipefd[2];
-	faux_list_t *blist = NULL;
+	int respipe[2] = {-1, -1};
+	bool_t has_res = BOOL_FALSE; // Child writes results to pipe
+	int res = 0;
 
+	test->buf_list = faux_list_new(
+		FAUX_LIST_UNSORTED, FAUX_LIST_NONUNIQUE,
+		NULL, NULL, (void (*)(void *))free_iov);
 	if (pipe(pipefd))
-		return -1;
+		return BOOL_FALSE;
+	has_res = test->bench_sym || opts->perf || test->mem_hooks;
+	if (has_res && pipe(respipe)) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+		return BOOL_FALSE;
+	}
+
+	// Set TESTC_TMPDIR for child
+	if (test->tmpdir)
+		setenv(FAUX_TESTC_TMPDIR_ENV, test->tmpdir, 1);
+
+	// Child must not inherit unflushed stdio buffers
+	fflush(stdout);
+	fflush(stderr);
 
 	pid = fork();
 	assert(pid != -1);
-	if (pid == -1)
-		return -1;
+	if (pid == -1) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+		if (has_res) {
+			close(respipe[0]);
+			close(respipe[1]);
+		}
+		return BOOL_FALSE;
+	}
 
 	// Child
 	if (pid == 0) {
+		unsigned int i = 0;
+		// Don't hold read ends of other running tests' pipes
+		for (i = 0; i < tests_num; i++) {
+			if (tests[i].fd != -1)
+				close(tests[i].fd);
+			if (tests[i].res_fd != -1)
+				close(tests[i].res_fd);
+		}
 		dup2(pipefd[1], 1);
 		dup2(pipefd[1], 2);
 		close(pipefd[0]);
 		close(pipefd[1]);
-		_exit(test_sym());
+		if (has_res)
+			close(respipe[0]);
+		if (test->bench_sym) {
+			res = exec_bench(test, opts, respipe[1]);
+		} else if (has_res) {
+			stat_ctx_t ctx = {};
+			test_stat_t stat = {};
+			stat_init(&ctx, test, opts);
+			stat_start(&ctx);
+			res = test->sym();
+			stat_stop(&ctx, &stat);
+			stat_fini(&ctx);
+			faux_write_block(respipe[1], &stat, sizeof(stat));
+			close(respipe[1]);
+		} else {
+			res = test->sym();
+		}
+		// The _exit() doesn't flush buffered stdio output
+		fflush(stdout);
+		fflush(stderr);
+		_exit(res);
 	}
 
 	// Parent
 	close(pipefd[1]);
-	if (debug)
+	if (has_res) {
+		close(respipe[1]);
+		test->res_fd = respipe[0];
+	}
+	if (opts->debug)
 		fprintf(stderr, "Debug: Process ID is %d\n", pid);
-	blist = read_test_output(pipefd[0], TEST_OUTPUT_LIMIT);
-	// The pipe closing can lead to test interruption when output length
-	// limit is exceeded. But it's ok because it saves us from iternal
-	// loops. It doesn't saves from silent iternal loops.
-	close(pipefd[0]);
-	if (blist)
-		*buf_list = blist;
+	test->pid = pid;
+	test->fd = pipefd[0];
+	if (opts->timeout > 0)
+		test->deadline = now_msec() + opts->timeout * 1000LL;
+
+	return BOOL_TRUE;
+}
 
-	while (waitpid(pid, &wstatus, 0) != pid);
 
-	return wstatus;
+/** @brief Executes list of tests
+ *
+ * Up to opts->jobs tests are running simultaneously. The outputs of running
+ * tests are multiplexed by poll(). The hung tests are killed by timeout.
+ * The reports are printed in the order of tests as soon as all preceding
+ * tests are finished. So the report doesn't depend on number of jobs.
+ *
+ * @param [in] tests Array of tests.
+ * @param [in] tests_num Number of tests.
+ * @param [in] opts Command line options.
+ */
+static void run_tests(test_t *tests, unsigned int tests_num,
+	opts_t *opts)
+{
+	struct pollfd *fds = NULL;
+	test_t **fds_tests = NULL;
+	unsigned int next_start = 0; // Next test to start
+	unsigned int next_report = 0; // Next test to report
+	unsigned int running = 0;
+	unsigned int jobs = opts->jobs ? opts->jobs : 1;
+
+	// Benchmarks must not disturb each other
+	if (opts->bench)
+		jobs = 1;
+
+	fds = faux_zmalloc(jobs * sizeof(*fds));
+	fds_tests = faux_zmalloc(jobs * sizeof(*fds_tests));
+	assert(fds);
+	assert(fds_tests);
+
+	while (next_report < tests_num) {
+		unsigned int nfds = 0;
+		unsigned int i = 0;
+		bool_t reap = BOOL_FALSE;
+		long long now = 0;
+		int timeout = -1;
+
+		// Start new tests
+		while ((running < jobs) && (next_start < tests_num)) {
+			test_t *test = &tests[next_start++];
+			if (!test->sym) // Broken test
+				continue;
+			if (exec_test(test, tests, tests_num, opts))
+				running++;
+		}
+
+		// Report finished tests in order
+		while ((next_report < tests_num) &&
+			(tests[next_report].pid == -1) &&
+			(next_report < next_start)) {
+			report_test(&tests[next_report], opts);
+			next_report++;
+		}
+		if (0 == running)
+			continue;
+
+		// Gather output pipes and timeouts of running tests
+		now = now_msec();
+		for (i = next_report; i < next_start; i++) {
+			test_t *test = &tests[i];
+			if (-1 == test->pid)
+				continue;
+			if (test->deadline > 0) {
+				long long left = test->deadline - now;
+				if (left < 0)
+					left = 0;
+				if ((timeout < 0) || (left < timeout))
+					timeout = left;
+			}
+			if (-1 == test->fd) {
+				reap = BOOL_TRUE;
+				continue;
+			}
+			fds[nfds].fd = test->fd;
+			fds[nfds].events = POLLIN;
+			fds[nfds].revents = 0;
+			fds_tests[nfds] = test;
+			nfds++;
+		}
+		// Child that closed its output can be still running
+		if (reap && ((timeout < 0) || (timeout > REAP_INTERVAL)))
+			timeout = REAP_INTERVAL;
+
+		// Wait for output
+		if (poll(fds, nfds, timeout) > 0) {
+			for (i = 0; i < nfds; i++) {
+				if (fds[i].revents != 0)
+					read_test_output(fds_tests[i],
+						TEST_OUTPUT_LIMIT);
+			}
+		}
+
+		// Kill hung tests and reap finished ones
+		now = now_msec();
+		for (i = next_report; i < next_start; i++) {
+			test_t *test = &tests[i];
+			pid_t res = 0;
+			if (-1 == test->pid)
+				continue;
+			if ((test->deadline > 0) && (now >= test->deadline) &&
+				!test->timed_out) {
+				kill(test->pid, SIGKILL);
+				test->timed_out = BOOL_TRUE;
+			}
+			// Don't wait for test while its output is not read
+			if ((test->fd != -1) && !test->timed_out)
+				continue;
+			res = waitpid(test->pid, &test->wstatus,
+				test->timed_out ? 0 : WNOHANG);
+			if (res != test->pid)
+				continue;
+			if (test->fd != -1) {
+				close(test->fd);
+				test->fd = -1;
+			}
+			if (test->res_fd != -1) {
+				if (test->bench_sym) {
+					test->bench_done = (faux_read_block(
+						test->res_fd, &test->bench,
+						sizeof(test->bench)) ==
+						sizeof(test->bench));
+				}
+				test->stat_done = (faux_read_block(test->res_fd,
+					&test->stat, sizeof(test->stat)) ==
+					sizeof(test->stat));
+				close(test->res_fd);
+				test->res_fd = -1;
+			}
+			test->pid = -1;
+			test->done = BOOL_TRUE;
+			running--;
+		}
+	}
+
+	faux_free(fds);
+	faux_free(fds_tests);
+}
+
+
+/** @brief Compares two doubles for qsort()
+ */
+static int cmp_double(const void *first, const void *second)
+{
+	double a = *(const double *)first;
+	double b = *(const double *)second;
+
+	return (a > b) - (a < b);
+}
+
+
+/** @brief Executes benchmark function once
+ *
+ * @param [in] test Benchmark.
+ * @param [in,out] bench Benchmark state.
+ * @param [in] iters Number of iterations.
+ * @return Benchmark function return value.
+ */
+static int run_bench_once(test_t *test, faux_testc_bench_t *bench,
+	uint64_t iters)
+{
+	int res = 0;
+
+	bench->iters = iters;
+	bench->elapsed = 0;
+	bench->running = BOOL_FALSE;
+	faux_testc_bench_start(bench);
+	res = test->bench_sym(bench);
+	faux_testc_bench_stop(bench);
+
+	return res;
+}
+
+
+/** @brief Executes benchmark within child process
+ *
+ * Pins process to CPU, calibrates the number of iterations to get
+ * repetition long enough, executes warmup repetition and then measured
+ * repetitions. The result is written to res_fd.
+ *
+ * @param [in] test Benchmark.
+ * @param [in] opts Command line options.
+ * @param [in] res_fd File descriptor to write result to.
+ * @return Benchmark function return value.
+ */
+static int exec_bench(test_t *test, opts_t *opts, int res_fd)
+{
+	faux_testc_bench_t bench = {};
+	bench_result_t result = {};
+	test_stat_t stat = {};
+	stat_ctx_t ctx = {};
+	uint64_t target = opts->bench_time * 1000000ULL; // nsec
+	uint64_t iters = 1;
+	double *samples = NULL;
+	unsigned int i = 0;
+	int res = 0;
+#ifdef CPU_SET
+	cpu_set_t cpus;
+	int cpu = opts->bench_cpu;
+
+	if (cpu < 0)
+		cpu = sched_getcpu();
+	if (cpu >= 0) {
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+		if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0)
+			fprintf(stderr, "Warning: Can't pin to CPU %d\n", cpu);
+	}
+#endif
+
+	// Calibration. It's a warmup too
+	for (;;) {
+		uint64_t next = 0;
+		res = run_bench_once(test, &bench, iters);
+		if (res != 0)
+			return res;
+		if ((bench.elapsed >= target) || (iters >= BENCH_MAX_ITERS))
+			break;
+		// Predict iterations with 20% reserve but not too fast
+		if (bench.elapsed > 0)
+			next = (double)iters * target * 1.2 / bench.elapsed;
+		if ((0 == next) || (next > iters * 100))
+			next = iters * 100;
+		if (next <= iters)
+			next = iters + 1;
+		if (next > BENCH_MAX_ITERS)
+			next = BENCH_MAX_ITERS;
+		iters = next;
+	}
+
+	// Measured repetitions
+	samples = faux_zmalloc(opts->bench_repeat * sizeof(*samples));
+	assert(samples);
+	for (i = 0; i < opts->bench_repeat; i++) {
+		res = run_bench_once(test, &bench, iters);
+		if (res != 0) {
+			faux_free(samples);
+			return res;
+		}
+		samples[i] = (double)bench.elapsed / iters;
+	}
+	qsort(samples, opts->bench_repeat, sizeof(*samples), cmp_double);
+
+	result.iters = iters;
+	result.repeat = opts->bench_repeat;
+	result.median = (opts->bench_repeat % 2) ?
+		samples[opts->bench_repeat / 2] :
+		(samples[opts->bench_repeat / 2 - 1] +
+		samples[opts->bench_repeat / 2]) / 2;
+	// The percentiles have no meaning for a few repetitions. So the
+	// slowest repetition is reported
+	result.max = samples[opts->bench_repeat - 1];
+	result.bytes = bench.bytes;
+	faux_free(samples);
+
+	// Hardware counters and allocations. The repetition without
+	// iterations is subtracted to exclude benchmark's setup code.
+	if (stat_init(&ctx, test, opts)) {
+		test_stat_t setup = {};
+		stat_start(&ctx);
+		res = run_bench_once(test, &bench, iters);
+		stat_stop(&ctx, &stat);
+		stat_start(&ctx);
+		if (0 == res)
+			res = run_bench_once(test, &bench, 0);
+		stat_stop(&ctx, &setup);
+		stat_fini(&ctx);
+		if (res != 0)
+			return res;
+#define STAT_SUB(field) stat.field = \
+	(stat.field > setup.field) ? (stat.field - setup.field) : 0
+		STAT_SUB(cycles);
+		STAT_SUB(instructions);
+		STAT_SUB(cache_misses);
+		STAT_SUB(mem_stat.malloc_num);
+		STAT_SUB(mem_stat.malloc_bytes);
+		STAT_SUB(mem_stat.realloc_num);
+		STAT_SUB(mem_stat.free_num);
+#undef STAT_SUB
+		stat.hw = stat.hw && setup.hw;
+	}
+
+	faux_write_block(res_fd, &result, sizeof(result));
+	faux_write_block(res_fd, &stat, sizeof(stat));
+	close(res_fd);
+
+	return 0;
+}
+
+
+/** @brief Opens group of hardware counters for current thread
+ *
+ * The counters are user-space only because kernel counting is forbidden
+ * with default perf_event_paranoid. The group is opened disabled.
+ *
+ * @param [out] perf_fd Array of PERF_COUNTERS file descriptors.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t perf_open(int *perf_fd)
+{
+#if HAVE_LINUX_PERF_EVENT_H
+	const uint64_t config[PERF_COUNTERS] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES
+		};
+	unsigned int i = 0;
+
+	for (i = 0; i < PERF_COUNTERS; i++)
+		perf_fd[i] = -1;
+
+	for (i = 0; i < PERF_COUNTERS; i++) {
+		struct perf_event_attr attr = {};
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config[i];
+		attr.disabled = (0 == i); // Leader controls the group
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP |
+			PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING;
+		perf_fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1,
+			perf_fd[0], 0);
+		if (perf_fd[i] < 0) {
+			int saved_errno = errno;
+			perf_close(perf_fd);
+			errno = saved_errno;
+			return BOOL_FALSE;
+		}
+	}
+
+	return BOOL_TRUE;
+#else
+	unsigned int i = 0;
+
+	for (i = 0; i < PERF_COUNTERS; i++)
+		perf_fd[i] = -1;
+	errno = ENOSYS;
+
+	return BOOL_FALSE;
+#endif
+}
+
+
+/** @brief Closes group of hardware counters
+ *
+ * @param [in] perf_fd Array of PERF_COUNTERS file descriptors.
+ */
+static void perf_close(int *perf_fd)
+{
+	unsigned int i = 0;
+
+	// Leader must be closed last
+	for (i = PERF_COUNTERS; i > 0; i--) {
+		if (perf_fd[i - 1] < 0)
+			continue;
+		close(perf_fd[i - 1]);
+		perf_fd[i - 1] = -1;
+	}
+}
+
+
+/** @brief Prepares statistics collector within child process
+ *
+ * @param [out] ctx Statistics collector.
+ * @param [in] test Test.
+ * @param [in] opts Command line options.
+ * @return BOOL_TRUE if any statistics will be collected.
+ */
+static bool_t stat_init(stat_ctx_t *ctx, test_t *test, opts_t *opts)
+{
+	unsigned int i = 0;
+
+	for (i = 0; i < PERF_COUNTERS; i++)
+		ctx->perf_fd[i] = -1;
+	ctx->mem = test->mem_hooks;
+	if (opts->perf)
+		perf_open(ctx->perf_fd);
+
+	return (ctx->perf_fd[0] != -1) || ctx->mem;
+}
+
+
+/** @brief Starts statistics collection
+ *
+ * The hardware counters are started last to don't count the allocation
+ * statistics functions.
+ */
+static void stat_start(stat_ctx_t *ctx)
+{
+	if (ctx->mem) {
+		ctx->mem->reset();
+		ctx->mem->enable(BOOL_TRUE);
+	}
+#if HAVE_LINUX_PERF_EVENT_H
+	if (ctx->perf_fd[0] != -1) {
+		ioctl(ctx->perf_fd[0], PERF_EVENT_IOC_RESET,
+			PERF_IOC_FLAG_GROUP);
+		ioctl(ctx->perf_fd[0], PERF_EVENT_IOC_ENABLE,
+			PERF_IOC_FLAG_GROUP);
+	}
+#endif
+}
+
+
+/** @brief Stops statistics collection and gets the results
+ *
+ * The counters are scaled if kernel multiplexed them.
+ *
+ * @param [in] ctx Statistics collector.
+ * @param [out] stat Gathered statistics.
+ */
+static void stat_stop(stat_ctx_t *ctx, test_stat_t *stat)
+{
+#if HAVE_LINUX_PERF_EVENT_H
+	if (ctx->perf_fd[0] != -1) {
+		// nr, time_enabled, time_running, values
+		uint64_t data[3 + PERF_COUNTERS] = {};
+		ioctl(ctx->perf_fd[0], PERF_EVENT_IOC_DISABLE,
+			PERF_IOC_FLAG_GROUP);
+		if ((faux_read(ctx->perf_fd[0], data, sizeof(data)) ==
+			sizeof(data)) && (PERF_COUNTERS == data[0]) &&
+			(data[2] > 0)) {
+			double scale = (double)data[1] / data[2];
+			stat->cycles = data[3] * scale;
+			stat->instructions = data[4] * scale;
+			stat->cache_misses = data[5] * scale;
+			stat->hw = BOOL_TRUE;
+		}
+	}
+#endif
+	if (ctx->mem) {
+		ctx->mem->enable(BOOL_FALSE);
+		ctx->mem->get(&stat->mem_stat);
+		stat->mem = BOOL_TRUE;
+	}
+}
+
+
+/** @brief Frees statistics collector resources
+ */
+static void stat_fini(stat_ctx_t *ctx)
+{
+	perf_close(ctx->perf_fd);
+}
+
+
+/** @brief Formats statistics for report
+ *
+ * @param [in] stat Statistics.
+ * @param [in] ops Number of operations to divide counters by. The '0' means
+ * total values.
+ * @return Allocated string or NULL if there is no valid statistics.
+ */
+static char *stat_str(const test_stat_t *stat, uint64_t ops)
+{
+	char *str = NULL;
+	char *part = NULL;
+
+	if (stat->hw && (0 == ops)) {
+		part = faux_str_sprintf("%llu cycles, %llu instructions, "
+			"%llu cache-misses",
+			(unsigned long long)stat->cycles,
+			(unsigned long long)stat->instructions,
+			(unsigned long long)stat->cache_misses);
+	} else if (stat->hw) {
+		part = faux_str_sprintf("%.1f cycles/op, %.1f instr/op, "
+			"%.2f misses/op",
+			(double)stat->cycles / ops,
+			(double)stat->instructions / ops,
+			(double)stat->cache_misses / ops);
+	}
+	if (part) {
+		faux_str_cat(&str, part);
+		faux_str_free(part);
+		part = NULL;
+	}
+
+	if (stat->mem && (0 == ops)) {
+		part = faux_str_sprintf(
+			"%llu allocs (%llu B), %llu reallocs, %llu frees",
+			stat->mem_stat.malloc_num, stat->mem_stat.malloc_bytes,
+			stat->mem_stat.realloc_num, stat->mem_stat.free_num);
+	} else if (stat->mem) {
+		part = faux_str_sprintf(
+			"%.2f allocs/op (%.1f B/op), %.2f reallocs/op",
+			(double)stat->mem_stat.malloc_num / ops,
+			(double)stat->mem_stat.malloc_bytes / ops,
+			(double)stat->mem_stat.realloc_num / ops);
+	}
+	if (part) {
+		if (str)
+			faux_str_cat(&str, ", ");
+		faux_str_cat(&str, part);
+		faux_str_free(part);
+	}
+
+	return str;
 }
 
 
@@ -465,6 +1466,9 @@ static void opts_free(opts_t *opts)
 		return;
 
 	faux_list_free(opts->so_list);
+	faux_list_free(opts->baseline);
+	if (opts->json)
+		fclose(opts->json);
 	faux_free(opts);
 }
 
@@ -487,6 +1491,19 @@ static opts_t *opts_new(void)
 
 	opts->debug = BOOL_FALSE;
 	opts->preserve_tmp = BOOL_FALSE;
+	opts->jobs = 1;
+	opts->timeout = 0;
+	opts->bench = BOOL_FALSE;
+	opts->bench_repeat = BENCH_REPEAT;
+	opts->bench_time = BENCH_TIME;
+	opts->bench_cpu = -1;
+	opts->bench_threshold = BENCH_THRESHOLD;
+	opts->json_fn = NULL;
+	opts->baseline_fn = NULL;
+	opts->json = NULL;
+	opts->baseline = NULL;
+	opts->perf = BOOL_FALSE;
+	opts->alloc = BOOL_FALSE;
 
 	// Members of list are static strings from argv so don't free() it
 	opts->so_list = faux_list_new(FAUX_LIST_UNSORTED, FAUX_LIST_UNIQUE,
@@ -500,6 +1517,33 @@ static opts_t *opts_new(void)
 }
 
 
+/** @brief Parses numeric option argument
+ *
+ * The whole string must be a decimal number within int range.
+ *
+ * @param [in] str String to parse.
+ * @param [out] val Parsed value.
+ * @return BOOL_TRUE - success, BOOL_FALSE on error.
+ */
+static bool_t parse_num(const char *str, long int *val)
+{
+	char *endptr = NULL;
+	long int res = 0;
+
+	if (!str || ('\0' == *str))
+		return BOOL_FALSE;
+	errno = 0;
+	res = strtol(str, &endptr, 10);
+	if ((errno != 0) || (*endptr != '\0'))
+		return BOOL_FALSE;
+	if ((res > INT_MAX) || (res < INT_MIN))
+		return BOOL_FALSE;
+	*val = res;
+
+	return BOOL_TRUE;
+}
+
+
 /** @brief Parse command line options
  *
  * Function allocates opts_t structure, parses command line options and
@@ -514,13 +1558,24 @@ static opts_t *opts_parse(int argc, char *argv[])
 {
 	opts_t *opts = NULL;
 
-	static const char *shortopts = "hvdt";
+	static const char *shortopts = "hvdtj:T:br:m:c:J:B:R:PA";
 #ifdef HAVE_GETOPT_LONG
 	static const struct option longopts[] = {
 		{"help",		0, NULL, 'h'},
 		{"version",		0, NULL, 'v'},
 		{"debug",		0, NULL, 'd'},
 		{"preserve-tmp",	0, NULL, 't'},
+		{"jobs",		1, NULL, 'j'},
+		{"timeout",		1, NULL, 'T'},
+		{"bench",		0, NULL, 'b'},
+		{"repeat",		1, NULL, 'r'},
+		{"bench-time",		1, NULL, 'm'},
+		{"cpu",			1, NULL, 'c'},
+		{"json",		1, NULL, 'J'},
+		{"baseline",		1, NULL, 'B'},
+		{"threshold",		1, NULL, 'R'},
+		{"perf",		0, NULL, 'P'},
+		{"alloc",		0, NULL, 'A'},
 		{NULL,			0, NULL, 0}
 	};
 #endif
@@ -546,6 +1601,64 @@ static opts_t *opts_parse(int argc, char *argv[])
 		case 't':
 			opts->preserve_tmp = BOOL_TRUE;
 			break;
+		case 'j': {
+			long int val = 0;
+			if (!parse_num(optarg, &val) || (val <= 0)) {
+				help(-1, argv[0]);
+				exit(-1);
+			}
+			opts->jobs = val;
+			break;
+		}
+		case 'T': {
+			long int val = 0;
+			if (!parse_num(optarg, &val) || (val < 0)) {
+				help(-1, argv[0]);
+				exit(-1);
+			}
+			opts->timeout = val;
+			break;
+		}
+		case 'b':
+			opts->bench = BOOL_TRUE;
+			break;
+		case 'r':
+		case 'm':
+		case 'R': {
+			long int val = 0;
+			if (!parse_num(optarg, &val) || (val <= 0)) {
+				help(-1, argv[0]);
+				exit(-1);
+			}
+			if ('r' == opt)
+				opts->bench_repeat = val;
+			else if ('m' == opt)
+				opts->bench_time = val;
+			else
+				opts->bench_threshold = val;
+			break;
+		}
+		case 'c': {
+			long int val = 0;
+			if (!parse_num(optarg, &val) || (val < 0)) {
+				help(-1, argv[0]);
+				exit(-1);
+			}
+			opts->bench_cpu = val;
+			break;
+		}
+		case 'J':
+			opts->json_fn = optarg;
+			break;
+		case 'B':
+			opts->baseline_fn = optarg;
+			break;
+		case 'P':
+			opts->perf = BOOL_TRUE;
+			break;
+		case 'A':
+			opts->alloc = BOOL_TRUE;
+			break;
 		case 'h':
 			help(0, argv[0]);
 			exit(0);
@@ -606,5 +1719,26 @@ static void help(int status, const char *argv0)
 		printf("\t-h, --help\tPrint this help.\n");
 		printf("\t-d, --debug\tDebug mode. Show output for all tests.\n");
 		printf("\t-t, --preserve-tmp\tPreserve test's tmp files.\n");
+		printf("\t-j <num>, --jobs=<num>\tRun up to <num> tests "
+			"simultaneously.\n");
+		printf("\t-T <sec>, --timeout=<sec>\tKill test running longer "
+			"than <sec> seconds.\n");
+		printf("\t-b, --bench\tRun benchmarks instead of tests.\n");
+		printf("\t-r <num>, --repeat=<num>\tNumber of benchmark "
+			"repetitions (default %u).\n", BENCH_REPEAT);
+		printf("\t-m <msec>, --bench-time=<msec>\tTarget time of "
+			"benchmark repetition (default %u).\n", BENCH_TIME);
+		printf("\t-c <cpu>, --cpu=<cpu>\tPin benchmark to CPU "
+			"(default is current one).\n");
+		printf("\t-J <file>, --json=<file>\tWrite benchmark results "
+			"to JSON file.\n");
+		printf("\t-B <file>, --baseline=<file>\tCompare benchmark "
+			"results with baseline JSON file.\n");
+		printf("\t-R <percent>, --threshold=<percent>\tRegression "
+			"threshold (default %u).\n", BENCH_THRESHOLD);
+		printf("\t-P, --perf\tGather hardware counters "
+			"(cycles, instructions, cache misses).\n");
+		printf("\t-A, --alloc\tCount faux_malloc() and faux_free() "
+			"calls.\n");
 	}
 }
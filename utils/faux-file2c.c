@@ -83,15 +83,29 @@ int main(int argc, char *argv[])
 	iter = faux_list_head(opts->file_list);
 	while ((fn = faux_list_each(&iter))) {
 		faux_file_t *f = NULL;
+		faux_file_map_t *map = NULL;
 		char *buf = NULL;
 		char *var_name = NULL;
 
 		file_num++;
-		f = faux_file_open(fn, O_RDONLY, 0);
-		if (!f) {
-			fprintf(stderr, "Error: Can't open file \"%s\"\n", fn);
-			total_errors++;
-			continue;
+		// Binary file is mapped instead of reading. So big file is not
+		// copied to the heap. Text file is read line by line.
+		if (opts->binary) {
+			map = faux_file_map(fn);
+			if (!map) {
+				fprintf(stderr, "Error: Can't read "
+					"file \"%s\"\n", fn);
+				total_errors++;
+				continue;
+			}
+		} else {
+			f = faux_file_open(fn, O_RDONLY, 0);
+			if (!f) {
+				fprintf(stderr, "Error: Can't open "
+					"file \"%s\"\n", fn);
+				total_errors++;
+				continue;
+			}
 		}
 		printf("\n");
 		printf("// File \"%s\"\n", fn);
@@ -100,38 +114,25 @@ int main(int argc, char *argv[])
 
 		// Binary mode
 		if (opts->binary) {
-			ssize_t bytes_readed = 0;
-			size_t total_bytes = 0;
-
-			buf = faux_malloc(BIN_BYTES_PER_LINE);
-			assert(buf);
-			if (!buf) {
-				fprintf(stderr, "Error: Memory problems\n");
-				break;
-			}
+			const char *data = faux_file_map_data(map);
+			size_t len = faux_file_map_len(map);
+			size_t offset = 0;
 
-			do {
+			for (offset = 0; offset < len;
+				offset += BIN_BYTES_PER_LINE) {
 				char *escaped_str = NULL;
+				size_t chunk = len - offset;
 
-				bytes_readed = faux_file_read_block(f, buf,
-					BIN_BYTES_PER_LINE);
-				if (bytes_readed < 0) {
-					fprintf(stderr, "Error: Can't open "
-						"file \"%s\"\n", fn);
-					total_errors++;
-					break;
-				}
-				if (0 == bytes_readed) // EOF
-					break;
-				total_bytes += bytes_readed;
-				escaped_str = faux_str_c_bin(buf, bytes_readed);
+				if (chunk > BIN_BYTES_PER_LINE)
+					chunk = BIN_BYTES_PER_LINE;
+				escaped_str = faux_str_c_bin(data + offset, chunk);
 				if (escaped_str)
 					printf("\t\"%s\"\n", escaped_str);
 				faux_str_free(escaped_str);
-			} while (BIN_BYTES_PER_LINE == bytes_readed);
+			}
 
-			faux_free(buf);
-			if (0 == total_bytes) // Empty file
+			faux_file_unmap(map);
+			if (0 == len) // Empty file
 				printf("\t\"\"\n");
 
 		// Text mode
@@ -157,10 +158,10 @@ int main(int argc, char *argv[])
 
 			if (0 == line_num) // Empty file is not error
 					printf("\t\"\"\n");
+			faux_file_close(f);
 		}
 
 		printf(";\n");
-		faux_file_close(f);
 	}
 
 	opts_free(opts);